@@ -0,0 +1,6 @@
+#pragma once
+
+#define NAMESPACE_NAME Syrinx
+#define NAMESPACE_NAME_UPPER SYRINX
+
+#define LUMIERE_FLOAT_AS_DOUBLE
@@ -15,7 +15,6 @@
 
 //#define LUMIERE_ENABLE_CUDA 1
 #define LUMIERE_ENABLE_DEBUG 1
-#define LUMIERE_FLOAT_AS_DOUBLE 1
 
 #ifdef LUMIERE_ENABLE_CUDA
 #define LUMIERE_IS_DEVICE_CODE
@@ -45,5 +44,8 @@ using FloatBits = uint32_t;
 #endif
 static_assert(sizeof(Float) == sizeof(FloatBits), "Float and FloatBits must have the same size");
 
+// running sums over many terms stay in double precision whatever Float is
+using AccumulationFloat = double;
+
 
 #define LUMIERE_FORMAT(fmtStr, ...) fmt::format(fmtStr, __VA_ARGS__)
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include "Common/LumiereMacro.h"
+
+#if !defined(LUMIERE_IS_DEVICE_CODE)
+
+#if defined(__AVX2__)
+    #define LUMIERE_ENABLE_AVX2 1
+#endif
+
+#if defined(__AVX__)
+    #define LUMIERE_ENABLE_AVX 1
+#endif
+
+#if defined(__FMA__)
+    #define LUMIERE_ENABLE_FMA 1
+#endif
+
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define LUMIERE_ENABLE_F16C 1
+#endif
+
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define LUMIERE_ENABLE_BMI2 1
+#endif
+
+#if defined(__SSE4_1__) || defined(LUMIERE_ENABLE_AVX)
+    #define LUMIERE_ENABLE_SSE4 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define LUMIERE_ENABLE_SSE 1
+#endif
+
+#endif
+
+
+#if defined(LUMIERE_ENABLE_SSE)
+#include <immintrin.h>
+#endif
+
+#define LUMIERE_SIMD_ALIGNMENT 32
@@ -0,0 +1,696 @@
+#include "LumiereBlockCompression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "LumiereMipMap.h"
+#include "Common/LumiereAssert.h"
+#include "Common/LumiereSIMD.h"
+#include "Math/LumiereSIMDFloat.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr int BlockPixelCount = 16;
+constexpr int MaxPaletteSize = 16;
+constexpr size_t BlockRowGrainSize = 4;
+constexpr int RefinementIterationCount = 2;
+constexpr int BC7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BlockPixels {
+    float channel[4][BlockPixelCount];
+};
+
+
+struct alignas(LUMIERE_SIMD_ALIGNMENT) Palette {
+    float channel[4][MaxPaletteSize] = {};
+    int size = 0;
+};
+
+
+BlockPixels LoadBlockPixels(const uint8_t *rgbaBlock)
+{
+    BlockPixels pixels;
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        for (int channel = 0; channel < 4; ++ channel) {
+            pixels.channel[channel][i] = rgbaBlock[i * 4 + channel];
+        }
+    }
+    return pixels;
+}
+
+
+// picks the nearest palette entry for every pixel; the distances to all entries of a pixel are
+// evaluated Width entries at a time. returns the summed squared error of the block
+float SelectIndices(const BlockPixels& pixels, int firstChannel, int channelCount, const Palette& palette, uint8_t *indexList)
+{
+    using SIMDFloatType = SIMDFloat<float>;
+    constexpr int Width = SIMDFloatType::Width;
+    const int groupCount = (palette.size + Width - 1) / Width;
+    AccumulationFloat totalError = 0.0;
+
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        alignas(LUMIERE_SIMD_ALIGNMENT) float distanceList[MaxPaletteSize];
+        for (int group = 0; group < groupCount; ++ group) {
+            SIMDFloatType distance(0.0f);
+            for (int channel = firstChannel; channel < firstChannel + channelCount; ++ channel) {
+                const SIMDFloatType delta = SIMDFloatType::Load(palette.channel[channel] + group * Width) - SIMDFloatType(pixels.channel[channel][i]);
+                distance = FMA(delta, delta, distance);
+            }
+            distance.store(distanceList + group * Width);
+        }
+
+        int bestIndex = 0;
+        for (int j = 1; j < palette.size; ++ j) {
+            if (distanceList[j] < distanceList[bestIndex]) {
+                bestIndex = j;
+            }
+        }
+        indexList[i] = static_cast<uint8_t>(bestIndex);
+        totalError += distanceList[bestIndex];
+    }
+    return static_cast<float>(totalError);
+}
+
+
+// principal axis of the block through power iteration on its covariance, returns the two
+// extreme points of the block along that axis
+void ComputeAxisEndpoints(const BlockPixels& pixels, int channelCount, float *endpoint0, float *endpoint1)
+{
+    float mean[4] = {};
+    for (int channel = 0; channel < channelCount; ++ channel) {
+        AccumulationFloat sum = 0.0;
+        for (int i = 0; i < BlockPixelCount; ++ i) {
+            sum += pixels.channel[channel][i];
+        }
+        mean[channel] = static_cast<float>(sum / BlockPixelCount);
+    }
+
+    float covariance[4][4] = {};
+    float axis[4] = {};
+    for (int row = 0; row < channelCount; ++ row) {
+        for (int column = 0; column < channelCount; ++ column) {
+            AccumulationFloat sum = 0.0;
+            for (int i = 0; i < BlockPixelCount; ++ i) {
+                sum += static_cast<AccumulationFloat>(pixels.channel[row][i] - mean[row]) * (pixels.channel[column][i] - mean[column]);
+            }
+            covariance[row][column] = static_cast<float>(sum);
+        }
+    }
+    for (int channel = 0; channel < channelCount; ++ channel) {
+        const auto extremes = std::minmax_element(pixels.channel[channel], pixels.channel[channel] + BlockPixelCount);
+        axis[channel] = *extremes.second - *extremes.first;
+    }
+    for (int iteration = 0; iteration < 8; ++ iteration) {
+        float next[4] = {};
+        float length = 0.0f;
+        for (int row = 0; row < channelCount; ++ row) {
+            for (int column = 0; column < channelCount; ++ column) {
+                next[row] += covariance[row][column] * axis[column];
+            }
+            length = std::max(length, std::abs(next[row]));
+        }
+        if (length <= 0.0f) {
+            break;
+        }
+        for (int channel = 0; channel < channelCount; ++ channel) {
+            axis[channel] = next[channel] / length;
+        }
+    }
+
+    float axisLengthSquared = 0.0f;
+    for (int channel = 0; channel < channelCount; ++ channel) {
+        axisLengthSquared += axis[channel] * axis[channel];
+    }
+    float minProjection = 0.0f, maxProjection = 0.0f;
+    if (axisLengthSquared > 0.0f) {
+        minProjection = maxProjection = 0.0f;
+        for (int i = 0; i < BlockPixelCount; ++ i) {
+            float projection = 0.0f;
+            for (int channel = 0; channel < channelCount; ++ channel) {
+                projection += (pixels.channel[channel][i] - mean[channel]) * axis[channel];
+            }
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+        minProjection /= axisLengthSquared;
+        maxProjection /= axisLengthSquared;
+    }
+    for (int channel = 0; channel < channelCount; ++ channel) {
+        endpoint0[channel] = std::clamp(mean[channel] + minProjection * axis[channel], 0.0f, 255.0f);
+        endpoint1[channel] = std::clamp(mean[channel] + maxProjection * axis[channel], 0.0f, 255.0f);
+    }
+}
+
+
+// least squares endpoints for fixed indices, weightList[index] is the weight of endpoint1
+bool RefineEndpoints(const BlockPixels& pixels, int channelCount, const uint8_t *indexList, const float *weightList,
+                     float *endpoint0, float *endpoint1)
+{
+    // the determinant cancels heavily when most pixels share one index, so the sums stay wide
+    AccumulationFloat alphaAlpha = 0.0, alphaBeta = 0.0, betaBeta = 0.0;
+    AccumulationFloat alphaX[4] = {}, betaX[4] = {};
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        const AccumulationFloat beta = weightList[indexList[i]];
+        const AccumulationFloat alpha = 1.0 - beta;
+        alphaAlpha += alpha * alpha;
+        alphaBeta += alpha * beta;
+        betaBeta += beta * beta;
+        for (int channel = 0; channel < channelCount; ++ channel) {
+            alphaX[channel] += alpha * pixels.channel[channel][i];
+            betaX[channel] += beta * pixels.channel[channel][i];
+        }
+    }
+
+    const AccumulationFloat determinant = alphaAlpha * betaBeta - alphaBeta * alphaBeta;
+    if (std::abs(determinant) < 1e-6) {
+        return false;
+    }
+    const AccumulationFloat inverseDeterminant = 1.0 / determinant;
+    for (int channel = 0; channel < channelCount; ++ channel) {
+        endpoint0[channel] = static_cast<float>(std::clamp((alphaX[channel] * betaBeta - betaX[channel] * alphaBeta) * inverseDeterminant, 0.0, 255.0));
+        endpoint1[channel] = static_cast<float>(std::clamp((betaX[channel] * alphaAlpha - alphaX[channel] * alphaBeta) * inverseDeterminant, 0.0, 255.0));
+    }
+    return true;
+}
+
+
+uint16_t PackRGB565(const float *color)
+{
+    const auto red = static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f));
+    const auto green = static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f));
+    const auto blue = static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>((red << 11) | (green << 5) | blue);
+}
+
+
+void UnpackRGB565(uint16_t value, int *color)
+{
+    const int red = (value >> 11) & 0x1f;
+    const int green = (value >> 5) & 0x3f;
+    const int blue = value & 0x1f;
+    color[0] = (red << 3) | (red >> 2);
+    color[1] = (green << 2) | (green >> 4);
+    color[2] = (blue << 3) | (blue >> 2);
+}
+
+
+// four color mode: index 2 and 3 lie at one and two thirds from color0 towards color1
+void BuildBC1Palette(uint16_t color0, uint16_t color1, int colorList[4][3])
+{
+    UnpackRGB565(color0, colorList[0]);
+    UnpackRGB565(color1, colorList[1]);
+    for (int channel = 0; channel < 3; ++ channel) {
+        colorList[2][channel] = (2 * colorList[0][channel] + colorList[1][channel] + 1) / 3;
+        colorList[3][channel] = (colorList[0][channel] + 2 * colorList[1][channel] + 1) / 3;
+    }
+}
+
+
+struct BC1Candidate {
+    uint16_t color0 = 0;
+    uint16_t color1 = 0;
+    uint8_t indexList[BlockPixelCount] = {};
+    float error = 0.0f;
+};
+
+
+BC1Candidate EvaluateBC1(const BlockPixels& pixels, const float *endpoint0, const float *endpoint1)
+{
+    BC1Candidate candidate;
+    candidate.color0 = PackRGB565(endpoint0);
+    candidate.color1 = PackRGB565(endpoint1);
+    if (candidate.color0 < candidate.color1) {
+        std::swap(candidate.color0, candidate.color1);
+    }
+
+    int colorList[4][3];
+    BuildBC1Palette(candidate.color0, candidate.color1, colorList);
+    Palette palette;
+    // equal endpoints would switch the block to three color mode, index 0 is exact there too
+    palette.size = candidate.color0 == candidate.color1 ? 1 : 4;
+    for (int j = 0; j < palette.size; ++ j) {
+        for (int channel = 0; channel < 3; ++ channel) {
+            palette.channel[channel][j] = static_cast<float>(colorList[j][channel]);
+        }
+    }
+    candidate.error = SelectIndices(pixels, 0, 3, palette, candidate.indexList);
+    return candidate;
+}
+
+
+void EncodeBC1Color(const BlockPixels& pixels, BlockCompressionQuality quality, uint8_t *block)
+{
+    static constexpr float IndexWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    float endpoint0[4], endpoint1[4];
+    ComputeAxisEndpoints(pixels, 3, endpoint0, endpoint1);
+    BC1Candidate best = EvaluateBC1(pixels, endpoint0, endpoint1);
+
+    if (quality == BlockCompressionQuality::Quality) {
+        BC1Candidate current = best;
+        for (int iteration = 0; iteration < RefinementIterationCount && current.color0 != current.color1; ++ iteration) {
+            if (!RefineEndpoints(pixels, 3, current.indexList, IndexWeights, endpoint0, endpoint1)) {
+                break;
+            }
+            current = EvaluateBC1(pixels, endpoint0, endpoint1);
+            if (current.error < best.error) {
+                best = current;
+            }
+        }
+    }
+
+    uint32_t indexBits = 0;
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        indexBits |= static_cast<uint32_t>(best.indexList[i]) << (2 * i);
+    }
+    std::memcpy(block, &best.color0, 2);
+    std::memcpy(block + 2, &best.color1, 2);
+    std::memcpy(block + 4, &indexBits, 4);
+}
+
+
+// endpoint0 > endpoint1 selects eight interpolated values, otherwise six plus 0 and 255
+void BuildBC4Palette(int endpoint0, int endpoint1, int *valueList)
+{
+    valueList[0] = endpoint0;
+    valueList[1] = endpoint1;
+    if (endpoint0 > endpoint1) {
+        for (int i = 1; i < 7; ++ i) {
+            valueList[i + 1] = ((7 - i) * endpoint0 + i * endpoint1 + 3) / 7;
+        }
+    } else {
+        for (int i = 1; i < 5; ++ i) {
+            valueList[i + 1] = ((5 - i) * endpoint0 + i * endpoint1 + 2) / 5;
+        }
+        valueList[6] = 0;
+        valueList[7] = 255;
+    }
+}
+
+
+float EvaluateBC4(const BlockPixels& pixels, int channel, int endpoint0, int endpoint1, uint8_t *indexList)
+{
+    int valueList[8];
+    BuildBC4Palette(endpoint0, endpoint1, valueList);
+    Palette palette;
+    palette.size = 8;
+    for (int j = 0; j < palette.size; ++ j) {
+        palette.channel[channel][j] = static_cast<float>(valueList[j]);
+    }
+    return SelectIndices(pixels, channel, 1, palette, indexList);
+}
+
+
+void EncodeBC4(const BlockPixels& pixels, int channel, BlockCompressionQuality quality, uint8_t *block)
+{
+    const auto extremes = std::minmax_element(pixels.channel[channel], pixels.channel[channel] + BlockPixelCount);
+    const int minValue = static_cast<int>(*extremes.first);
+    const int maxValue = static_cast<int>(*extremes.second);
+    int bestEndpoint0 = maxValue, bestEndpoint1 = minValue;
+    uint8_t bestIndexList[BlockPixelCount] = {};
+
+    if (minValue == maxValue) {
+        // a flat block, index 0 reproduces it exactly
+    } else if (quality == BlockCompressionQuality::Fast) {
+        EvaluateBC4(pixels, channel, maxValue, minValue, bestIndexList);
+    } else {
+        // insetting the endpoints trades the extremes for finer steps in between; the six value
+        // mode helps blocks that mix 0 or 255 with a narrow range of other values
+        float bestError = EvaluateBC4(pixels, channel, maxValue, minValue, bestIndexList);
+        auto tryEndpoints = [&](int endpoint0, int endpoint1) {
+            uint8_t indexList[BlockPixelCount];
+            const float error = EvaluateBC4(pixels, channel, endpoint0, endpoint1, indexList);
+            if (error < bestError) {
+                bestError = error;
+                bestEndpoint0 = endpoint0;
+                bestEndpoint1 = endpoint1;
+                std::memcpy(bestIndexList, indexList, sizeof(indexList));
+            }
+        };
+        for (int inset0 = 0; inset0 < 3; ++ inset0) {
+            for (int inset1 = 0; inset1 < 3; ++ inset1) {
+                if (maxValue - inset0 > minValue + inset1) {
+                    tryEndpoints(maxValue - inset0, minValue + inset1);
+                }
+            }
+        }
+
+        int innerMin = 255, innerMax = 0;
+        for (int i = 0; i < BlockPixelCount; ++ i) {
+            const int value = static_cast<int>(pixels.channel[channel][i]);
+            if (value != 0 && value != 255) {
+                innerMin = std::min(innerMin, value);
+                innerMax = std::max(innerMax, value);
+            }
+        }
+        if (innerMin <= innerMax && (minValue == 0 || maxValue == 255)) {
+            tryEndpoints(innerMin, innerMax);
+        }
+    }
+
+    uint64_t indexBits = 0;
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        indexBits |= static_cast<uint64_t>(bestIndexList[i]) << (3 * i);
+    }
+    block[0] = static_cast<uint8_t>(bestEndpoint0);
+    block[1] = static_cast<uint8_t>(bestEndpoint1);
+    for (int i = 0; i < 6; ++ i) {
+        block[2 + i] = static_cast<uint8_t>(indexBits >> (8 * i));
+    }
+}
+
+
+struct BC7Candidate {
+    uint8_t endpoint[2][4] = {};
+    uint8_t pBit[2] = {};
+    uint8_t indexList[BlockPixelCount] = {};
+    float error = 0.0f;
+};
+
+
+// mode 6 endpoints are 7 bits per channel plus one p-bit shared by the channels of an endpoint
+void QuantizeBC7Endpoint(const float *endpoint, int pBit, uint8_t *quantized)
+{
+    for (int channel = 0; channel < 4; ++ channel) {
+        quantized[channel] = static_cast<uint8_t>(std::clamp<long>(std::lround((endpoint[channel] - pBit) * 0.5f), 0, 127));
+    }
+}
+
+
+float GetBC7EndpointError(const float *endpoint, int pBit)
+{
+    uint8_t quantized[4];
+    QuantizeBC7Endpoint(endpoint, pBit, quantized);
+    float error = 0.0f;
+    for (int channel = 0; channel < 4; ++ channel) {
+        const float delta = static_cast<float>((quantized[channel] << 1) | pBit) - endpoint[channel];
+        error += delta * delta;
+    }
+    return error;
+}
+
+
+void BuildBC7Palette(const uint8_t endpoint[2][4], const uint8_t *pBit, Palette& palette)
+{
+    palette.size = 16;
+    for (int channel = 0; channel < 4; ++ channel) {
+        const int value0 = (endpoint[0][channel] << 1) | pBit[0];
+        const int value1 = (endpoint[1][channel] << 1) | pBit[1];
+        for (int j = 0; j < 16; ++ j) {
+            palette.channel[channel][j] = static_cast<float>(((64 - BC7Weights[j]) * value0 + BC7Weights[j] * value1 + 32) >> 6);
+        }
+    }
+}
+
+
+BC7Candidate EvaluateBC7(const BlockPixels& pixels, const float *endpoint0, const float *endpoint1, int pBit0, int pBit1)
+{
+    BC7Candidate candidate;
+    candidate.pBit[0] = static_cast<uint8_t>(pBit0);
+    candidate.pBit[1] = static_cast<uint8_t>(pBit1);
+    QuantizeBC7Endpoint(endpoint0, pBit0, candidate.endpoint[0]);
+    QuantizeBC7Endpoint(endpoint1, pBit1, candidate.endpoint[1]);
+    Palette palette;
+    BuildBC7Palette(candidate.endpoint, candidate.pBit, palette);
+    candidate.error = SelectIndices(pixels, 0, 4, palette, candidate.indexList);
+    return candidate;
+}
+
+
+BC7Candidate EvaluateBC7(const BlockPixels& pixels, const float *endpoint0, const float *endpoint1, BlockCompressionQuality quality)
+{
+    if (quality == BlockCompressionQuality::Fast) {
+        const int pBit0 = GetBC7EndpointError(endpoint0, 1) < GetBC7EndpointError(endpoint0, 0) ? 1 : 0;
+        const int pBit1 = GetBC7EndpointError(endpoint1, 1) < GetBC7EndpointError(endpoint1, 0) ? 1 : 0;
+        return EvaluateBC7(pixels, endpoint0, endpoint1, pBit0, pBit1);
+    }
+
+    BC7Candidate best = EvaluateBC7(pixels, endpoint0, endpoint1, 0, 0);
+    for (int combination = 1; combination < 4; ++ combination) {
+        BC7Candidate candidate = EvaluateBC7(pixels, endpoint0, endpoint1, combination & 1, combination >> 1);
+        if (candidate.error < best.error) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t *data) : mData(data), mPosition(0) { std::memset(mData, 0, 16); }
+
+    void write(uint32_t value, int bitCount)
+    {
+        for (int i = 0; i < bitCount; ++ i, ++ mPosition) {
+            mData[mPosition >> 3] |= static_cast<uint8_t>(((value >> i) & 1u) << (mPosition & 7));
+        }
+    }
+
+private:
+    uint8_t *mData;
+    int mPosition;
+};
+
+
+class BitReader {
+public:
+    explicit BitReader(const uint8_t *data) : mData(data), mPosition(0) {}
+
+    uint32_t read(int bitCount)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < bitCount; ++ i, ++ mPosition) {
+            value |= static_cast<uint32_t>((mData[mPosition >> 3] >> (mPosition & 7)) & 1u) << i;
+        }
+        return value;
+    }
+
+private:
+    const uint8_t *mData;
+    int mPosition;
+};
+
+
+void EncodeBC7(const BlockPixels& pixels, BlockCompressionQuality quality, uint8_t *block)
+{
+    float endpoint0[4], endpoint1[4];
+    ComputeAxisEndpoints(pixels, 4, endpoint0, endpoint1);
+    BC7Candidate best = EvaluateBC7(pixels, endpoint0, endpoint1, quality);
+
+    if (quality == BlockCompressionQuality::Quality) {
+        float weightList[16];
+        for (int j = 0; j < 16; ++ j) {
+            weightList[j] = BC7Weights[j] / 64.0f;
+        }
+        BC7Candidate current = best;
+        for (int iteration = 0; iteration < RefinementIterationCount; ++ iteration) {
+            if (!RefineEndpoints(pixels, 4, current.indexList, weightList, endpoint0, endpoint1)) {
+                break;
+            }
+            current = EvaluateBC7(pixels, endpoint0, endpoint1, quality);
+            if (current.error < best.error) {
+                best = current;
+            }
+        }
+    }
+
+    // the most significant index bit of pixel 0 is implied to be zero
+    if (best.indexList[0] >= 8) {
+        std::swap(best.endpoint[0], best.endpoint[1]);
+        std::swap(best.pBit[0], best.pBit[1]);
+        for (auto& index : best.indexList) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    BitWriter writer(block);
+    writer.write(1u << 6, 7);
+    for (int channel = 0; channel < 4; ++ channel) {
+        writer.write(best.endpoint[0][channel], 7);
+        writer.write(best.endpoint[1][channel], 7);
+    }
+    writer.write(best.pBit[0], 1);
+    writer.write(best.pBit[1], 1);
+    writer.write(best.indexList[0], 3);
+    for (int i = 1; i < BlockPixelCount; ++ i) {
+        writer.write(best.indexList[i], 4);
+    }
+}
+
+
+// BC1 blocks with color0 <= color1 use three color mode: index 2 is the midpoint and index 3 is
+// transparent black. the color half of a BC3 block always decodes in four color mode
+void DecodeBC1Color(const uint8_t *block, bool hasThreeColorMode, uint8_t *rgbaBlock)
+{
+    uint16_t color0 = 0, color1 = 0;
+    uint32_t indexBits = 0;
+    std::memcpy(&color0, block, 2);
+    std::memcpy(&color1, block + 2, 2);
+    std::memcpy(&indexBits, block + 4, 4);
+    int colorList[4][3];
+    BuildBC1Palette(color0, color1, colorList);
+    const bool isThreeColorMode = hasThreeColorMode && color0 <= color1;
+    if (isThreeColorMode) {
+        for (int channel = 0; channel < 3; ++ channel) {
+            colorList[2][channel] = (colorList[0][channel] + colorList[1][channel] + 1) / 2;
+            colorList[3][channel] = 0;
+        }
+    }
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        const uint32_t index = (indexBits >> (2 * i)) & 3u;
+        for (int channel = 0; channel < 3; ++ channel) {
+            rgbaBlock[i * 4 + channel] = static_cast<uint8_t>(colorList[index][channel]);
+        }
+        if (isThreeColorMode && index == 3) {
+            rgbaBlock[i * 4 + 3] = 0;
+        }
+    }
+}
+
+
+void DecodeBC4(const uint8_t *block, int channel, uint8_t *rgbaBlock)
+{
+    int valueList[8];
+    BuildBC4Palette(block[0], block[1], valueList);
+    uint64_t indexBits = 0;
+    for (int i = 0; i < 6; ++ i) {
+        indexBits |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+    }
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        rgbaBlock[i * 4 + channel] = static_cast<uint8_t>(valueList[(indexBits >> (3 * i)) & 7u]);
+    }
+}
+
+
+void DecodeBC7(const uint8_t *block, uint8_t *rgbaBlock)
+{
+    BitReader reader(block);
+    if (reader.read(7) != (1u << 6)) {
+        LUMIERE_ASSERT(false && "only BC7 mode 6 blocks can be decoded");
+        std::memset(rgbaBlock, 0, BlockPixelCount * 4);
+        return;
+    }
+
+    uint8_t endpoint[2][4];
+    for (int channel = 0; channel < 4; ++ channel) {
+        endpoint[0][channel] = static_cast<uint8_t>(reader.read(7));
+        endpoint[1][channel] = static_cast<uint8_t>(reader.read(7));
+    }
+    uint8_t pBit[2];
+    pBit[0] = static_cast<uint8_t>(reader.read(1));
+    pBit[1] = static_cast<uint8_t>(reader.read(1));
+    Palette palette;
+    BuildBC7Palette(endpoint, pBit, palette);
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        const uint32_t index = reader.read(i == 0 ? 3 : 4);
+        for (int channel = 0; channel < 4; ++ channel) {
+            rgbaBlock[i * 4 + channel] = static_cast<uint8_t>(palette.channel[channel][index]);
+        }
+    }
+}
+
+} // namespace
+
+
+size_t GetCompressedBlockSize(BlockCompressionFormat format)
+{
+    return format._value == BlockCompressionFormat::BC1 ? 8 : 16;
+}
+
+
+size_t GetCompressedImageSize(BlockCompressionFormat format, uint32_t width, uint32_t height)
+{
+    const size_t blockCountX = (width + 3) / 4;
+    const size_t blockCountY = (height + 3) / 4;
+    return blockCountX * blockCountY * GetCompressedBlockSize(format);
+}
+
+
+void CompressBlock(const uint8_t *rgbaBlock, BlockCompressionFormat format, BlockCompressionQuality quality, uint8_t *block)
+{
+    LUMIERE_EXPECT(rgbaBlock && block);
+    const BlockPixels pixels = LoadBlockPixels(rgbaBlock);
+    switch (format) {
+        case BlockCompressionFormat::BC1: EncodeBC1Color(pixels, quality, block); break;
+        case BlockCompressionFormat::BC3: EncodeBC4(pixels, 3, quality, block); EncodeBC1Color(pixels, quality, block + 8); break;
+        case BlockCompressionFormat::BC5: EncodeBC4(pixels, 0, quality, block); EncodeBC4(pixels, 1, quality, block + 8); break;
+        case BlockCompressionFormat::BC7: EncodeBC7(pixels, quality, block); break;
+        default: LUMIERE_ASSERT(false && "undefined block compression format");
+    }
+}
+
+
+void DecompressBlock(const uint8_t *block, BlockCompressionFormat format, uint8_t *rgbaBlock)
+{
+    LUMIERE_EXPECT(block && rgbaBlock);
+    // channels a format does not store decode to opaque black, like on the GPU
+    for (int i = 0; i < BlockPixelCount; ++ i) {
+        rgbaBlock[i * 4 + 0] = rgbaBlock[i * 4 + 1] = rgbaBlock[i * 4 + 2] = 0;
+        rgbaBlock[i * 4 + 3] = 255;
+    }
+    switch (format) {
+        case BlockCompressionFormat::BC1: DecodeBC1Color(block, true, rgbaBlock); break;
+        case BlockCompressionFormat::BC3: DecodeBC4(block, 3, rgbaBlock); DecodeBC1Color(block + 8, false, rgbaBlock); break;
+        case BlockCompressionFormat::BC5: DecodeBC4(block, 0, rgbaBlock); DecodeBC4(block + 8, 1, rgbaBlock); break;
+        case BlockCompressionFormat::BC7: DecodeBC7(block, rgbaBlock); break;
+        default: LUMIERE_ASSERT(false && "undefined block compression format");
+    }
+}
+
+
+std::vector<uint8_t> CompressImage(const Image& image, BlockCompressionFormat format, BlockCompressionQuality quality, ThreadPool *threadPool)
+{
+    LUMIERE_EXPECT(image.getData());
+    if (image.getFormat()._value != ImageFormat::RGBA8) {
+        const bool isSRGB = format._value != BlockCompressionFormat::BC5;
+        return CompressImage(image.convert(ImageFormat::RGBA8, isSRGB, threadPool), format, quality, threadPool);
+    }
+
+    const uint32_t width = image.getWidth();
+    const uint32_t height = image.getHeight();
+    const uint32_t blockCountX = (width + 3) / 4;
+    const uint32_t blockCountY = (height + 3) / 4;
+    const size_t blockSize = GetCompressedBlockSize(format);
+    std::vector<uint8_t> data(GetCompressedImageSize(format, width, height));
+
+    // blocks are independent, so rows of blocks are spread over the pool; pixels past the edge
+    // of the image repeat the last row and column
+    ParallelFor(threadPool, blockCountY, BlockRowGrainSize, [&](size_t begin, size_t end) {
+        uint8_t rgbaBlock[BlockPixelCount * 4];
+        for (size_t blockY = begin; blockY < end; ++ blockY) {
+            for (uint32_t blockX = 0; blockX < blockCountX; ++ blockX) {
+                for (uint32_t y = 0; y < 4; ++ y) {
+                    const uint32_t sourceY = std::min(static_cast<uint32_t>(blockY) * 4 + y, height - 1);
+                    for (uint32_t x = 0; x < 4; ++ x) {
+                        const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                        std::memcpy(rgbaBlock + (y * 4 + x) * 4, image.getData() + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+                    }
+                }
+                CompressBlock(rgbaBlock, format, quality, data.data() + (blockY * blockCountX + blockX) * blockSize);
+            }
+        }
+    });
+    return data;
+}
+
+
+CompressedTexture CompressTexture(const Image& image, BlockCompressionFormat format, BlockCompressionQuality quality,
+                                  bool generateMipChain, ThreadPool *threadPool)
+{
+    CompressedTexture texture;
+    texture.format = format;
+    texture.width = image.getWidth();
+    texture.height = image.getHeight();
+    texture.levelList.push_back(CompressImage(image, format, quality, threadPool));
+    if (generateMipChain) {
+        // BC5 usually carries normal or other non-color data, which is filtered linearly
+        const bool isSRGB = format._value != BlockCompressionFormat::BC5;
+        for (const Image& level : GenerateMipChain(image, MipMapFilter::Box, isSRGB, threadPool)) {
+            texture.levelList.push_back(CompressImage(level, format, quality, threadPool));
+        }
+    }
+    return texture;
+}
+
+END_LUMIERE_NAMESPACE
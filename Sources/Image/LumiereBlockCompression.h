@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <better-enums/enum.h>
+#include "LumiereImage.h"
+#include "Thread/LumiereThreadPool.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+BETTER_ENUM(BlockCompressionFormat, uint8_t,
+            BC1,
+            BC3,
+            BC5,
+            BC7);
+
+
+// Fast fits the endpoints of a block along its principal axis; Quality additionally refines them
+// with least squares, searches more endpoint and p-bit candidates and keeps the lowest error
+enum class BlockCompressionQuality { Fast, Quality };
+
+
+struct CompressedTexture {
+    // level 0 first, every level stores its 4x4 blocks row by row
+    BlockCompressionFormat format = BlockCompressionFormat::BC1;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<std::vector<uint8_t>> levelList;
+};
+
+
+size_t GetCompressedBlockSize(BlockCompressionFormat format);
+size_t GetCompressedImageSize(BlockCompressionFormat format, uint32_t width, uint32_t height);
+// rgbaBlock holds 4x4 RGBA8 pixels row by row. BC5 encodes red and green only and BC7 always
+// emits mode 6 blocks, which is also the only BC7 mode DecompressBlock() understands
+void CompressBlock(const uint8_t *rgbaBlock, BlockCompressionFormat format, BlockCompressionQuality quality, uint8_t *block);
+void DecompressBlock(const uint8_t *block, BlockCompressionFormat format, uint8_t *rgbaBlock);
+std::vector<uint8_t> CompressImage(const Image& image, BlockCompressionFormat format, BlockCompressionQuality quality,
+                                   ThreadPool *threadPool = nullptr);
+CompressedTexture CompressTexture(const Image& image, BlockCompressionFormat format, BlockCompressionQuality quality,
+                                  bool generateMipChain, ThreadPool *threadPool = nullptr);
+
+END_LUMIERE_NAMESPACE
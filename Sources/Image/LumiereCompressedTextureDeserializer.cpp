@@ -0,0 +1,91 @@
+#include "LumiereCompressedTextureDeserializer.h"
+#include <algorithm>
+#include "LumiereMipMap.h"
+#include "Common/LumiereAssert.h"
+#include "Exception/LumiereException.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+CompressedTextureDeserializer::CompressedTextureDeserializer()
+    : Deserializer()
+    , mTexture()
+    , mLevelCount(0)
+{
+    LUMIERE_ENSURE(isClean());
+}
+
+
+CompressedTexture CompressedTextureDeserializer::deserialize(DataStream& dataStream)
+{
+    LUMIERE_EXPECT(dataStream.isReadable());
+    mDataStream = &dataStream;
+    try {
+        deserializeFileHeader();
+        deserializeData();
+    } catch (...) {
+        clear();
+        throw;
+    }
+    CompressedTexture texture = std::move(mTexture);
+    clear();
+    LUMIERE_ENSURE(isClean());
+    return texture;
+}
+
+
+void CompressedTextureDeserializer::readCustomHeader()
+{
+    const uint8_t format = readUInt8();
+    if (!BlockCompressionFormat::_is_valid(format)) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::DeserializationError, "invalid block compression format [{}] in file [{}]", format, mDataStream->getName());
+    }
+    mTexture.format = BlockCompressionFormat::_from_integral(format);
+    mTexture.width = readUInt32();
+    mTexture.height = readUInt32();
+    mLevelCount = readUInt32();
+    if (mTexture.width == 0 || mTexture.height == 0 || mLevelCount == 0 || mLevelCount > GetMipLevelCount(mTexture.width, mTexture.height)) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::DeserializationError, "invalid compressed texture header in file [{}]", mDataStream->getName());
+    }
+}
+
+
+void CompressedTextureDeserializer::deserializeData()
+{
+    // sizes are checked against the header and the rest of the stream before anything is
+    // allocated, so a corrupt header can not request more memory than the file holds
+    uint32_t width = mTexture.width;
+    uint32_t height = mTexture.height;
+    mTexture.levelList.resize(mLevelCount);
+    for (uint32_t level = 0; level < mLevelCount; ++ level) {
+        const uint64_t byteSize = readUInt64();
+        if (byteSize != GetCompressedImageSize(mTexture.format, width, height)) {
+            LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::DeserializationError, "invalid size of level {} in file [{}]", level, mDataStream->getName());
+        }
+        const size_t remainingSize = mDataStream->getSize() - std::min(mDataStream->getSize(), mDataStream->tell());
+        if (byteSize > remainingSize) {
+            LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::DeserializationError, "level {} needs [{}] bytes but only [{}] remain in file [{}]",
+                                       level, byteSize, remainingSize, mDataStream->getName());
+        }
+        auto& levelData = mTexture.levelList[level];
+        levelData.resize(byteSize);
+        readUInt8s(levelData.data(), levelData.size());
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+}
+
+
+void CompressedTextureDeserializer::clear()
+{
+    mDataStream = nullptr;
+    mTexture = CompressedTexture();
+    mLevelCount = 0;
+}
+
+
+bool CompressedTextureDeserializer::isClean() const
+{
+    return !mDataStream && mTexture.levelList.empty() && mLevelCount == 0;
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,25 @@
+#pragma once
+#include "LumiereBlockCompression.h"
+#include "Serializer/LumiereDeserializer.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+class CompressedTextureDeserializer : public Deserializer {
+public:
+    CompressedTextureDeserializer();
+    ~CompressedTextureDeserializer() override = default;
+
+    CompressedTexture deserialize(DataStream& dataStream) noexcept(false);
+
+private:
+    void readCustomHeader() noexcept(false) override;
+    void deserializeData() noexcept(false) override;
+    void clear() override;
+    bool isClean() const override;
+
+private:
+    CompressedTexture mTexture;
+    uint32_t mLevelCount;
+};
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,61 @@
+#include "LumiereCompressedTextureSerializer.h"
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+CompressedTextureSerializer::CompressedTextureSerializer()
+    : Serializer()
+    , mTexture(nullptr)
+{
+    LUMIERE_ENSURE(isClean());
+}
+
+
+void CompressedTextureSerializer::serialize(DataStream& dataStream, const CompressedTexture& texture)
+{
+    LUMIERE_EXPECT(dataStream.isWriteable());
+    LUMIERE_EXPECT(!texture.levelList.empty());
+    mDataStream = &dataStream;
+    mTexture = &texture;
+    serializeFileHeader();
+    serializeData();
+    clear();
+    LUMIERE_ENSURE(isClean());
+}
+
+
+void CompressedTextureSerializer::writeCustomHeader()
+{
+    LUMIERE_EXPECT(mTexture);
+    writeUInt8(static_cast<uint8_t>(mTexture->format._value));
+    writeUInt32(mTexture->width);
+    writeUInt32(mTexture->height);
+    writeUInt32(static_cast<uint32_t>(mTexture->levelList.size()));
+}
+
+
+void CompressedTextureSerializer::serializeData()
+{
+    LUMIERE_EXPECT(mTexture);
+    for (const auto& level : mTexture->levelList) {
+        writeUInt64(level.size());
+        if (!level.empty()) {
+            writeUInt8s(level.data(), level.size());
+        }
+    }
+}
+
+
+void CompressedTextureSerializer::clear()
+{
+    mDataStream = nullptr;
+    mTexture = nullptr;
+}
+
+
+bool CompressedTextureSerializer::isClean() const
+{
+    return !mDataStream && !mTexture;
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,26 @@
+#pragma once
+#include "LumiereBlockCompression.h"
+#include "Serializer/LumiereSerializer.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// custom header: format, width, height and level count; every level follows as its byte size and
+// the raw blocks, so a level can be uploaded without decoding
+class CompressedTextureSerializer : public Serializer {
+public:
+    CompressedTextureSerializer();
+    ~CompressedTextureSerializer() override = default;
+
+    void serialize(DataStream& dataStream, const CompressedTexture& texture);
+
+private:
+    void writeCustomHeader() override;
+    void serializeData() override;
+    void clear() override;
+    bool isClean() const override;
+
+private:
+    const CompressedTexture *mTexture;
+};
+
+END_LUMIERE_NAMESPACE
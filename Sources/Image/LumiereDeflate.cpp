@@ -0,0 +1,530 @@
+#include "LumiereDeflate.h"
+#include <algorithm>
+#include <array>
+#include <queue>
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr size_t WindowSize = 32768;
+constexpr size_t HashSize = 1 << 15;
+constexpr size_t MinMatchLength = 3;
+constexpr size_t MaxMatchLength = 258;
+constexpr size_t MaxStoredBlockSize = 65535;
+constexpr size_t MaxBlockTokenCount = 1 << 14;
+constexpr int LiteralLengthCodeCount = 286;
+constexpr int DistanceCodeCount = 30;
+constexpr int CodeLengthCodeCount = 19;
+constexpr int EndOfBlock = 256;
+constexpr uint32_t AdlerBase = 65521;
+constexpr size_t AdlerBlockSize = 5552;
+
+constexpr uint16_t LengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
+                                     67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t LengthExtraBits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t DistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                       1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t DistanceExtraBits[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr uint8_t CodeLengthOrder[CodeLengthCodeCount] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// match chain depth and the length at which a match is taken without looking further, by level
+constexpr uint16_t MaxChainLength[10] = {0, 4, 8, 16, 32, 64, 128, 256, 1024, 4096};
+constexpr uint16_t NiceMatchLength[10] = {0, 8, 16, 32, 16, 32, 128, 128, 258, 258};
+constexpr int MinLazyLevel = 4;
+
+// a literal when distance is zero, otherwise a match of the given length
+struct Token {
+    uint16_t literalOrLength;
+    uint16_t distance;
+};
+
+
+struct Match {
+    size_t length = 0;
+    size_t distance = 0;
+};
+
+
+struct HuffmanCode {
+    std::vector<uint8_t> lengthList;
+    std::vector<uint16_t> codeList;
+};
+
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& output) : mOutput(output), mBitBuffer(0), mBitCount(0) {}
+
+    // deflate packs values starting at the least significant bit
+    void write(uint32_t value, int bitCount)
+    {
+        mBitBuffer |= static_cast<uint64_t>(value) << mBitCount;
+        mBitCount += bitCount;
+        while (mBitCount >= 8) {
+            mOutput.push_back(static_cast<uint8_t>(mBitBuffer));
+            mBitBuffer >>= 8;
+            mBitCount -= 8;
+        }
+    }
+
+    void alignToByte()
+    {
+        if (mBitCount > 0) {
+            write(0, 8 - mBitCount);
+        }
+    }
+
+private:
+    std::vector<uint8_t>& mOutput;
+    uint64_t mBitBuffer;
+    int mBitCount;
+};
+
+
+int GetLengthCode(size_t length)
+{
+    return static_cast<int>(std::upper_bound(std::begin(LengthBase), std::end(LengthBase), length) - std::begin(LengthBase)) - 1;
+}
+
+
+int GetDistanceCode(size_t distance)
+{
+    return static_cast<int>(std::upper_bound(std::begin(DistanceBase), std::end(DistanceBase), distance) - std::begin(DistanceBase)) - 1;
+}
+
+
+uint16_t ReverseBits(uint16_t code, int length)
+{
+    uint16_t reversed = 0;
+    for (int i = 0; i < length; ++ i) {
+        reversed = static_cast<uint16_t>((reversed << 1) | ((code >> i) & 1));
+    }
+    return reversed;
+}
+
+
+// huffman code lengths limited to maxLength. at least two symbols always get a code so that the
+// code is complete; frequencies are halved until the tree is shallow enough
+HuffmanCode BuildHuffmanCode(std::vector<uint32_t> frequencyList, int maxLength)
+{
+    const int symbolCount = static_cast<int>(frequencyList.size());
+    auto usedCount = std::count_if(frequencyList.begin(), frequencyList.end(), [](uint32_t frequency) { return frequency > 0; });
+    for (int i = 0; i < symbolCount && usedCount < 2; ++ i) {
+        if (frequencyList[i] == 0) {
+            frequencyList[i] = 1;
+            ++ usedCount;
+        }
+    }
+
+    HuffmanCode code;
+    code.lengthList.assign(symbolCount, 0);
+    while (true) {
+        using Node = std::pair<uint32_t, int>;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+        std::vector<int> parentList(symbolCount, -1);
+        for (int i = 0; i < symbolCount; ++ i) {
+            if (frequencyList[i] > 0) {
+                queue.emplace(frequencyList[i], i);
+            }
+        }
+        while (queue.size() > 1) {
+            const Node first = queue.top();
+            queue.pop();
+            const Node second = queue.top();
+            queue.pop();
+            const int parent = static_cast<int>(parentList.size());
+            parentList.push_back(-1);
+            parentList[first.second] = parent;
+            parentList[second.second] = parent;
+            queue.emplace(first.first + second.first, parent);
+        }
+
+        int longestLength = 0;
+        for (int i = 0; i < symbolCount; ++ i) {
+            int length = 0;
+            for (int node = i; frequencyList[i] > 0 && parentList[node] >= 0; node = parentList[node]) {
+                ++ length;
+            }
+            code.lengthList[i] = static_cast<uint8_t>(length);
+            longestLength = std::max(longestLength, length);
+        }
+        if (longestLength <= maxLength) {
+            break;
+        }
+        for (auto& frequency : frequencyList) {
+            frequency = frequency > 0 ? std::max<uint32_t>(frequency >> 1, 1) : 0;
+        }
+    }
+
+    // canonical codes, stored bit reversed since huffman codes are sent most significant bit first
+    std::vector<uint16_t> lengthCountList(maxLength + 1, 0);
+    for (uint8_t length : code.lengthList) {
+        ++ lengthCountList[length];
+    }
+    lengthCountList[0] = 0;
+    std::vector<uint16_t> nextCodeList(maxLength + 1, 0);
+    for (int length = 1, nextCode = 0; length <= maxLength; ++ length) {
+        nextCode = (nextCode + lengthCountList[length - 1]) << 1;
+        nextCodeList[length] = static_cast<uint16_t>(nextCode);
+    }
+    code.codeList.assign(symbolCount, 0);
+    for (int i = 0; i < symbolCount; ++ i) {
+        const int length = code.lengthList[i];
+        if (length > 0) {
+            code.codeList[i] = ReverseBits(nextCodeList[length]++, length);
+        }
+    }
+    return code;
+}
+
+
+void WriteSymbol(BitWriter& writer, const HuffmanCode& code, int symbol)
+{
+    writer.write(code.codeList[symbol], code.lengthList[symbol]);
+}
+
+
+void WriteDynamicBlock(BitWriter& writer, const std::vector<Token>& tokenList, bool isFinal)
+{
+    std::vector<uint32_t> literalFrequencyList(LiteralLengthCodeCount, 0);
+    std::vector<uint32_t> distanceFrequencyList(DistanceCodeCount, 0);
+    for (const Token& token : tokenList) {
+        if (token.distance == 0) {
+            ++ literalFrequencyList[token.literalOrLength];
+        } else {
+            ++ literalFrequencyList[257 + GetLengthCode(token.literalOrLength)];
+            ++ distanceFrequencyList[GetDistanceCode(token.distance)];
+        }
+    }
+    literalFrequencyList[EndOfBlock] = 1;
+    const HuffmanCode literalCode = BuildHuffmanCode(literalFrequencyList, 15);
+    const HuffmanCode distanceCode = BuildHuffmanCode(distanceFrequencyList, 15);
+
+    int literalCount = LiteralLengthCodeCount;
+    while (literalCount > 257 && literalCode.lengthList[literalCount - 1] == 0) {
+        -- literalCount;
+    }
+    int distanceCount = DistanceCodeCount;
+    while (distanceCount > 1 && distanceCode.lengthList[distanceCount - 1] == 0) {
+        -- distanceCount;
+    }
+
+    // both code length lists are sent as one sequence, run length coded with symbols 16 to 18
+    std::vector<uint8_t> lengthList(literalCode.lengthList.begin(), literalCode.lengthList.begin() + literalCount);
+    lengthList.insert(lengthList.end(), distanceCode.lengthList.begin(), distanceCode.lengthList.begin() + distanceCount);
+    std::vector<std::pair<uint8_t, uint8_t>> runList;
+    std::vector<uint32_t> codeLengthFrequencyList(CodeLengthCodeCount, 0);
+    for (size_t i = 0; i < lengthList.size();) {
+        const uint8_t length = lengthList[i];
+        size_t runLength = 1;
+        while (i + runLength < lengthList.size() && lengthList[i + runLength] == length) {
+            ++ runLength;
+        }
+        if (length == 0 && runLength >= 11) {
+            runLength = std::min<size_t>(runLength, 138);
+            runList.emplace_back(18, static_cast<uint8_t>(runLength - 11));
+        } else if (length == 0 && runLength >= 3) {
+            runList.emplace_back(17, static_cast<uint8_t>(runLength - 3));
+        } else if (length != 0 && runLength >= 4) {
+            runLength = std::min<size_t>(runLength, 7);
+            runList.emplace_back(length, 0);
+            runList.emplace_back(16, static_cast<uint8_t>(runLength - 4));
+        } else {
+            runLength = 1;
+            runList.emplace_back(length, 0);
+        }
+        i += runLength;
+    }
+    for (const auto& run : runList) {
+        ++ codeLengthFrequencyList[run.first];
+    }
+    const HuffmanCode codeLengthCode = BuildHuffmanCode(codeLengthFrequencyList, 7);
+    int codeLengthCount = CodeLengthCodeCount;
+    while (codeLengthCount > 4 && codeLengthCode.lengthList[CodeLengthOrder[codeLengthCount - 1]] == 0) {
+        -- codeLengthCount;
+    }
+
+    writer.write(isFinal ? 1 : 0, 1);
+    writer.write(2, 2);
+    writer.write(literalCount - 257, 5);
+    writer.write(distanceCount - 1, 5);
+    writer.write(codeLengthCount - 4, 4);
+    for (int i = 0; i < codeLengthCount; ++ i) {
+        writer.write(codeLengthCode.lengthList[CodeLengthOrder[i]], 3);
+    }
+    for (const auto& run : runList) {
+        WriteSymbol(writer, codeLengthCode, run.first);
+        if (run.first == 16) {
+            writer.write(run.second, 2);
+        } else if (run.first == 17) {
+            writer.write(run.second, 3);
+        } else if (run.first == 18) {
+            writer.write(run.second, 7);
+        }
+    }
+
+    for (const Token& token : tokenList) {
+        if (token.distance == 0) {
+            WriteSymbol(writer, literalCode, token.literalOrLength);
+            continue;
+        }
+        const int lengthCode = GetLengthCode(token.literalOrLength);
+        WriteSymbol(writer, literalCode, 257 + lengthCode);
+        writer.write(token.literalOrLength - LengthBase[lengthCode], LengthExtraBits[lengthCode]);
+        const int distanceCodeIndex = GetDistanceCode(token.distance);
+        WriteSymbol(writer, distanceCode, distanceCodeIndex);
+        writer.write(token.distance - DistanceBase[distanceCodeIndex], DistanceExtraBits[distanceCodeIndex]);
+    }
+    WriteSymbol(writer, literalCode, EndOfBlock);
+}
+
+
+void WriteStoredBlocks(const uint8_t *data, size_t size, bool isFinal, std::vector<uint8_t>& output)
+{
+    BitWriter writer(output);
+    size_t offset = 0;
+    do {
+        const size_t blockSize = std::min(size - offset, MaxStoredBlockSize);
+        const bool isLastBlock = offset + blockSize == size;
+        writer.write(isFinal && isLastBlock ? 1 : 0, 1);
+        writer.write(0, 2);
+        writer.alignToByte();
+        writer.write(static_cast<uint32_t>(blockSize), 16);
+        writer.write(static_cast<uint32_t>(~blockSize & 0xffff), 16);
+        output.insert(output.end(), data + offset, data + offset + blockSize);
+        offset += blockSize;
+    } while (offset < size);
+}
+
+
+// LZ77 over the dictionary and the data with hash chains, positions count from the start of the
+// dictionary. level 4 and up defer a match by one byte when the next byte starts a longer one
+class MatchFinder {
+public:
+    MatchFinder(const uint8_t *window, size_t windowSize, int level)
+        : mWindow(window)
+        , mWindowSize(windowSize)
+        , mMaxChainLength(MaxChainLength[level])
+        , mNiceLength(NiceMatchLength[level])
+        , mHeadList(HashSize, 0)
+        , mPreviousList(WindowSize, 0)
+    {
+        LUMIERE_ENSURE(mMaxChainLength > 0);
+    }
+
+    void insert(size_t position)
+    {
+        if (position + MinMatchLength > mWindowSize) {
+            return;
+        }
+        const size_t hash = getHash(position);
+        mPreviousList[position & (WindowSize - 1)] = mHeadList[hash];
+        mHeadList[hash] = static_cast<uint32_t>(position + 1);
+    }
+
+    Match find(size_t position) const
+    {
+        Match best;
+        if (position + MinMatchLength > mWindowSize) {
+            return best;
+        }
+        const size_t maxLength = std::min(MaxMatchLength, mWindowSize - position);
+        uint32_t candidate = mHeadList[getHash(position)];
+        for (size_t chainLength = 0; candidate > 0 && chainLength < mMaxChainLength; ++ chainLength) {
+            const size_t candidatePosition = candidate - 1;
+            const size_t distance = position - candidatePosition;
+            if (distance > WindowSize) {
+                break;
+            }
+            if (mWindow[candidatePosition + best.length] == mWindow[position + best.length]) {
+                size_t length = 0;
+                while (length < maxLength && mWindow[candidatePosition + length] == mWindow[position + length]) {
+                    ++ length;
+                }
+                if (length > best.length) {
+                    best.length = length;
+                    best.distance = distance;
+                    if (length >= mNiceLength || length == maxLength) {
+                        break;
+                    }
+                }
+            }
+            candidate = mPreviousList[candidatePosition & (WindowSize - 1)];
+        }
+        if (best.length < MinMatchLength) {
+            best = Match();
+        }
+        return best;
+    }
+
+private:
+    size_t getHash(size_t position) const
+    {
+        return ((mWindow[position] << 10) ^ (mWindow[position + 1] << 5) ^ mWindow[position + 2]) & (HashSize - 1);
+    }
+
+private:
+    const uint8_t *mWindow;
+    size_t mWindowSize;
+    size_t mMaxChainLength;
+    size_t mNiceLength;
+    std::vector<uint32_t> mHeadList;
+    std::vector<uint32_t> mPreviousList;
+};
+
+
+std::array<uint32_t, 256> BuildCRC32Table()
+{
+    std::array<uint32_t, 256> table = {};
+    for (uint32_t i = 0; i < 256; ++ i) {
+        uint32_t value = i;
+        for (int bit = 0; bit < 8; ++ bit) {
+            value = (value & 1) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+        }
+        table[i] = value;
+    }
+    return table;
+}
+
+} // namespace
+
+
+void DeflateRange(const uint8_t *data, size_t dictionarySize, size_t size, int level, bool isFinal, std::vector<uint8_t>& output)
+{
+    LUMIERE_EXPECT(data || size == 0);
+    LUMIERE_EXPECT(level >= 0 && level <= 9);
+    if (level == 0) {
+        WriteStoredBlocks(data, size, isFinal, output);
+        return;
+    }
+
+    // only the last window of the dictionary can be referenced
+    const size_t usedDictionarySize = std::min(dictionarySize, WindowSize);
+    const uint8_t *window = data - usedDictionarySize;
+    const size_t windowSize = usedDictionarySize + size;
+    LUMIERE_EXPECT(windowSize < (size_t(1) << 32) - 1);
+    MatchFinder matchFinder(window, windowSize, level);
+    for (size_t position = 0; position < usedDictionarySize; ++ position) {
+        matchFinder.insert(position);
+    }
+
+    BitWriter writer(output);
+    std::vector<Token> tokenList;
+    tokenList.reserve(std::min(size, MaxBlockTokenCount));
+    auto flushBlock = [&](bool isLastBlock) {
+        if (!tokenList.empty()) {
+            WriteDynamicBlock(writer, tokenList, isFinal && isLastBlock);
+            tokenList.clear();
+        }
+    };
+    auto addToken = [&](uint16_t literalOrLength, uint16_t distance) {
+        tokenList.push_back({literalOrLength, distance});
+        if (tokenList.size() == MaxBlockTokenCount) {
+            flushBlock(false);
+        }
+    };
+
+    const bool isLazy = level >= MinLazyLevel;
+    const size_t niceLength = NiceMatchLength[level];
+    bool hasPendingMatch = false;
+    Match pendingMatch;
+    size_t position = usedDictionarySize;
+    while (position < windowSize) {
+        const Match match = matchFinder.find(position);
+        matchFinder.insert(position);
+        if (hasPendingMatch) {
+            if (match.length > pendingMatch.length) {
+                addToken(window[position - 1], 0);
+                pendingMatch = match;
+                ++ position;
+                continue;
+            }
+            addToken(static_cast<uint16_t>(pendingMatch.length), static_cast<uint16_t>(pendingMatch.distance));
+            const size_t end = position - 1 + pendingMatch.length;
+            for (++ position; position < end; ++ position) {
+                matchFinder.insert(position);
+            }
+            hasPendingMatch = false;
+            continue;
+        }
+        if (match.length >= MinMatchLength) {
+            if (isLazy && match.length < niceLength) {
+                pendingMatch = match;
+                hasPendingMatch = true;
+                ++ position;
+                continue;
+            }
+            addToken(static_cast<uint16_t>(match.length), static_cast<uint16_t>(match.distance));
+            const size_t end = position + match.length;
+            for (++ position; position < end; ++ position) {
+                matchFinder.insert(position);
+            }
+            continue;
+        }
+        addToken(window[position], 0);
+        ++ position;
+    }
+    if (hasPendingMatch) {
+        addToken(static_cast<uint16_t>(pendingMatch.length), static_cast<uint16_t>(pendingMatch.distance));
+    }
+
+    if (tokenList.empty() || !isFinal) {
+        // an empty stored block ends the range: it closes the stream or byte aligns it for the next range
+        flushBlock(false);
+        writer.write(isFinal ? 1 : 0, 1);
+        writer.write(0, 2);
+        writer.alignToByte();
+        writer.write(0x0000, 16);
+        writer.write(0xffff, 16);
+    } else {
+        flushBlock(true);
+        writer.alignToByte();
+    }
+}
+
+
+uint32_t ComputeAdler32(const uint8_t *data, size_t size, uint32_t adler)
+{
+    uint32_t sum1 = adler & 0xffff;
+    uint32_t sum2 = adler >> 16;
+    while (size > 0) {
+        const size_t blockSize = std::min(size, AdlerBlockSize);
+        for (size_t i = 0; i < blockSize; ++ i) {
+            sum1 += data[i];
+            sum2 += sum1;
+        }
+        sum1 %= AdlerBase;
+        sum2 %= AdlerBase;
+        data += blockSize;
+        size -= blockSize;
+    }
+    return (sum2 << 16) | sum1;
+}
+
+
+uint32_t CombineAdler32(uint32_t firstAdler, uint32_t secondAdler, size_t secondSize)
+{
+    const uint64_t remainder = secondSize % AdlerBase;
+    uint64_t sum1 = firstAdler & 0xffff;
+    uint64_t sum2 = (remainder * sum1) % AdlerBase;
+    sum1 += (secondAdler & 0xffff) + AdlerBase - 1;
+    sum2 += (firstAdler >> 16) + (secondAdler >> 16) + AdlerBase - remainder;
+    sum1 %= AdlerBase;
+    sum2 %= AdlerBase;
+    return static_cast<uint32_t>((sum2 << 16) | sum1);
+}
+
+
+uint32_t ComputeCRC32(const uint8_t *data, size_t size, uint32_t crc)
+{
+    static const std::array<uint32_t, 256> table = BuildCRC32Table();
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++ i) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+END_LUMIERE_NAMESPACE
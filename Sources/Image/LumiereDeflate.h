@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Common/LumiereMacro.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// appends raw deflate data for data[0, size) to output. matches may reach back into the
+// dictionarySize bytes in front of data, which lets independently compressed ranges be joined
+// into one stream: every range ends on a byte boundary, with a sync flush unless isFinal is set.
+// level 0 emits stored blocks, higher levels search longer match chains
+void DeflateRange(const uint8_t *data, size_t dictionarySize, size_t size, int level, bool isFinal, std::vector<uint8_t>& output);
+uint32_t ComputeAdler32(const uint8_t *data, size_t size, uint32_t adler = 1);
+// checksum of two consecutive ranges from their own checksums, secondSize is the length of the second range
+uint32_t CombineAdler32(uint32_t firstAdler, uint32_t secondAdler, size_t secondSize);
+uint32_t ComputeCRC32(const uint8_t *data, size_t size, uint32_t crc = 0);
+
+END_LUMIERE_NAMESPACE
@@ -1,6 +1,10 @@
 #include "LumiereImage.h"
+#include <algorithm>
+#include <cstring>
+#include "LumiereImageConversion.h"
 #include "Common/LumiereAssert.h"
 #include "Common/LumiereMemory.h"
+#include "Thread/LumiereThreadPool.h"
 
 BEGIN_LUMIERE_NAMESPACE
 
@@ -11,6 +15,10 @@ size_t Image::getSizeOfImageFormat(ImageFormat format)
         case ImageFormat::RGBA8: return 4 * sizeof(uint8_t);
         case ImageFormat::RGBF:  return 3 * sizeof(float);
         case ImageFormat::RGBAF: return 4 * sizeof(float);
+        case ImageFormat::RGBA16F: return 4 * sizeof(uint16_t);
+        case ImageFormat::R11G11B10F: return sizeof(uint32_t);
+        case ImageFormat::RGB9E5: return sizeof(uint32_t);
+        case ImageFormat::RGBE8: return 4 * sizeof(uint8_t);
         default: LUMIERE_ASSERT(false && "undefined image format");
     }
     return 0;
@@ -24,34 +32,60 @@ int Image::getChannelNumberOfImageFormat(ImageFormat format)
         case ImageFormat::RGBA8: return 4;
         case ImageFormat::RGBF: return 3;
         case ImageFormat::RGBAF: return 4;
+        case ImageFormat::RGBA16F: return 4;
+        case ImageFormat::R11G11B10F: return 3;
+        case ImageFormat::RGB9E5: return 3;
+        case ImageFormat::RGBE8: return 3;
         default: LUMIERE_ASSERT(false && "undefined image format");
     }
     return 0;
 }
 
 
-Image::Image(const std::string& name, ImageFormat format, int width, int height, uint8_t *data)
+bool Image::isHDRFormat(ImageFormat format)
+{
+    return format._value != ImageFormat::RGB8 && format._value != ImageFormat::RGBA8;
+}
+
+
+Image::DataPointer Image::allocateData(size_t byteSize)
+{
+    LUMIERE_EXPECT(byteSize > 0);
+    return DataPointer(LUMIERE_NEW uint8_t[byteSize], [](uint8_t *data) { LUMIERE_DELETE_ARRAY(data); });
+}
+
+
+Image::Image(const std::string& name, ImageFormat format, int width, int height, const uint8_t *data)
+    : Image(name, format, width, height)
+{
+    LUMIERE_EXPECT(data);
+    std::memcpy(mData.get(), data, getByteSize());
+}
+
+
+Image::Image(ImageFormat format, int width, int height, const uint8_t *data) : Image("", format, width, height, data)
+{
+    LUMIERE_ENSURE(mName.empty());
+}
+
+
+Image::Image(const std::string& name, ImageFormat format, int width, int height, DataPointer&& data)
     : mName(name)
-    , mFormat(format)
     , mWidth(width)
     , mHeight(height)
-    , mData(nullptr)
+    , mFormat(format)
+    , mData(std::move(data))
 {
     LUMIERE_ENSURE(mWidth > 0 && mWidth == width);
     LUMIERE_ENSURE(mHeight > 0 && mHeight == height);
     LUMIERE_ENSURE(mFormat._value == format._value);
-
-    LUMIERE_EXPECT(!mData);
-    auto byteSize = getSizeOfImageFormat(mFormat) * mWidth * mHeight;
-    mData = LUMIERE_NEW uint8_t[byteSize];
-    std::memcpy(mData, data, byteSize);
-    LUMIERE_ENSURE(mData);
+    LUMIERE_ENSURE(mData && !data);
 }
 
 
-Image::Image(ImageFormat format, int width, int height, uint8_t *data) : Image("", format, width, height, data)
+Image::Image(const std::string& name, ImageFormat format, int width, int height)
+    : Image(name, format, width, height, allocateData(getSizeOfImageFormat(format) * width * height))
 {
-    LUMIERE_ENSURE(mName.empty());
 }
 
 
@@ -60,25 +94,34 @@ Image::Image(Image&& image) noexcept
     , mWidth(image.mWidth)
     , mHeight(image.mHeight)
     , mFormat(image.mFormat)
-    , mData(image.mData)
+    , mData(std::move(image.mData))
 {
     LUMIERE_ENSURE(mHeight > 0 && mWidth > 0);
     LUMIERE_ENSURE(mFormat._value == image.mFormat._value);
-    LUMIERE_ENSURE(mData && mData == image.mData);
+    LUMIERE_ENSURE(mData && !image.mData);
 
     image.mWidth = image.mHeight = 0;
-    image.mData = nullptr;
     image.mFormat = ImageFormat::RGBA8;
     LUMIERE_ENSURE(image.mWidth == 0 && image.mHeight == 0);
     LUMIERE_ENSURE(image.mFormat._value == ImageFormat::RGBA8);
-    LUMIERE_ENSURE(!image.mData);
 }
 
 
-Image::~Image()
+Image& Image::operator=(Image&& image) noexcept
 {
-    LUMIERE_DELETE mData;
-};
+    if (this != &image) {
+        mName = std::move(image.mName);
+        mWidth = image.mWidth;
+        mHeight = image.mHeight;
+        mFormat = image.mFormat;
+        mData = std::move(image.mData);
+
+        image.mWidth = image.mHeight = 0;
+        image.mFormat = ImageFormat::RGBA8;
+    }
+    LUMIERE_ENSURE(!image.mData || this == &image);
+    return *this;
+}
 
 
 const std::string& Image::getName() const
@@ -105,10 +148,45 @@ ImageFormat Image::getFormat() const
 }
 
 
+size_t Image::getByteSize() const
+{
+    return getSizeOfImageFormat(mFormat) * mWidth * mHeight;
+}
+
+
+Image::DataPointer Image::releaseData()
+{
+    LUMIERE_EXPECT(mData);
+    mWidth = mHeight = 0;
+    return std::move(mData);
+}
+
+
 bool Image::isHDRImage() const
 {
-    const std::string imageFormatString = getFormat()._to_string();
-    return imageFormatString.find('F') != std::string::npos;
+    return isHDRFormat(mFormat);
+}
+
+
+Image Image::convert(ImageFormat format, bool isSRGB, ThreadPool *threadPool) const
+{
+    LUMIERE_EXPECT(mData);
+    Image image(mName, format, mWidth, mHeight);
+    const size_t sourceRowSize = getSizeOfImageFormat(mFormat) * mWidth;
+    const size_t targetRowSize = getSizeOfImageFormat(format) * mWidth;
+    if (format._value == mFormat._value) {
+        std::memcpy(image.getData(), getData(), getByteSize());
+        return image;
+    }
+
+    // stripes of roughly 64K pixels amortise the scheduling cost of small images
+    const size_t stripeRowCount = std::max<size_t>(1, (size_t(1) << 16) / static_cast<size_t>(mWidth));
+    auto convertStripe = [this, format, isSRGB, sourceRowSize, targetRowSize, &image](size_t begin, size_t end) {
+        ConvertPixels(getData() + begin * sourceRowSize, mFormat, image.getData() + begin * targetRowSize, format,
+                      (end - begin) * static_cast<size_t>(mWidth), isSRGB);
+    };
+    ParallelFor(threadPool, static_cast<size_t>(mHeight), stripeRowCount, convertStripe);
+    return image;
 }
 
 END_LUMIERE_NAMESPACE
@@ -1,6 +1,7 @@
 #pragma once
-#include <string>
+#include <functional>
 #include <memory>
+#include <string>
 #include <better-enums/enum.h>
 #include "Common/LumiereMacro.h"
 
@@ -10,19 +11,36 @@ BETTER_ENUM(ImageFormat, uint8_t,
             RGB8,
             RGBA8,
             RGBF,
-            RGBAF);
+            RGBAF,
+            RGBA16F,
+            R11G11B10F,
+            RGB9E5,
+            RGBE8);
+
+
+class ThreadPool;
 
 
 class Image {
 public:
+    // pixels are owned through the deleter of whoever allocated them, so buffers coming
+    // from a decoder (stbi_image_free) or a pool can be adopted without copying
+    using DataDeleter = std::function<void(uint8_t*)>;
+    using DataPointer = std::unique_ptr<uint8_t[], DataDeleter>;
+
     static size_t getSizeOfImageFormat(ImageFormat format);
     static int getChannelNumberOfImageFormat(ImageFormat format);
+    static bool isHDRFormat(ImageFormat format);
+    static DataPointer allocateData(size_t byteSize);
 
 public:
-    Image(const std::string& name, ImageFormat format, int width, int height, uint8_t *data);
-    Image(ImageFormat format, int width, int height, uint8_t *data);
-    ~Image();
+    Image(const std::string& name, ImageFormat format, int width, int height, const uint8_t *data);
+    Image(ImageFormat format, int width, int height, const uint8_t *data);
+    Image(const std::string& name, ImageFormat format, int width, int height, DataPointer&& data);
+    Image(const std::string& name, ImageFormat format, int width, int height);
+    ~Image() = default;
     Image(Image&& image) noexcept;
+    Image& operator=(Image&& image) noexcept;
     Image(const Image&) = delete;
     Image& operator=(const Image&) = delete;
 
@@ -31,21 +49,32 @@ public:
     uint32_t getHeight() const;
     ImageFormat getFormat() const;
     bool isHDRImage() const;
+    Image convert(ImageFormat format, bool isSRGB = true, ThreadPool *threadPool = nullptr) const;
+    size_t getByteSize() const;
     template <typename T = uint8_t> const T* getData() const;
+    template <typename T = uint8_t> T* getData();
+    DataPointer releaseData();
 
 private:
     std::string mName;
     int mWidth;
     int mHeight;
     ImageFormat mFormat;
-    uint8_t *mData;
+    DataPointer mData;
 };
 
 
 template <typename T>
 const T* Image::getData() const
 {
-    return reinterpret_cast<T*>(mData);
+    return reinterpret_cast<const T*>(mData.get());
+}
+
+
+template <typename T>
+T* Image::getData()
+{
+    return reinterpret_cast<T*>(mData.get());
 }
 
 END_LUMIERE_NAMESPACE
@@ -0,0 +1,164 @@
+#include "LumiereImageConversion.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "LumierePackedFloat.h"
+#include "LumiereSRGB.h"
+#include "Common/LumiereAssert.h"
+#include "Math/LumiereSIMDFloat.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr size_t PixelBatchSize = 256;
+
+bool IsUnorm8Format(ImageFormat format)
+{
+    return format._value == ImageFormat::RGB8 || format._value == ImageFormat::RGBA8;
+}
+
+
+bool IsFloatFormat(ImageFormat format)
+{
+    return format._value == ImageFormat::RGBF || format._value == ImageFormat::RGBAF;
+}
+
+
+// moves channels between two formats of the same component type without touching their values
+template <typename T>
+void CopyChannels(const T *source, int sourceChannelCount, T *destination, int destinationChannelCount, size_t pixelCount, T opaqueAlpha)
+{
+    if (sourceChannelCount == destinationChannelCount) {
+        std::memcpy(destination, source, pixelCount * sourceChannelCount * sizeof(T));
+        return;
+    }
+    for (size_t i = 0; i < pixelCount; ++ i) {
+        const T *sourcePixel = source + i * sourceChannelCount;
+        T *destinationPixel = destination + i * destinationChannelCount;
+        destinationPixel[0] = sourcePixel[0];
+        destinationPixel[1] = sourcePixel[1];
+        destinationPixel[2] = sourcePixel[2];
+        if (destinationChannelCount == 4) {
+            destinationPixel[3] = opaqueAlpha;
+        }
+    }
+}
+
+
+// all other conversions go through linear RGBA float
+void DecodeToRGBA(const uint8_t *source, ImageFormat format, size_t pixelCount, bool isSRGB, float *rgba)
+{
+    const int channelCount = Image::getChannelNumberOfImageFormat(format);
+    if (IsUnorm8Format(format)) {
+        const float *colorTable = GetSRGBToLinearTable();
+        for (size_t i = 0; i < pixelCount; ++ i) {
+            const uint8_t *sourcePixel = source + i * channelCount;
+            float *rgbaPixel = rgba + i * 4;
+            for (int channel = 0; channel < 3; ++ channel) {
+                rgbaPixel[channel] = isSRGB ? colorTable[sourcePixel[channel]] : sourcePixel[channel] * (1.0f / 255.0f);
+            }
+            rgbaPixel[3] = channelCount == 4 ? sourcePixel[3] * (1.0f / 255.0f) : 1.0f;
+        }
+    } else if (IsFloatFormat(format)) {
+        CopyChannels(reinterpret_cast<const float*>(source), channelCount, rgba, 4, pixelCount, 1.0f);
+    } else if (format._value == ImageFormat::RGBA16F) {
+        HalfToFloat(reinterpret_cast<const uint16_t*>(source), rgba, pixelCount * 4);
+    } else {
+        const auto *packedSource = reinterpret_cast<const uint32_t*>(source);
+        for (size_t i = 0; i < pixelCount; ++ i) {
+            float *rgbaPixel = rgba + i * 4;
+            switch (format) {
+                case ImageFormat::R11G11B10F: UnpackR11G11B10F(packedSource[i], rgbaPixel); break;
+                case ImageFormat::RGB9E5: UnpackRGB9E5(packedSource[i], rgbaPixel); break;
+                case ImageFormat::RGBE8: UnpackRGBE8(source + i * 4, rgbaPixel); break;
+                default: LUMIERE_ASSERT(false && "undefined image format");
+            }
+            rgbaPixel[3] = 1.0f;
+        }
+    }
+}
+
+
+void QuantizeUnorm8(float *value, size_t count)
+{
+    // leaves value * 255 rounded to the nearest integer (still as float) in place
+    using SIMDFloatType = SIMDFloat<float>;
+    constexpr size_t Width = SIMDFloatType::Width;
+    const SIMDFloatType zero(0.0f), one(1.0f), scale(255.0f), half(0.5f);
+    size_t i = 0;
+    for (; i + Width <= count; i += Width) {
+        const SIMDFloatType clamped = Min(Max(SIMDFloatType::LoadUnaligned(value + i), zero), one);
+        FMA(clamped, scale, half).storeUnaligned(value + i);
+    }
+    for (; i < count; ++ i) {
+        value[i] = std::min(std::max(value[i], 0.0f), 1.0f) * 255.0f + 0.5f;
+    }
+}
+
+
+void EncodeFromRGBA(float *rgba, ImageFormat format, size_t pixelCount, bool isSRGB, uint8_t *destination)
+{
+    const int channelCount = Image::getChannelNumberOfImageFormat(format);
+    if (IsUnorm8Format(format)) {
+        if (isSRGB) {
+            for (size_t i = 0; i < pixelCount; ++ i) {
+                for (int channel = 0; channel < 3; ++ channel) {
+                    destination[i * channelCount + channel] = LinearToSRGB(rgba[i * 4 + channel]);
+                }
+            }
+        }
+        QuantizeUnorm8(rgba, pixelCount * 4);
+        for (size_t i = 0; i < pixelCount; ++ i) {
+            for (int channel = isSRGB ? 3 : 0; channel < channelCount; ++ channel) {
+                destination[i * channelCount + channel] = static_cast<uint8_t>(rgba[i * 4 + channel]);
+            }
+        }
+    } else if (IsFloatFormat(format)) {
+        CopyChannels(rgba, 4, reinterpret_cast<float*>(destination), channelCount, pixelCount, 1.0f);
+    } else if (format._value == ImageFormat::RGBA16F) {
+        FloatToHalf(rgba, reinterpret_cast<uint16_t*>(destination), pixelCount * 4);
+    } else {
+        auto *packedDestination = reinterpret_cast<uint32_t*>(destination);
+        for (size_t i = 0; i < pixelCount; ++ i) {
+            const float *rgbaPixel = rgba + i * 4;
+            switch (format) {
+                case ImageFormat::R11G11B10F: packedDestination[i] = PackR11G11B10F(rgbaPixel); break;
+                case ImageFormat::RGB9E5: packedDestination[i] = PackRGB9E5(rgbaPixel); break;
+                case ImageFormat::RGBE8: PackRGBE8(rgbaPixel, destination + i * 4); break;
+                default: LUMIERE_ASSERT(false && "undefined image format");
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+void ConvertPixels(const uint8_t *source, ImageFormat sourceFormat, uint8_t *destination, ImageFormat destinationFormat,
+                   size_t pixelCount, bool isSRGB)
+{
+    LUMIERE_EXPECT(source && destination);
+    const int sourceChannelCount = Image::getChannelNumberOfImageFormat(sourceFormat);
+    const int destinationChannelCount = Image::getChannelNumberOfImageFormat(destinationFormat);
+    if (IsUnorm8Format(sourceFormat) && IsUnorm8Format(destinationFormat)) {
+        CopyChannels(source, sourceChannelCount, destination, destinationChannelCount, pixelCount, uint8_t(255));
+        return;
+    }
+    if (IsFloatFormat(sourceFormat) && IsFloatFormat(destinationFormat)) {
+        CopyChannels(reinterpret_cast<const float*>(source), sourceChannelCount,
+                     reinterpret_cast<float*>(destination), destinationChannelCount, pixelCount, 1.0f);
+        return;
+    }
+
+    const size_t sourcePixelSize = Image::getSizeOfImageFormat(sourceFormat);
+    const size_t destinationPixelSize = Image::getSizeOfImageFormat(destinationFormat);
+    std::vector<float> rgba(PixelBatchSize * 4);
+    for (size_t begin = 0; begin < pixelCount; begin += PixelBatchSize) {
+        const size_t batchSize = std::min(PixelBatchSize, pixelCount - begin);
+        DecodeToRGBA(source + begin * sourcePixelSize, sourceFormat, batchSize, isSRGB, rgba.data());
+        EncodeFromRGBA(rgba.data(), destinationFormat, batchSize, isSRGB, destination + begin * destinationPixelSize);
+    }
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "LumiereImage.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// converts pixelCount tightly packed pixels between two formats. float, half and packed HDR formats
+// hold linear values; with isSRGB the color channels of 8-bit formats are sRGB encoded, alpha is
+// always linear. a missing alpha channel is filled with one, an extra one is dropped
+void ConvertPixels(const uint8_t *source, ImageFormat sourceFormat, uint8_t *destination, ImageFormat destinationFormat,
+                   size_t pixelCount, bool isSRGB = true);
+
+END_LUMIERE_NAMESPACE
@@ -1,12 +1,47 @@
 #include "LumiereImageReader.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
+#include <limits>
 #include "Common/LumiereAssert.h"
-#include "Common/LumiereMemory.h"
 #include "Exception/LumiereException.h"
 
 BEGIN_LUMIERE_NAMESPACE
 
+namespace {
+
+Image::DataPointer AdoptDecodedData(void *data)
+{
+    return Image::DataPointer(static_cast<uint8_t*>(data), [](uint8_t *decodedData) { stbi_image_free(decodedData); });
+}
+
+
+int ReadDataStream(void *user, char *data, int size)
+{
+    auto dataStream = static_cast<DataStream*>(user);
+    return static_cast<int>(dataStream->read(data, static_cast<size_t>(size)));
+}
+
+
+void SkipDataStream(void *user, int size)
+{
+    // stbi_io_callbacks defines a negative size as ungetting the last -size bytes
+    auto dataStream = static_cast<DataStream*>(user);
+    if (size >= 0) {
+        dataStream->skip(static_cast<uint64_t>(size));
+    } else {
+        dataStream->seek(dataStream->tell() - static_cast<size_t>(-size));
+    }
+}
+
+
+int IsDataStreamEnd(void *user)
+{
+    return static_cast<DataStream*>(user)->eof() ? 1 : 0;
+}
+
+} // namespace
+
+
 ImageReader::ImageReader(std::unique_ptr<FileSystem>&& fileSystem)
     : mFileSystem(std::move(fileSystem))
 {
@@ -24,75 +59,106 @@ Image ImageReader::read(const std::string& filePath, ImageFormat format)
                 "unable to find file [{}] in filePath [{}]", filePath, canonicalFilePath);
     }
 
-    if (format._value == ImageFormat::RGB8) {
-        return loadRGB8ImageFromFile(canonicalFilePath);
-    } else if (format._value == ImageFormat::RGBA8) {
-        return loadRGBA8ImageFromFile(canonicalFilePath);
-    } else if (format._value == ImageFormat::RGBF) {
-        return loadRGBFImageFromFile(canonicalFilePath);
-    } else if (format._value == ImageFormat::RGBAF) {
-        return loadRGBAFImageFromFile(canonicalFilePath);
-    } else {
-        LUMIERE_ASSERT(false && "undefined image format");
-        return Image(ImageFormat::RGBA8, 0, 0, nullptr);
-    }
+    return decode(canonicalFilePath, format, [&canonicalFilePath](bool isHDR, int requiredChannels, int *width, int *height, int *channels) -> void* {
+        if (isHDR) {
+            return stbi_loadf(canonicalFilePath.c_str(), width, height, channels, requiredChannels);
+        }
+        return stbi_load(canonicalFilePath.c_str(), width, height, channels, requiredChannels);
+    });
 }
 
 
-Image ImageReader::loadRGBA8ImageFromFile(const std::string& path)
+Image ImageReader::read(DataStream& dataStream, ImageFormat format)
 {
-    int channels = 0, width = 0, height = 0;
-    uint8_t *data = stbi_load(path.c_str(), &width, &height, &channels, 4);
-    checkImageState(path, ImageFormat::RGBA8, data, channels, 4);
-    return Image(path, ImageFormat::RGBA8, width, height, data);
+    if (!dataStream.isReadable()) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::InvalidParams,
+                "fail to load image from data stream [{}] because it is not readable", dataStream.getName());
+    }
+
+    const stbi_io_callbacks callbacks = {ReadDataStream, SkipDataStream, IsDataStreamEnd};
+    return decode(dataStream.getName(), format, [&callbacks, &dataStream](bool isHDR, int requiredChannels, int *width, int *height, int *channels) -> void* {
+        if (isHDR) {
+            return stbi_loadf_from_callbacks(&callbacks, &dataStream, width, height, channels, requiredChannels);
+        }
+        return stbi_load_from_callbacks(&callbacks, &dataStream, width, height, channels, requiredChannels);
+    });
 }
 
 
-Image ImageReader::loadRGB8ImageFromFile(const std::string& path)
+Image ImageReader::read(const void *data, size_t byteSize, ImageFormat format)
 {
-    int channels = 0, width = 0, height = 0;
-    uint8_t *data = stbi_load(path.c_str(), &width, &height, &channels, 3);
-    checkImageState(path, ImageFormat::RGB8, data, channels, 3);
-    return Image(path, ImageFormat::RGB8, width, height, data);
+    LUMIERE_EXPECT(data);
+    if (byteSize == 0 || byteSize > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::InvalidParams,
+                "fail to load image from memory because its size [{}] is out of range", byteSize);
+    }
+
+    // stb decodes straight out of the buffer, so a mapped pack file is never copied
+    const auto *buffer = static_cast<const stbi_uc*>(data);
+    const int bufferSize = static_cast<int>(byteSize);
+    return decode("", format, [buffer, bufferSize](bool isHDR, int requiredChannels, int *width, int *height, int *channels) -> void* {
+        if (isHDR) {
+            return stbi_loadf_from_memory(buffer, bufferSize, width, height, channels, requiredChannels);
+        }
+        return stbi_load_from_memory(buffer, bufferSize, width, height, channels, requiredChannels);
+    });
 }
 
 
-Image ImageReader::loadRGBAFImageFromFile(const std::string& path)
+ImageReader::BatchReadResultList ImageReader::readBatch(const std::vector<std::string>& filePathList, ImageFormat format, ThreadPool *threadPool)
 {
-    int channels = 0, width = 0, height = 0;
-    float *source = stbi_loadf(path.c_str(), &width, &height, &channels, 4);
-    auto *data = reinterpret_cast<uint8_t *>(source);
-    checkImageState(path, ImageFormat::RGBAF, data, channels, 4);
-    return Image(path, ImageFormat::RGBAF, width, height, data);
+    // every file decodes into its own slot, so the result list keeps the order of filePathList
+    BatchReadResultList resultList(filePathList.size());
+    auto readRange = [this, &filePathList, format, &resultList](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++ i) {
+            try {
+                resultList[i].image.emplace(read(filePathList[i], format));
+            } catch (const std::exception& exception) {
+                resultList[i].errorMessage = exception.what();
+            }
+        }
+    };
+
+    ParallelFor(threadPool, filePathList.size(), 1, readRange);
+    return resultList;
 }
 
 
-Image ImageReader::loadRGBFImageFromFile(const std::string& path) noexcept(false)
+Image ImageReader::decode(const std::string& name, ImageFormat format, const DecodeFunction& decodeFunction)
 {
+    // stb only produces 8-bit and float pixels, half and packed HDR formats are converted from float
+    const bool isHDR = Image::isHDRFormat(format);
+    const int requiredChannels = Image::getChannelNumberOfImageFormat(format);
+    ImageFormat decodeFormat = format;
+    if (isHDR) {
+        decodeFormat = requiredChannels == 4 ? ImageFormat::RGBAF : ImageFormat::RGBF;
+    }
+
     int channels = 0, width = 0, height = 0;
-    float *source = stbi_loadf(path.c_str(), &width, &height, &channels, 3);
-    auto *data = reinterpret_cast<uint8_t*>(source);
-    checkImageState(path, ImageFormat::RGBF, data, channels, 3);
-    return Image(path, ImageFormat::RGBF, width, height, data);
+    auto data = AdoptDecodedData(decodeFunction(isHDR, requiredChannels, &width, &height, &channels));
+    checkImageState(name, decodeFormat, data.get(), requiredChannels);
+    Image image(name, decodeFormat, width, height, std::move(data));
+    if (decodeFormat._value != format._value) {
+        return image.convert(format);
+    }
+    return image;
 }
 
 
-void ImageReader::checkImageState(const std::string& name, ImageFormat format, uint8_t *data, int actualChannels, int requiredChannels) const
+void ImageReader::checkImageState(const std::string& name, ImageFormat format, const uint8_t *data, int requiredChannels) const
 {
-    LUMIERE_EXPECT(!name.empty());
-    LUMIERE_EXPECT(actualChannels > 0 && requiredChannels > 0);
+    // stb leaves the channel count untouched when decoding fails, so the buffer is checked first
     if (!data) {
         LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::ImageLoadError,
                                    "fail to load image [name={}, format={}] because {}", name, format._to_string(), stbi_failure_reason());
     }
 
-    if (actualChannels != requiredChannels) {
-        LUMIERE_DELETE_ARRAY(data);
+    // the source may have any channel count, stb converts it to the required one
+    if (requiredChannels < 1 || requiredChannels > 4) {
         LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::InvalidParams,
-                                   "fail to load image [path={}, format={}] because image channels is invalid [actual-channels={}, required-channels={}]",
+                                   "fail to load image [name={}, format={}] because required channels [{}] is invalid",
                                    name,
                                    format._to_string(),
-                                   actualChannels,
                                    requiredChannels);
     }
 }
@@ -1,21 +1,36 @@
 #pragma once
+#include <optional>
+#include <vector>
 #include "LumiereImage.h"
 #include "FileSystem/LumiereFileSystem.h"
+#include "Streaming/LumiereDataStream.h"
+#include "Thread/LumiereThreadPool.h"
 
 BEGIN_LUMIERE_NAMESPACE
 
 class ImageReader {
+public:
+    // either image is set or errorMessage tells why the file could not be read
+    struct BatchReadResult {
+        std::optional<Image> image;
+        std::string errorMessage;
+    };
+    using BatchReadResultList = std::vector<BatchReadResult>;
+
 public:
     explicit ImageReader(std::unique_ptr<FileSystem>&& fileSystem = std::make_unique<FileSystem>());
     virtual ~ImageReader() = default;
     virtual Image read(const std::string& filePath, ImageFormat format) noexcept(false);
+    virtual Image read(DataStream& dataStream, ImageFormat format) noexcept(false);
+    virtual Image read(const void *data, size_t byteSize, ImageFormat format) noexcept(false);
+    BatchReadResultList readBatch(const std::vector<std::string>& filePathList, ImageFormat format, ThreadPool *threadPool = nullptr);
 
 private:
-    Image loadRGB8ImageFromFile(const std::string& filePath) noexcept(false);
-    Image loadRGBA8ImageFromFile(const std::string& filePath) noexcept(false);
-    Image loadRGBFImageFromFile(const std::string& filePath) noexcept(false);
-    Image loadRGBAFImageFromFile(const std::string& filePath) noexcept(false);
-    void checkImageState(const std::string& name, ImageFormat format, uint8_t *data, int actualChannels, int requiredChannels) const;
+    // decodes 8-bit or float pixels with the requested channel count and reports the size and
+    // channel count of the source image, returning a buffer owned by stb
+    using DecodeFunction = std::function<void*(bool isHDR, int requiredChannels, int *width, int *height, int *channels)>;
+    Image decode(const std::string& name, ImageFormat format, const DecodeFunction& decodeFunction) noexcept(false);
+    void checkImageState(const std::string& name, ImageFormat format, const uint8_t *data, int requiredChannels) const;
 
 private:
     std::unique_ptr<FileSystem> mFileSystem;
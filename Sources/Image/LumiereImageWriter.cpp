@@ -1,11 +1,458 @@
 #include "LumiereImageWriter.h"
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include <stb/stb_image_write.h>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <fmt/format.h>
+#include "LumiereDeflate.h"
+#include "LumierePackedFloat.h"
 #include "Common/LumiereAssert.h"
 #include "Exception/LumiereException.h"
+#include "Streaming/LumiereFileStream.h"
 
 BEGIN_LUMIERE_NAMESPACE
 
+namespace {
+
+constexpr size_t StripesPerThread = 2;
+constexpr size_t DeflateWindowSize = 32768;
+constexpr uint8_t PNGSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+constexpr uint8_t QOIEndMarker[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+constexpr uint32_t MinRLEScanlineWidth = 8;
+constexpr uint32_t MaxRLEScanlineWidth = 0x7fff;
+
+// fills output with the encoded rows [firstRow, lastRow) of the file, counted from the top
+using StripeEncoder = std::function<void(uint32_t firstRow, uint32_t lastRow, std::vector<uint8_t>& output)>;
+
+
+void WriteBytes(DataStream& dataStream, const void *data, size_t byteSize)
+{
+    if (byteSize > 0 && dataStream.write(data, byteSize) != byteSize) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::FileSystemError, "fail to write image into [{}]", dataStream.getName());
+    }
+}
+
+
+void WriteBytes(DataStream& dataStream, const std::vector<uint8_t>& data)
+{
+    WriteBytes(dataStream, data.data(), data.size());
+}
+
+
+// stripes are encoded a batch at a time and written in order as soon as the batch is done, so
+// only a few stripes are held in memory whatever the size of the image
+void WriteStripes(DataStream& dataStream, uint32_t height, uint32_t stripeHeight, ThreadPool *threadPool, const StripeEncoder& encoder)
+{
+    const size_t stripeCount = (height + stripeHeight - 1) / stripeHeight;
+    const size_t batchSize = threadPool ? (threadPool->getWorkerCount() + 1) * StripesPerThread : 1;
+    std::vector<std::vector<uint8_t>> outputList(std::min(batchSize, stripeCount));
+    for (size_t batchBegin = 0; batchBegin < stripeCount; batchBegin += batchSize) {
+        const size_t batchEnd = std::min(batchBegin + batchSize, stripeCount);
+        ParallelFor(threadPool, batchEnd - batchBegin, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++ i) {
+                const auto firstRow = static_cast<uint32_t>((batchBegin + i) * stripeHeight);
+                outputList[i].clear();
+                encoder(firstRow, std::min(firstRow + stripeHeight, height), outputList[i]);
+            }
+        });
+        for (size_t i = 0; i < batchEnd - batchBegin; ++ i) {
+            WriteBytes(dataStream, outputList[i]);
+        }
+    }
+}
+
+
+void AppendUInt32BigEndian(std::vector<uint8_t>& output, uint32_t value)
+{
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        output.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+
+void AppendString(std::vector<uint8_t>& output, const std::string& str)
+{
+    output.insert(output.end(), str.begin(), str.end());
+}
+
+
+// a PNG chunk is its big endian data length, its type, the data and a CRC over type and data
+size_t BeginChunk(std::vector<uint8_t>& output, const char *type)
+{
+    const size_t chunkBegin = output.size();
+    AppendUInt32BigEndian(output, 0);
+    output.insert(output.end(), type, type + 4);
+    return chunkBegin;
+}
+
+
+void EndChunk(std::vector<uint8_t>& output, size_t chunkBegin)
+{
+    const size_t dataSize = output.size() - chunkBegin - 8;
+    LUMIERE_EXPECT(dataSize < (size_t(1) << 31));
+    for (int i = 0; i < 4; ++ i) {
+        output[chunkBegin + i] = static_cast<uint8_t>(dataSize >> (24 - 8 * i));
+    }
+    AppendUInt32BigEndian(output, ComputeCRC32(output.data() + chunkBegin + 4, dataSize + 4));
+}
+
+
+uint8_t PaethPredictor(int left, int up, int upLeft)
+{
+    const int estimate = left + up - upLeft;
+    const int leftDistance = std::abs(estimate - left);
+    const int upDistance = std::abs(estimate - up);
+    const int upLeftDistance = std::abs(estimate - upLeft);
+    if (leftDistance <= upDistance && leftDistance <= upLeftDistance) {
+        return static_cast<uint8_t>(left);
+    }
+    return static_cast<uint8_t>(upDistance <= upLeftDistance ? up : upLeft);
+}
+
+
+void ApplyFilter(int filter, const uint8_t *row, const uint8_t *previousRow, size_t rowSize, int pixelSize, uint8_t *output)
+{
+    for (size_t i = 0; i < rowSize; ++ i) {
+        const int left = i >= static_cast<size_t>(pixelSize) ? row[i - pixelSize] : 0;
+        const int up = previousRow[i];
+        const int upLeft = i >= static_cast<size_t>(pixelSize) ? previousRow[i - pixelSize] : 0;
+        int prediction = 0;
+        switch (filter) {
+            case 1: prediction = left; break;
+            case 2: prediction = up; break;
+            case 3: prediction = (left + up) / 2; break;
+            case 4: prediction = PaethPredictor(left, up, upLeft); break;
+            default: break;
+        }
+        output[i] = static_cast<uint8_t>(row[i] - prediction);
+    }
+}
+
+
+// writes the filter type byte and the filtered row; the filter with the smallest sum of absolute
+// signed residuals is chosen, stored rows are not filtered at all
+void FilterRow(const uint8_t *row, const uint8_t *previousRow, size_t rowSize, int pixelSize, bool isCompressed,
+               uint8_t *output, std::vector<uint8_t>& candidate)
+{
+    output[0] = 0;
+    if (!isCompressed) {
+        std::memcpy(output + 1, row, rowSize);
+        return;
+    }
+
+    uint64_t bestScore = UINT64_MAX;
+    candidate.resize(rowSize);
+    for (int filter = 0; filter < 5; ++ filter) {
+        ApplyFilter(filter, row, previousRow, rowSize, pixelSize, candidate.data());
+        uint64_t score = 0;
+        for (size_t i = 0; i < rowSize; ++ i) {
+            score += static_cast<uint64_t>(std::abs(static_cast<int8_t>(candidate[i])));
+        }
+        if (score < bestScore) {
+            bestScore = score;
+            output[0] = static_cast<uint8_t>(filter);
+            std::memcpy(output + 1, candidate.data(), rowSize);
+        }
+    }
+}
+
+
+// rows of the file count from the top of the picture
+const uint8_t* GetFileRow(const Image& image, uint32_t fileRow, size_t rowSize, bool flipVertically)
+{
+    const uint32_t imageRow = flipVertically ? image.getHeight() - 1 - fileRow : fileRow;
+    return image.getData() + static_cast<size_t>(imageRow) * rowSize;
+}
+
+
+// every stripe deflates its own filtered rows into one IDAT chunk and may reference the rows of
+// the previous stripe, which it filters again instead of waiting for them. the zlib header leads
+// the first stripe, the checksums of the stripes are combined once all of them are written
+void WritePNG(const Image& image, DataStream& dataStream, const ImageWriteOptions& options, ThreadPool *threadPool)
+{
+    const uint32_t width = image.getWidth();
+    const uint32_t height = image.getHeight();
+    const int channelCount = Image::getChannelNumberOfImageFormat(image.getFormat());
+    const size_t rowSize = static_cast<size_t>(width) * channelCount;
+    const size_t filteredRowSize = rowSize + 1;
+    const int level = options.compressionLevel;
+    const bool isCompressed = level > 0;
+    const auto dictionaryRowCount = static_cast<uint32_t>(isCompressed ? (DeflateWindowSize + filteredRowSize - 1) / filteredRowSize : 0);
+
+    std::vector<uint8_t> header(std::begin(PNGSignature), std::end(PNGSignature));
+    const size_t headerChunkBegin = BeginChunk(header, "IHDR");
+    AppendUInt32BigEndian(header, width);
+    AppendUInt32BigEndian(header, height);
+    header.push_back(8);
+    header.push_back(channelCount == 4 ? 6 : 2);
+    header.insert(header.end(), {0, 0, 0});
+    EndChunk(header, headerChunkBegin);
+    WriteBytes(dataStream, header);
+
+    const uint32_t stripeHeight = options.stripeHeight;
+    std::vector<uint32_t> adlerList((height + stripeHeight - 1) / stripeHeight);
+    WriteStripes(dataStream, height, stripeHeight, threadPool, [&](uint32_t firstRow, uint32_t lastRow, std::vector<uint8_t>& output) {
+        const uint32_t dictionaryBegin = firstRow - std::min(firstRow, dictionaryRowCount);
+        std::vector<uint8_t> filteredData(static_cast<size_t>(lastRow - dictionaryBegin) * filteredRowSize);
+        std::vector<uint8_t> zeroRow(dictionaryBegin == 0 ? rowSize : 0, 0);
+        std::vector<uint8_t> candidate;
+        for (uint32_t row = dictionaryBegin; row < lastRow; ++ row) {
+            const uint8_t *previousRow = row > 0 ? GetFileRow(image, row - 1, rowSize, options.flipVertically) : zeroRow.data();
+            FilterRow(GetFileRow(image, row, rowSize, options.flipVertically), previousRow, rowSize, channelCount, isCompressed,
+                      filteredData.data() + static_cast<size_t>(row - dictionaryBegin) * filteredRowSize, candidate);
+        }
+
+        const size_t dictionarySize = static_cast<size_t>(firstRow - dictionaryBegin) * filteredRowSize;
+        const uint8_t *stripeData = filteredData.data() + dictionarySize;
+        const size_t stripeSize = filteredData.size() - dictionarySize;
+        const size_t chunkBegin = BeginChunk(output, "IDAT");
+        if (firstRow == 0) {
+            // the level hint of the zlib header, followed by the check bits
+            const int levelHint = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+            const int flag = levelHint << 6;
+            output.push_back(0x78);
+            output.push_back(static_cast<uint8_t>(flag + (31 - (0x7800 + flag) % 31) % 31));
+        }
+        DeflateRange(stripeData, dictionarySize, stripeSize, level, false, output);
+        EndChunk(output, chunkBegin);
+        adlerList[firstRow / stripeHeight] = ComputeAdler32(stripeData, stripeSize);
+    });
+
+    uint32_t adler = 1;
+    for (size_t i = 0; i < adlerList.size(); ++ i) {
+        const uint32_t stripeRowCount = std::min(stripeHeight, height - static_cast<uint32_t>(i) * stripeHeight);
+        adler = CombineAdler32(adler, adlerList[i], stripeRowCount * filteredRowSize);
+    }
+    std::vector<uint8_t> trailer;
+    const size_t chunkBegin = BeginChunk(trailer, "IDAT");
+    DeflateRange(nullptr, 0, 0, level, true, trailer);
+    AppendUInt32BigEndian(trailer, adler);
+    EndChunk(trailer, chunkBegin);
+    EndChunk(trailer, BeginChunk(trailer, "IEND"));
+    WriteBytes(dataStream, trailer);
+}
+
+
+struct QOIPixel {
+    uint8_t red = 0;
+    uint8_t green = 0;
+    uint8_t blue = 0;
+    uint8_t alpha = 255;
+
+    bool operator==(const QOIPixel& other) const
+    {
+        return red == other.red && green == other.green && blue == other.blue && alpha == other.alpha;
+    }
+};
+
+
+// QOI carries the previous pixel, a pending run and a table of recent pixels from one pixel to
+// the next, so its stripes are encoded in order
+class QOIEncoder {
+public:
+    QOIEncoder() : mPreviousPixel(), mRunLength(0), mPixelTable()
+    {
+        // unlike the previous pixel, the table starts out transparent black
+        std::fill(std::begin(mPixelTable), std::end(mPixelTable), QOIPixel{0, 0, 0, 0});
+    }
+
+    void encode(const QOIPixel& pixel, std::vector<uint8_t>& output)
+    {
+        if (pixel == mPreviousPixel) {
+            if (++ mRunLength == 62) {
+                flushRun(output);
+            }
+            return;
+        }
+        flushRun(output);
+
+        const int hash = (pixel.red * 3 + pixel.green * 5 + pixel.blue * 7 + pixel.alpha * 11) % 64;
+        if (mPixelTable[hash] == pixel) {
+            output.push_back(static_cast<uint8_t>(hash));
+        } else if (pixel.alpha != mPreviousPixel.alpha) {
+            mPixelTable[hash] = pixel;
+            output.insert(output.end(), {0xff, pixel.red, pixel.green, pixel.blue, pixel.alpha});
+        } else {
+            mPixelTable[hash] = pixel;
+            const int redDelta = static_cast<int8_t>(pixel.red - mPreviousPixel.red);
+            const int greenDelta = static_cast<int8_t>(pixel.green - mPreviousPixel.green);
+            const int blueDelta = static_cast<int8_t>(pixel.blue - mPreviousPixel.blue);
+            const int redGreenDelta = redDelta - greenDelta;
+            const int blueGreenDelta = blueDelta - greenDelta;
+            if (redDelta >= -2 && redDelta <= 1 && greenDelta >= -2 && greenDelta <= 1 && blueDelta >= -2 && blueDelta <= 1) {
+                output.push_back(static_cast<uint8_t>(0x40 | (redDelta + 2) << 4 | (greenDelta + 2) << 2 | (blueDelta + 2)));
+            } else if (greenDelta >= -32 && greenDelta <= 31 && redGreenDelta >= -8 && redGreenDelta <= 7 &&
+                       blueGreenDelta >= -8 && blueGreenDelta <= 7) {
+                output.push_back(static_cast<uint8_t>(0x80 | (greenDelta + 32)));
+                output.push_back(static_cast<uint8_t>((redGreenDelta + 8) << 4 | (blueGreenDelta + 8)));
+            } else {
+                output.insert(output.end(), {0xfe, pixel.red, pixel.green, pixel.blue});
+            }
+        }
+        mPreviousPixel = pixel;
+    }
+
+    void flushRun(std::vector<uint8_t>& output)
+    {
+        if (mRunLength > 0) {
+            output.push_back(static_cast<uint8_t>(0xc0 | (mRunLength - 1)));
+            mRunLength = 0;
+        }
+    }
+
+private:
+    QOIPixel mPreviousPixel;
+    int mRunLength;
+    QOIPixel mPixelTable[64];
+};
+
+
+void WriteQOI(const Image& image, DataStream& dataStream, const ImageWriteOptions& options)
+{
+    const uint32_t width = image.getWidth();
+    const uint32_t height = image.getHeight();
+    const int channelCount = Image::getChannelNumberOfImageFormat(image.getFormat());
+    const size_t rowSize = static_cast<size_t>(width) * channelCount;
+
+    std::vector<uint8_t> header = {'q', 'o', 'i', 'f'};
+    AppendUInt32BigEndian(header, width);
+    AppendUInt32BigEndian(header, height);
+    header.push_back(static_cast<uint8_t>(channelCount));
+    header.push_back(0);
+    WriteBytes(dataStream, header);
+
+    QOIEncoder encoder;
+    WriteStripes(dataStream, height, options.stripeHeight, nullptr, [&](uint32_t firstRow, uint32_t lastRow, std::vector<uint8_t>& output) {
+        for (uint32_t row = firstRow; row < lastRow; ++ row) {
+            const uint8_t *rowData = GetFileRow(image, row, rowSize, options.flipVertically);
+            for (uint32_t x = 0; x < width; ++ x) {
+                const uint8_t *pixelData = rowData + static_cast<size_t>(x) * channelCount;
+                QOIPixel pixel;
+                pixel.red = pixelData[0];
+                pixel.green = pixelData[1];
+                pixel.blue = pixelData[2];
+                pixel.alpha = channelCount == 4 ? pixelData[3] : 255;
+                encoder.encode(pixel, output);
+            }
+        }
+    });
+
+    std::vector<uint8_t> trailer;
+    encoder.flushRun(trailer);
+    trailer.insert(trailer.end(), std::begin(QOIEndMarker), std::end(QOIEndMarker));
+    WriteBytes(dataStream, trailer);
+}
+
+
+// runs of four or more equal bytes are stored as a count above 128 and the byte, other bytes are
+// stored as a count up to 128 followed by the bytes themselves
+void EncodeRLEComponent(const uint8_t *component, uint32_t width, std::vector<uint8_t>& output)
+{
+    uint32_t x = 0;
+    while (x < width) {
+        uint32_t runLength = 1;
+        while (x + runLength < width && runLength < 127 && component[x + runLength] == component[x]) {
+            ++ runLength;
+        }
+        if (runLength >= 4) {
+            output.push_back(static_cast<uint8_t>(128 + runLength));
+            output.push_back(component[x]);
+            x += runLength;
+            continue;
+        }
+
+        uint32_t end = x;
+        while (end < width && end - x < 128) {
+            if (end + 3 < width && component[end] == component[end + 1] && component[end] == component[end + 2] &&
+                component[end] == component[end + 3]) {
+                break;
+            }
+            ++ end;
+        }
+        output.push_back(static_cast<uint8_t>(end - x));
+        output.insert(output.end(), component + x, component + end);
+        x = end;
+    }
+}
+
+
+// scanlines are run length coded per component; widths the RLE layout can not describe are
+// written as flat RGBE pixels, as Radiance readers expect
+void WriteHDR(const Image& image, DataStream& dataStream, const ImageWriteOptions& options, ThreadPool *threadPool)
+{
+    const uint32_t width = image.getWidth();
+    const uint32_t height = image.getHeight();
+    const int channelCount = Image::getChannelNumberOfImageFormat(image.getFormat());
+    const size_t rowSize = static_cast<size_t>(width) * channelCount * sizeof(float);
+    const bool isRLE = width >= MinRLEScanlineWidth && width <= MaxRLEScanlineWidth;
+
+    std::vector<uint8_t> header;
+    AppendString(header, fmt::format("#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y {} +X {}\n", height, width));
+    WriteBytes(dataStream, header);
+
+    WriteStripes(dataStream, height, options.stripeHeight, threadPool, [&](uint32_t firstRow, uint32_t lastRow, std::vector<uint8_t>& output) {
+        std::vector<uint8_t> rgbeRow(static_cast<size_t>(width) * 4);
+        std::vector<uint8_t> component(isRLE ? width : 0);
+        for (uint32_t row = firstRow; row < lastRow; ++ row) {
+            const auto *rowData = reinterpret_cast<const float*>(GetFileRow(image, row, rowSize, options.flipVertically));
+            for (uint32_t x = 0; x < width; ++ x) {
+                PackRGBE8(rowData + static_cast<size_t>(x) * channelCount, rgbeRow.data() + static_cast<size_t>(x) * 4);
+            }
+            if (!isRLE) {
+                output.insert(output.end(), rgbeRow.begin(), rgbeRow.end());
+                continue;
+            }
+            output.insert(output.end(), {2, 2, static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(width & 0xff)});
+            for (int channel = 0; channel < 4; ++ channel) {
+                for (uint32_t x = 0; x < width; ++ x) {
+                    component[x] = rgbeRow[static_cast<size_t>(x) * 4 + channel];
+                }
+                EncodeRLEComponent(component.data(), width, output);
+            }
+        }
+    });
+}
+
+
+// PFM stores little endian float RGB rows from the bottom of the picture upwards
+void WritePFM(const Image& image, DataStream& dataStream, const ImageWriteOptions& options, ThreadPool *threadPool)
+{
+    const uint32_t width = image.getWidth();
+    const uint32_t height = image.getHeight();
+    const int channelCount = Image::getChannelNumberOfImageFormat(image.getFormat());
+    const size_t rowSize = static_cast<size_t>(width) * channelCount * sizeof(float);
+
+    std::vector<uint8_t> header;
+    AppendString(header, fmt::format("PF\n{} {}\n-1.0\n", width, height));
+    WriteBytes(dataStream, header);
+
+    WriteStripes(dataStream, height, options.stripeHeight, threadPool, [&](uint32_t firstRow, uint32_t lastRow, std::vector<uint8_t>& output) {
+        output.resize(static_cast<size_t>(lastRow - firstRow) * width * 3 * sizeof(float));
+        auto *outputData = reinterpret_cast<float*>(output.data());
+        for (uint32_t row = firstRow; row < lastRow; ++ row) {
+            const auto *rowData = reinterpret_cast<const float*>(GetFileRow(image, height - 1 - row, rowSize, options.flipVertically));
+            for (uint32_t x = 0; x < width; ++ x) {
+                std::memcpy(outputData, rowData + static_cast<size_t>(x) * channelCount, 3 * sizeof(float));
+                outputData += 3;
+            }
+        }
+    });
+}
+
+
+ImageFormat GetFileImageFormat(const Image& image, ImageFileFormat fileFormat)
+{
+    const bool hasAlpha = Image::getChannelNumberOfImageFormat(image.getFormat()) == 4;
+    switch (fileFormat) {
+        case ImageFileFormat::PNG:
+        case ImageFileFormat::QOI: return hasAlpha ? ImageFormat::RGBA8 : ImageFormat::RGB8;
+        // the alpha channel of float images is skipped while writing
+        default: return hasAlpha ? ImageFormat::RGBAF : ImageFormat::RGBF;
+    }
+}
+
+} // namespace
+
+
 ImageWriter::ImageWriter(std::unique_ptr<FileSystem>&& fileSystem)
     : mFileSystem(std::move(fileSystem))
 {
@@ -14,22 +461,61 @@ ImageWriter::ImageWriter(std::unique_ptr<FileSystem>&& fileSystem)
 }
 
 
+const char* ImageWriter::getFileExtension(ImageFileFormat fileFormat)
+{
+    switch (fileFormat) {
+        case ImageFileFormat::PNG: return ".png";
+        case ImageFileFormat::QOI: return ".qoi";
+        case ImageFileFormat::HDR: return ".hdr";
+        case ImageFileFormat::PFM: return ".pfm";
+        default: LUMIERE_ASSERT(false && "undefined image file format");
+    }
+    return "";
+}
+
+
 void ImageWriter::write(const Image& image, const std::string& directory, const std::string& name)
 {
-    const std::string directoryPath = mFileSystem->weaklyCanonical(directory);
-    if (!mFileSystem->directoryExist(directoryPath)) {
+    ImageWriteOptions options;
+    options.fileFormat = image.isHDRImage() ? ImageFileFormat::HDR : ImageFileFormat::PNG;
+    write(image, directory, name, options);
+}
+
+
+void ImageWriter::write(const Image& image, const std::string& directory, const std::string& name,
+                        const ImageWriteOptions& options, ThreadPool *threadPool)
+{
+    if (!mFileSystem->directoryExist(directory)) {
         LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::FileSystemError,
-                                   "fail to save image into path [{}] because directory [{}] does not exists", name, directoryPath);
+                                   "fail to save image into path [{}] because directory [{}] does not exists", name, directory);
+    }
+    FileStream fileStream(mFileSystem->combine(directory, name + getFileExtension(options.fileFormat)), FileAccessMode::WRITE);
+    write(image, fileStream, options, threadPool);
+}
+
+
+void ImageWriter::write(const Image& image, DataStream& dataStream, const ImageWriteOptions& options, ThreadPool *threadPool)
+{
+    LUMIERE_EXPECT(image.getData());
+    LUMIERE_EXPECT(options.compressionLevel >= 0 && options.compressionLevel <= 9);
+    LUMIERE_EXPECT(options.stripeHeight > 0);
+    if (!dataStream.isWriteable()) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::FileSystemError, "fail to write image [{}] into [{}] which is not writeable",
+                                   image.getName(), dataStream.getName());
+    }
+
+    const ImageFormat fileImageFormat = GetFileImageFormat(image, options.fileFormat);
+    if (image.getFormat()._value != fileImageFormat._value) {
+        write(image.convert(fileImageFormat, true, threadPool), dataStream, options, threadPool);
+        return;
     }
 
-    int channelNumber = Image::getChannelNumberOfImageFormat(image.getFormat());
-    stbi_flip_vertically_on_write(true);
-    if (!image.isHDRImage()) {
-        const std::string imageName = mFileSystem->combine(directoryPath, name + ".png");
-        stbi_write_png(imageName.c_str(), image.getWidth(), image.getHeight(), channelNumber, image.getData(), 0);
-    } else {
-        const std::string imageName = mFileSystem->combine(directoryPath, name + ".hdr");
-        stbi_write_hdr(imageName.c_str(), image.getWidth(), image.getHeight(), channelNumber, reinterpret_cast<const float*>(image.getData()));
+    switch (options.fileFormat) {
+        case ImageFileFormat::PNG: WritePNG(image, dataStream, options, threadPool); break;
+        case ImageFileFormat::QOI: WriteQOI(image, dataStream, options); break;
+        case ImageFileFormat::HDR: WriteHDR(image, dataStream, options, threadPool); break;
+        case ImageFileFormat::PFM: WritePFM(image, dataStream, options, threadPool); break;
+        default: LUMIERE_ASSERT(false && "undefined image file format");
     }
 }
 
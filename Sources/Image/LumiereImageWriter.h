@@ -1,16 +1,45 @@
 #pragma once
 #include <memory>
+#include <better-enums/enum.h>
 #include "LumiereImage.h"
 #include "FileSystem/LumiereFileSystem.h"
+#include "Streaming/LumiereDataStream.h"
+#include "Thread/LumiereThreadPool.h"
 
 BEGIN_LUMIERE_NAMESPACE
 
+// PNG and QOI store 8-bit RGB or RGBA, HDR (Radiance RGBE) and PFM store float RGB; images in
+// other formats are converted first
+BETTER_ENUM(ImageFileFormat, uint8_t,
+            PNG,
+            QOI,
+            HDR,
+            PFM);
+
+
+struct ImageWriteOptions {
+    ImageFileFormat fileFormat = ImageFileFormat::PNG;
+    // zlib level of PNG files from 0 to 9, 0 stores the rows without compression
+    int compressionLevel = 6;
+    // rows are encoded stripe by stripe; PNG, HDR and PFM stripes are encoded in parallel
+    uint32_t stripeHeight = 32;
+    // the first row of the image ends up at the bottom of the picture
+    bool flipVertically = true;
+};
+
+
+// writers keep no state between calls, so one writer can write several images concurrently
 class ImageWriter {
 public:
     explicit ImageWriter(std::unique_ptr<FileSystem>&& fileSystem = std::make_unique<FileSystem>());
     virtual ~ImageWriter() = default;
 
+    static const char* getFileExtension(ImageFileFormat fileFormat);
+    // PNG for 8-bit images and HDR for HDR images, named after name plus the extension
     virtual void write(const Image& image, const std::string& directory, const std::string& name);
+    virtual void write(const Image& image, const std::string& directory, const std::string& name,
+                       const ImageWriteOptions& options, ThreadPool *threadPool = nullptr);
+    virtual void write(const Image& image, DataStream& dataStream, const ImageWriteOptions& options, ThreadPool *threadPool = nullptr);
 
 private:
     std::unique_ptr<FileSystem> mFileSystem;
@@ -0,0 +1,265 @@
+#include "LumiereMipMap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "LumiereSRGB.h"
+#include "Common/LumiereAssert.h"
+#include "Math/LumiereSIMDFloat.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr size_t RowGrainSize = 8;
+constexpr double KaiserAlpha = 4.0;
+constexpr double KaiserLobeCount = 3.0;
+
+// every target texel of one axis reads tapCount source texels; shorter footprints are padded
+// with zero weights so that the inner loops have a fixed trip count
+struct AxisFilter {
+    uint32_t tapCount = 0;
+    // widest range of source indices read by one target texel
+    uint32_t footprintSize = 0;
+    std::vector<uint32_t> indexList;
+    std::vector<float> weightList;
+};
+
+
+double BesselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32 && term > 1e-12 * sum; ++ k) {
+        term *= (x * x) / (4.0 * k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+
+double Sinc(double x)
+{
+    if (std::abs(x) < 1e-8) {
+        return 1.0;
+    }
+    const double pix = 3.14159265358979323846 * x;
+    return std::sin(pix) / pix;
+}
+
+
+AxisFilter ComputeAxisFilter(uint32_t sourceSize, uint32_t targetSize, MipMapFilter filter)
+{
+    LUMIERE_EXPECT(targetSize > 0 && targetSize <= sourceSize);
+    const double scale = static_cast<double>(sourceSize) / targetSize;
+    std::vector<std::vector<std::pair<uint32_t, double>>> tapListList(targetSize);
+
+    for (uint32_t i = 0; i < targetSize; ++ i) {
+        auto& tapList = tapListList[i];
+        if (filter == MipMapFilter::Box) {
+            const double begin = i * scale;
+            const double end = (i + 1) * scale;
+            const auto first = static_cast<uint32_t>(std::floor(begin));
+            const auto last = std::min(static_cast<uint32_t>(std::ceil(end)), sourceSize);
+            for (uint32_t j = first; j < last; ++ j) {
+                const double coverage = std::min<double>(end, j + 1) - std::max<double>(begin, j);
+                if (coverage > 0.0) {
+                    tapList.emplace_back(j, coverage);
+                }
+            }
+        } else {
+            // texel centers sit at half integers; taps beyond the edge are clamped to it
+            const double center = (i + 0.5) * scale;
+            const double radius = KaiserLobeCount * scale;
+            const auto first = static_cast<int64_t>(std::floor(center - radius));
+            const auto last = static_cast<int64_t>(std::ceil(center + radius));
+            for (int64_t j = first; j <= last; ++ j) {
+                const double t = (j + 0.5 - center) / radius;
+                if (std::abs(t) >= 1.0) {
+                    continue;
+                }
+                const double window = BesselI0(KaiserAlpha * std::sqrt(1.0 - t * t)) / BesselI0(KaiserAlpha);
+                const auto index = static_cast<uint32_t>(std::clamp<int64_t>(j, 0, static_cast<int64_t>(sourceSize) - 1));
+                tapList.emplace_back(index, Sinc((j + 0.5 - center) / scale) * window);
+            }
+        }
+    }
+
+    AxisFilter axisFilter;
+    for (const auto& tapList : tapListList) {
+        axisFilter.tapCount = std::max(axisFilter.tapCount, static_cast<uint32_t>(tapList.size()));
+    }
+    axisFilter.indexList.resize(static_cast<size_t>(targetSize) * axisFilter.tapCount);
+    axisFilter.weightList.resize(static_cast<size_t>(targetSize) * axisFilter.tapCount);
+    for (uint32_t i = 0; i < targetSize; ++ i) {
+        const auto& tapList = tapListList[i];
+        AccumulationFloat weightSum = 0.0;
+        uint32_t firstIndex = tapList.front().first, lastIndex = tapList.front().first;
+        for (const auto& tap : tapList) {
+            weightSum += tap.second;
+            firstIndex = std::min(firstIndex, tap.first);
+            lastIndex = std::max(lastIndex, tap.first);
+        }
+        axisFilter.footprintSize = std::max(axisFilter.footprintSize, lastIndex - firstIndex + 1);
+        for (uint32_t k = 0; k < axisFilter.tapCount; ++ k) {
+            const size_t slot = static_cast<size_t>(i) * axisFilter.tapCount + k;
+            axisFilter.indexList[slot] = k < tapList.size() ? tapList[k].first : tapList.front().first;
+            axisFilter.weightList[slot] = k < tapList.size() ? static_cast<float>(tapList[k].second / weightSum) : 0.0f;
+        }
+    }
+    return axisFilter;
+}
+
+
+void AccumulateRow(const float *source, float weight, size_t count, float *accumulator)
+{
+    using SIMDFloatType = SIMDFloat<float>;
+    constexpr size_t Width = SIMDFloatType::Width;
+    const SIMDFloatType simdWeight(weight);
+    size_t i = 0;
+    for (; i + Width <= count; i += Width) {
+        const SIMDFloatType sum = FMA(simdWeight, SIMDFloatType::LoadUnaligned(source + i), SIMDFloatType::LoadUnaligned(accumulator + i));
+        sum.storeUnaligned(accumulator + i);
+    }
+    for (; i < count; ++ i) {
+        accumulator[i] += weight * source[i];
+    }
+}
+
+
+void DecodeRow(const uint8_t *source, int channelCount, bool isSRGB, size_t pixelCount, float *destination)
+{
+    const float *decodeTable = GetSRGBToLinearTable();
+    for (size_t i = 0; i < pixelCount * channelCount; ++ i) {
+        const bool isColor = isSRGB && static_cast<int>(i % channelCount) < 3;
+        destination[i] = isColor ? decodeTable[source[i]] : source[i] * (1.0f / 255.0f);
+    }
+}
+
+
+void EncodeRow(const float *source, int channelCount, bool isSRGB, size_t pixelCount, uint8_t *destination)
+{
+    for (size_t i = 0; i < pixelCount * channelCount; ++ i) {
+        const bool isColor = isSRGB && static_cast<int>(i % channelCount) < 3;
+        if (isColor) {
+            destination[i] = LinearToSRGB(source[i]);
+        } else {
+            destination[i] = static_cast<uint8_t>(std::clamp(source[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+}
+
+} // namespace
+
+
+uint32_t GetMipLevelCount(uint32_t width, uint32_t height)
+{
+    uint32_t size = std::max(width, height);
+    uint32_t levelCount = 1;
+    while (size > 1) {
+        size /= 2;
+        ++ levelCount;
+    }
+    return levelCount;
+}
+
+
+Image DownsampleImage(const Image& image, uint32_t width, uint32_t height, MipMapFilter filter, bool isSRGB, ThreadPool *threadPool)
+{
+    LUMIERE_EXPECT(image.getData());
+    LUMIERE_EXPECT(width > 0 && width <= image.getWidth());
+    LUMIERE_EXPECT(height > 0 && height <= image.getHeight());
+
+    const ImageFormat format = image.getFormat();
+    const int channelCount = Image::getChannelNumberOfImageFormat(format);
+    if (image.isHDRImage() && format._value != ImageFormat::RGBF && format._value != ImageFormat::RGBAF) {
+        // half and packed HDR formats are filtered as float and packed again afterwards
+        const ImageFormat floatFormat = channelCount == 4 ? ImageFormat::RGBAF : ImageFormat::RGBF;
+        const Image floatImage = image.convert(floatFormat, isSRGB, threadPool);
+        return DownsampleImage(floatImage, width, height, filter, isSRGB, threadPool).convert(format, isSRGB, threadPool);
+    }
+    const bool isHDR = image.isHDRImage();
+    const uint32_t sourceWidth = image.getWidth();
+    const size_t sourceRowSize = static_cast<size_t>(sourceWidth) * channelCount;
+    const size_t targetRowSize = static_cast<size_t>(width) * channelCount;
+    const AxisFilter horizontalFilter = ComputeAxisFilter(sourceWidth, width, filter);
+    const AxisFilter verticalFilter = ComputeAxisFilter(image.getHeight(), height, filter);
+    Image target(image.getName(), format, static_cast<int>(width), static_cast<int>(height));
+    uint8_t *targetData = target.getData();
+
+    // the vertical pass blends whole source rows with SIMD, the horizontal pass then gathers taps
+    // out of the blended row; both run in float. 8-bit rows are decoded into a ring as wide as the
+    // vertical footprint, so the taps of one target row never evict each other and every source
+    // row is decoded once per stripe
+    const size_t ringSize = isHDR ? 0 : verticalFilter.footprintSize;
+    ParallelFor(threadPool, height, RowGrainSize, [&](size_t begin, size_t end) {
+        std::vector<float> decodedRowRing(ringSize * sourceRowSize);
+        std::vector<size_t> ringRowList(ringSize, SIZE_MAX);
+        std::vector<float> blendedRow(sourceRowSize);
+        std::vector<float> targetRow(targetRowSize);
+
+        for (size_t y = begin; y < end; ++ y) {
+            std::fill(blendedRow.begin(), blendedRow.end(), 0.0f);
+            for (uint32_t k = 0; k < verticalFilter.tapCount; ++ k) {
+                const size_t slot = y * verticalFilter.tapCount + k;
+                const float weight = verticalFilter.weightList[slot];
+                if (weight == 0.0f) {
+                    continue;
+                }
+                const size_t sourceY = verticalFilter.indexList[slot];
+                const float *sourceRow = nullptr;
+                if (isHDR) {
+                    sourceRow = image.getData<float>() + sourceY * sourceRowSize;
+                } else {
+                    const size_t ringSlot = sourceY % ringSize;
+                    float *decodedRow = decodedRowRing.data() + ringSlot * sourceRowSize;
+                    if (ringRowList[ringSlot] != sourceY) {
+                        DecodeRow(image.getData() + sourceY * sourceRowSize, channelCount, isSRGB, sourceWidth, decodedRow);
+                        ringRowList[ringSlot] = sourceY;
+                    }
+                    sourceRow = decodedRow;
+                }
+                AccumulateRow(sourceRow, weight, sourceRowSize, blendedRow.data());
+            }
+
+            for (uint32_t x = 0; x < width; ++ x) {
+                float *targetPixel = targetRow.data() + static_cast<size_t>(x) * channelCount;
+                std::fill(targetPixel, targetPixel + channelCount, 0.0f);
+                for (uint32_t k = 0; k < horizontalFilter.tapCount; ++ k) {
+                    const size_t slot = static_cast<size_t>(x) * horizontalFilter.tapCount + k;
+                    const float weight = horizontalFilter.weightList[slot];
+                    const float *sourcePixel = blendedRow.data() + static_cast<size_t>(horizontalFilter.indexList[slot]) * channelCount;
+                    for (int channel = 0; channel < channelCount; ++ channel) {
+                        targetPixel[channel] += weight * sourcePixel[channel];
+                    }
+                }
+            }
+
+            if (isHDR) {
+                // Kaiser lobes may ring below zero, which is not a valid radiance
+                float *targetData32 = reinterpret_cast<float*>(targetData) + y * targetRowSize;
+                for (size_t i = 0; i < targetRowSize; ++ i) {
+                    targetData32[i] = std::max(targetRow[i], 0.0f);
+                }
+            } else {
+                EncodeRow(targetRow.data(), channelCount, isSRGB, width, targetData + y * targetRowSize);
+            }
+        }
+    });
+    return target;
+}
+
+
+std::vector<Image> GenerateMipChain(const Image& image, MipMapFilter filter, bool isSRGB, ThreadPool *threadPool)
+{
+    const uint32_t levelCount = GetMipLevelCount(image.getWidth(), image.getHeight());
+    std::vector<Image> levelList;
+    levelList.reserve(levelCount - 1);
+    for (uint32_t level = 1; level < levelCount; ++ level) {
+        const Image& previousLevel = level == 1 ? image : levelList.back();
+        const uint32_t width = std::max(previousLevel.getWidth() / 2, 1u);
+        const uint32_t height = std::max(previousLevel.getHeight() / 2, 1u);
+        levelList.push_back(DownsampleImage(previousLevel, width, height, filter, isSRGB, threadPool));
+    }
+    return levelList;
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "LumiereImage.h"
+#include "Thread/LumiereThreadPool.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// Box averages the exact source area under every target texel, so odd sizes are handled without
+// shifting the image; Kaiser is a Kaiser-windowed sinc over three lobes that keeps more detail
+enum class MipMapFilter { Box, Kaiser };
+
+
+// filtering runs in linear float space: with isSRGB the color channels of 8-bit images are decoded
+// from sRGB before filtering and encoded again afterwards, alpha is always treated as linear
+uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+Image DownsampleImage(const Image& image, uint32_t width, uint32_t height, MipMapFilter filter = MipMapFilter::Box,
+                      bool isSRGB = true, ThreadPool *threadPool = nullptr);
+// returns every level below the base image, each one half the size of the previous level
+std::vector<Image> GenerateMipChain(const Image& image, MipMapFilter filter = MipMapFilter::Box,
+                                    bool isSRGB = true, ThreadPool *threadPool = nullptr);
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,211 @@
+#include "LumierePackedFloat.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Common/LumiereSIMD.h"
+#include "Math/LumiereFloatDefs.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+// unsigned floats of the 11 and 10 bit channels: 5 exponent bits with a bias of 15 and no sign
+uint32_t PackUnsignedFloat(float value, int mantissaBits)
+{
+    const uint32_t mantissaMask = (1u << mantissaBits) - 1;
+    const uint32_t maxEncoding = (30u << mantissaBits) | mantissaMask;
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+
+    const uint32_t bits = FloatToBits(value);
+    if (bits < 0x38800000u) {
+        // below 2^-14 the format is denormal with a step of 2^(-14 - mantissaBits)
+        return static_cast<uint32_t>(std::nearbyint(std::ldexp(value, 14 + mantissaBits)));
+    }
+    const int shift = 23 - mantissaBits;
+    const uint32_t rounded = bits + ((1u << (shift - 1)) - 1) + ((bits >> shift) & 1);
+    const int exponent = static_cast<int>(rounded >> 23) - 127 + 15;
+    if (exponent > 30) {
+        return maxEncoding;
+    }
+    return (static_cast<uint32_t>(exponent) << mantissaBits) | ((rounded >> shift) & mantissaMask);
+}
+
+
+float UnpackUnsignedFloat(uint32_t value, int mantissaBits)
+{
+    const uint32_t exponent = value >> mantissaBits;
+    const uint32_t mantissa = value & ((1u << mantissaBits) - 1);
+    if (exponent == 0) {
+        return std::ldexp(static_cast<float>(mantissa), -14 - mantissaBits);
+    }
+    if (exponent == 31) {
+        return mantissa == 0 ? std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+    }
+    return BitsToFloat(((exponent + 112) << 23) | (mantissa << (23 - mantissaBits)));
+}
+
+
+float ClampNonNegative(float value, float maxValue)
+{
+    // also maps NaN to zero
+    return value > 0.0f ? std::min(value, maxValue) : 0.0f;
+}
+
+} // namespace
+
+
+uint16_t FloatToHalf(float value)
+{
+    const uint32_t bits = FloatToBits(value);
+    const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    uint32_t absBits = bits & 0x7fffffffu;
+
+    if (absBits > 0x7f800000u) {
+        // NaNs keep the top of their payload and come out quiet, as with F16C
+        return static_cast<uint16_t>(sign | 0x7e00u | ((absBits >> 13) & 0x3ffu));
+    }
+    if (absBits >= 0x477ff000u) {
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    if (absBits < 0x38800000u) {
+        // adding 0.5 lines the half denormal step up with the float ulp and lets the FPU round
+        const float denormal = BitsToFloat(absBits) + 0.5f;
+        return static_cast<uint16_t>(sign | (FloatToBits(denormal) - 0x3f000000u));
+    }
+    absBits += 0xc8000fffu + ((absBits >> 13) & 1u);
+    return static_cast<uint16_t>(sign | (absBits >> 13));
+}
+
+
+float HalfToFloat(uint16_t value)
+{
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1fu;
+    const uint32_t mantissa = value & 0x3ffu;
+    if (exponent == 0) {
+        const float denormal = std::ldexp(static_cast<float>(mantissa), -24);
+        return BitsToFloat(sign | FloatToBits(denormal));
+    }
+    if (exponent == 31) {
+        // signalling NaNs are quieted, as with F16C
+        return BitsToFloat(sign | 0x7f800000u | (mantissa != 0 ? 0x400000u : 0u) | (mantissa << 13));
+    }
+    return BitsToFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+
+void FloatToHalf(const float *source, uint16_t *destination, size_t count)
+{
+    size_t i = 0;
+#if defined(LUMIERE_ENABLE_F16C)
+    for (; i + 8 <= count; i += 8) {
+        const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), half);
+    }
+#endif
+    for (; i < count; ++ i) {
+        destination[i] = FloatToHalf(source[i]);
+    }
+}
+
+
+void HalfToFloat(const uint16_t *source, float *destination, size_t count)
+{
+    size_t i = 0;
+#if defined(LUMIERE_ENABLE_F16C)
+    for (; i + 8 <= count; i += 8) {
+        const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm256_storeu_ps(destination + i, _mm256_cvtph_ps(half));
+    }
+#endif
+    for (; i < count; ++ i) {
+        destination[i] = HalfToFloat(source[i]);
+    }
+}
+
+
+uint32_t PackR11G11B10F(const float *rgb)
+{
+    return PackUnsignedFloat(rgb[0], 6) | (PackUnsignedFloat(rgb[1], 6) << 11) | (PackUnsignedFloat(rgb[2], 5) << 22);
+}
+
+
+void UnpackR11G11B10F(uint32_t value, float *rgb)
+{
+    rgb[0] = UnpackUnsignedFloat(value & 0x7ffu, 6);
+    rgb[1] = UnpackUnsignedFloat((value >> 11) & 0x7ffu, 6);
+    rgb[2] = UnpackUnsignedFloat(value >> 22, 5);
+}
+
+
+uint32_t PackRGB9E5(const float *rgb)
+{
+    // EXT_texture_shared_exponent: 9 bit mantissas without implicit one, exponent bias 15
+    constexpr int MantissaBits = 9;
+    constexpr int ExponentBias = 15;
+    constexpr float MaxValue = 65408.0f;
+    const float red = ClampNonNegative(rgb[0], MaxValue);
+    const float green = ClampNonNegative(rgb[1], MaxValue);
+    const float blue = ClampNonNegative(rgb[2], MaxValue);
+    const float maxComponent = std::max(red, std::max(green, blue));
+
+    int exponent = 0;
+    std::frexp(maxComponent, &exponent);
+    int sharedExponent = std::max(-ExponentBias - 1, exponent - 1) + 1 + ExponentBias;
+    if (std::floor(std::ldexp(maxComponent, ExponentBias + MantissaBits - sharedExponent) + 0.5f) == static_cast<float>(1 << MantissaBits)) {
+        sharedExponent += 1;
+    }
+
+    const int scaleExponent = ExponentBias + MantissaBits - sharedExponent;
+    const auto redMantissa = static_cast<uint32_t>(std::floor(std::ldexp(red, scaleExponent) + 0.5f));
+    const auto greenMantissa = static_cast<uint32_t>(std::floor(std::ldexp(green, scaleExponent) + 0.5f));
+    const auto blueMantissa = static_cast<uint32_t>(std::floor(std::ldexp(blue, scaleExponent) + 0.5f));
+    return redMantissa | (greenMantissa << 9) | (blueMantissa << 18) | (static_cast<uint32_t>(sharedExponent) << 27);
+}
+
+
+void UnpackRGB9E5(uint32_t value, float *rgb)
+{
+    const int scaleExponent = static_cast<int>(value >> 27) - 15 - 9;
+    rgb[0] = std::ldexp(static_cast<float>(value & 0x1ffu), scaleExponent);
+    rgb[1] = std::ldexp(static_cast<float>((value >> 9) & 0x1ffu), scaleExponent);
+    rgb[2] = std::ldexp(static_cast<float>((value >> 18) & 0x1ffu), scaleExponent);
+}
+
+
+void PackRGBE8(const float *rgb, uint8_t *rgbe)
+{
+    const float maxValue = std::numeric_limits<float>::max();
+    const float red = ClampNonNegative(rgb[0], maxValue);
+    const float green = ClampNonNegative(rgb[1], maxValue);
+    const float blue = ClampNonNegative(rgb[2], maxValue);
+    const float maxComponent = std::max(red, std::max(green, blue));
+    if (maxComponent < 1e-32f) {
+        rgbe[0] = rgbe[1] = rgbe[2] = rgbe[3] = 0;
+        return;
+    }
+
+    int exponent = 0;
+    const float scale = std::frexp(maxComponent, &exponent) * 256.0f / maxComponent;
+    rgbe[0] = static_cast<uint8_t>(red * scale);
+    rgbe[1] = static_cast<uint8_t>(green * scale);
+    rgbe[2] = static_cast<uint8_t>(blue * scale);
+    rgbe[3] = static_cast<uint8_t>(std::min(exponent + 128, 255));
+}
+
+
+void UnpackRGBE8(const uint8_t *rgbe, float *rgb)
+{
+    if (rgbe[3] == 0) {
+        rgb[0] = rgb[1] = rgb[2] = 0.0f;
+        return;
+    }
+    const float scale = std::ldexp(1.0f, static_cast<int>(rgbe[3]) - (128 + 8));
+    rgb[0] = rgbe[0] * scale;
+    rgb[1] = rgbe[1] * scale;
+    rgb[2] = rgbe[2] * scale;
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Common/LumiereMacro.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// IEEE half floats, round to nearest even. the list versions use F16C when the build enables it,
+// the scalar versions give the same bits including NaN payloads
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+void FloatToHalf(const float *source, uint16_t *destination, size_t count);
+void HalfToFloat(const uint16_t *source, float *destination, size_t count);
+
+// packed HDR colors; negative and NaN channels become zero, values above the largest finite
+// value of a format saturate to it
+uint32_t PackR11G11B10F(const float *rgb);
+void UnpackR11G11B10F(uint32_t value, float *rgb);
+uint32_t PackRGB9E5(const float *rgb);
+void UnpackRGB9E5(uint32_t value, float *rgb);
+// Radiance RGBE with the same rounding as stb_image's HDR reader and writer
+void PackRGBE8(const float *rgb, uint8_t *rgbe);
+void UnpackRGBE8(const uint8_t *rgbe, float *rgb);
+
+END_LUMIERE_NAMESPACE
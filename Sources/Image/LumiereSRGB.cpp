@@ -0,0 +1,103 @@
+#include "LumiereSRGB.h"
+#include <cmath>
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr int EncodeBucketCount = 4096;
+
+double DecodeSRGB(double value)
+{
+    return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+}
+
+
+struct SRGBTables {
+    SRGBTables()
+    {
+        for (int i = 0; i < 256; ++ i) {
+            decodeTable[i] = static_cast<float>(DecodeSRGB(i / 255.0));
+        }
+        // a linear value rounds up to code n + 1 once it reaches the midpoint between n and n + 1
+        for (int i = 0; i < 255; ++ i) {
+            thresholdTable[i] = static_cast<float>(DecodeSRGB((i + 0.5) / 255.0));
+        }
+        int code = 0;
+        for (int i = 0; i < EncodeBucketCount; ++ i) {
+            const float bucketBegin = static_cast<float>(i) / EncodeBucketCount;
+            while (code < 255 && thresholdTable[code] <= bucketBegin) {
+                ++ code;
+            }
+            bucketCodeTable[i] = static_cast<uint8_t>(code);
+        }
+    }
+
+    float decodeTable[256];
+    float thresholdTable[255];
+    uint8_t bucketCodeTable[EncodeBucketCount];
+};
+
+
+const SRGBTables& GetSRGBTables()
+{
+    static const SRGBTables tables;
+    return tables;
+}
+
+
+uint8_t EncodeSRGB(const SRGBTables& tables, float value)
+{
+    // also maps NaN to zero
+    if (!(value > 0.0f)) {
+        return 0;
+    }
+    if (value >= 1.0f) {
+        return 255;
+    }
+    int code = tables.bucketCodeTable[static_cast<int>(value * EncodeBucketCount)];
+    while (code < 255 && value >= tables.thresholdTable[code]) {
+        ++ code;
+    }
+    return static_cast<uint8_t>(code);
+}
+
+} // namespace
+
+
+const float* GetSRGBToLinearTable()
+{
+    return GetSRGBTables().decodeTable;
+}
+
+
+float SRGBToLinear(uint8_t value)
+{
+    return GetSRGBTables().decodeTable[value];
+}
+
+
+uint8_t LinearToSRGB(float value)
+{
+    return EncodeSRGB(GetSRGBTables(), value);
+}
+
+
+void SRGBToLinear(const uint8_t *source, float *destination, size_t count)
+{
+    const float *decodeTable = GetSRGBTables().decodeTable;
+    for (size_t i = 0; i < count; ++ i) {
+        destination[i] = decodeTable[source[i]];
+    }
+}
+
+
+void LinearToSRGB(const float *source, uint8_t *destination, size_t count)
+{
+    const SRGBTables& tables = GetSRGBTables();
+    for (size_t i = 0; i < count; ++ i) {
+        destination[i] = EncodeSRGB(tables, source[i]);
+    }
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Common/LumiereMacro.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// 8-bit sRGB <-> linear float through lookup tables. decoding is a single table read; encoding
+// starts from a coarse table and then steps over the linear thresholds where each code rounds
+// up, so no pow() is evaluated per pixel
+const float* GetSRGBToLinearTable();
+float SRGBToLinear(uint8_t value);
+uint8_t LinearToSRGB(float value);
+void SRGBToLinear(const uint8_t *source, float *destination, size_t count);
+void LinearToSRGB(const float *source, uint8_t *destination, size_t count);
+
+END_LUMIERE_NAMESPACE
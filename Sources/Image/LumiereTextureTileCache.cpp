@@ -0,0 +1,235 @@
+#include "LumiereTextureTileCache.h"
+#include "LumiereImage.h"
+#include "Common/LumiereAssert.h"
+#include "Exception/LumiereException.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+TextureTileCache::TextureTileCache(size_t memoryBudget, size_t shardCount)
+    : mMemoryBudget(memoryBudget)
+    , mShardMemoryBudget(0)
+    , mShardList()
+    , mShardCount(shardCount)
+    , mFileMutex()
+    , mFileList()
+    , mFileIdMap()
+{
+    LUMIERE_EXPECT(memoryBudget > 0);
+    LUMIERE_EXPECT(shardCount > 0);
+    mShardMemoryBudget = (mMemoryBudget + mShardCount - 1) / mShardCount;
+    mShardList = std::make_unique<Shard[]>(mShardCount);
+    LUMIERE_ENSURE(mShardMemoryBudget > 0);
+}
+
+
+TextureTileCache::FileId TextureTileCache::registerFile(const std::string& filePath, size_t tileByteSize, TileLoader&& tileLoader)
+{
+    LUMIERE_EXPECT(!filePath.empty());
+    LUMIERE_EXPECT(tileByteSize > 0);
+    LUMIERE_EXPECT(tileLoader);
+
+    std::lock_guard<std::mutex> lock(mFileMutex);
+    auto iter = mFileIdMap.find(filePath);
+    if (iter != mFileIdMap.end()) {
+        return iter->second;
+    }
+    if (mFileList.size() >= MaxFileCount) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::InvalidState,
+                "fail to register file [{}] because texture tile cache holds too many files [{}]", filePath, mFileList.size());
+    }
+
+    const auto fileId = static_cast<FileId>(mFileList.size());
+    auto file = std::make_unique<File>();
+    file->path = filePath;
+    file->tileByteSize = tileByteSize;
+    file->tileLoader = std::move(tileLoader);
+    mFileList.push_back(std::move(file));
+    mFileIdMap.emplace(filePath, fileId);
+    return fileId;
+}
+
+
+bool TextureTileCache::findFile(const std::string& filePath, FileId& fileId) const
+{
+    std::lock_guard<std::mutex> lock(mFileMutex);
+    auto iter = mFileIdMap.find(filePath);
+    if (iter == mFileIdMap.end()) {
+        return false;
+    }
+    fileId = iter->second;
+    return true;
+}
+
+
+TextureTileCache::TileData TextureTileCache::getTile(FileId fileId, uint32_t mipLevel, uint32_t tileX, uint32_t tileY)
+{
+    const uint64_t key = makeKey(fileId, mipLevel, tileX, tileY);
+    Shard& shard = getShard(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto iter = shard.slotMap.find(key);
+        if (iter != shard.slotMap.end()) {
+            Slot& slot = shard.slotList[iter->second];
+            slot.isReferenced = true;
+            shard.hitCount += 1;
+            return slot.data;
+        }
+        shard.missCount += 1;
+    }
+
+    // the tile is loaded without holding the shard lock; if another thread loads the same
+    // tile meanwhile, the copy that reaches the cache first is kept. a load that overlaps
+    // invalidateFile() still returns its tile but does not cache it
+    const File& file = getFile(fileId);
+    const uint64_t generation = file.generation.load();
+    auto data = Image::allocateData(file.tileByteSize);
+    file.tileLoader(mipLevel, tileX, tileY, data.get());
+    auto deleter = data.get_deleter();
+    TileData tileData(data.release(), std::move(deleter));
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.slotMap.find(key);
+    if (iter != shard.slotMap.end()) {
+        return shard.slotList[iter->second].data;
+    }
+    if (generation != file.generation.load()) {
+        return tileData;
+    }
+
+    evict(shard, file.tileByteSize);
+    uint32_t slotIndex = 0;
+    if (!shard.freeSlotList.empty()) {
+        slotIndex = shard.freeSlotList.back();
+        shard.freeSlotList.pop_back();
+    } else {
+        slotIndex = static_cast<uint32_t>(shard.slotList.size());
+        shard.slotList.emplace_back();
+    }
+    shard.slotList[slotIndex] = Slot{key, tileData, file.tileByteSize, true};
+    shard.slotMap.emplace(key, slotIndex);
+    shard.residentByteSize += file.tileByteSize;
+    return tileData;
+}
+
+
+void TextureTileCache::invalidateFile(FileId fileId)
+{
+    // the generation changes before the sweep, so a load either sees it and skips the cache or
+    // inserts its tile before the sweep reaches that shard
+    getFile(fileId).generation.fetch_add(1);
+    for (size_t i = 0; i < mShardCount; ++ i) {
+        Shard& shard = mShardList[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (uint32_t slotIndex = 0; slotIndex < shard.slotList.size(); ++ slotIndex) {
+            const Slot& slot = shard.slotList[slotIndex];
+            if (slot.data && static_cast<FileId>(slot.key >> 40) == fileId) {
+                releaseSlot(shard, slotIndex);
+            }
+        }
+    }
+}
+
+
+void TextureTileCache::clear()
+{
+    for (size_t i = 0; i < mShardCount; ++ i) {
+        Shard& shard = mShardList[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.slotMap.clear();
+        shard.slotList.clear();
+        shard.freeSlotList.clear();
+        shard.clockHand = 0;
+        shard.residentByteSize = 0;
+    }
+}
+
+
+size_t TextureTileCache::getMemoryBudget() const
+{
+    return mMemoryBudget;
+}
+
+
+TextureTileCache::Statistics TextureTileCache::getStatistics() const
+{
+    Statistics statistics;
+    for (size_t i = 0; i < mShardCount; ++ i) {
+        Shard& shard = mShardList[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        statistics.hitCount += shard.hitCount;
+        statistics.missCount += shard.missCount;
+        statistics.evictionCount += shard.evictionCount;
+        statistics.residentByteSize += shard.residentByteSize;
+        statistics.residentTileCount += shard.slotMap.size();
+    }
+    return statistics;
+}
+
+
+uint64_t TextureTileCache::makeKey(FileId fileId, uint32_t mipLevel, uint32_t tileX, uint32_t tileY)
+{
+    LUMIERE_EXPECT(fileId < MaxFileCount);
+    LUMIERE_EXPECT(mipLevel < MaxMipLevelCount);
+    LUMIERE_EXPECT(tileX < MaxTileCoordinate && tileY < MaxTileCoordinate);
+    return (static_cast<uint64_t>(fileId) << 40) | (static_cast<uint64_t>(mipLevel) << 32) | (static_cast<uint64_t>(tileY) << 16) | tileX;
+}
+
+
+TextureTileCache::Shard& TextureTileCache::getShard(uint64_t key)
+{
+    // neighbouring tiles differ only in the low bits, mix them so they spread over the shards
+    uint64_t hash = key;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return mShardList[hash % mShardCount];
+}
+
+
+const TextureTileCache::File& TextureTileCache::getFile(FileId fileId) const
+{
+    std::lock_guard<std::mutex> lock(mFileMutex);
+    if (fileId >= mFileList.size()) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::InvalidParams,
+                "fail to find file [{}] in texture tile cache", fileId);
+    }
+    return *mFileList[fileId];
+}
+
+
+void TextureTileCache::evict(Shard& shard, size_t requiredByteSize)
+{
+    // CLOCK: a tile touched since the hand last passed it gets a second chance
+    const size_t slotCount = shard.slotList.size();
+    size_t visitedSlotCount = 0;
+    while (shard.residentByteSize + requiredByteSize > mShardMemoryBudget && !shard.slotMap.empty() && visitedSlotCount < 2 * slotCount) {
+        const uint32_t slotIndex = shard.clockHand;
+        shard.clockHand = static_cast<uint32_t>((shard.clockHand + 1) % slotCount);
+        visitedSlotCount += 1;
+
+        Slot& slot = shard.slotList[slotIndex];
+        if (!slot.data) {
+            continue;
+        }
+        if (slot.isReferenced) {
+            slot.isReferenced = false;
+            continue;
+        }
+        releaseSlot(shard, slotIndex);
+        shard.evictionCount += 1;
+    }
+}
+
+
+void TextureTileCache::releaseSlot(Shard& shard, uint32_t slotIndex)
+{
+    Slot& slot = shard.slotList[slotIndex];
+    LUMIERE_EXPECT(slot.data);
+    shard.slotMap.erase(slot.key);
+    shard.residentByteSize -= slot.byteSize;
+    slot.data.reset();
+    slot.byteSize = 0;
+    shard.freeSlotList.push_back(slotIndex);
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Common/LumiereMacro.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// tiles of every registered file share one memory budget. the cache is split into shards, each
+// with its own lock, hash map and CLOCK hand, so concurrent lookups rarely contend. handed out
+// tiles are reference counted and stay valid after eviction until the last holder drops them
+class TextureTileCache {
+public:
+    using FileId = uint32_t;
+    using TileData = std::shared_ptr<const uint8_t>;
+    // fills the tileByteSize bytes of tile (tileX, tileY) in mip level mipLevel at tileData
+    using TileLoader = std::function<void(uint32_t mipLevel, uint32_t tileX, uint32_t tileY, uint8_t *tileData)>;
+
+    struct Statistics {
+        size_t hitCount = 0;
+        size_t missCount = 0;
+        size_t evictionCount = 0;
+        size_t residentByteSize = 0;
+        size_t residentTileCount = 0;
+    };
+
+    static constexpr FileId MaxFileCount = (1u << 24) - 1;
+    static constexpr uint32_t MaxMipLevelCount = 256;
+    static constexpr uint32_t MaxTileCoordinate = 1u << 16;
+
+public:
+    explicit TextureTileCache(size_t memoryBudget, size_t shardCount = 16);
+    ~TextureTileCache() = default;
+    TextureTileCache(const TextureTileCache&) = delete;
+    TextureTileCache& operator=(const TextureTileCache&) = delete;
+
+    FileId registerFile(const std::string& filePath, size_t tileByteSize, TileLoader&& tileLoader);
+    bool findFile(const std::string& filePath, FileId& fileId) const;
+    TileData getTile(FileId fileId, uint32_t mipLevel, uint32_t tileX, uint32_t tileY) noexcept(false);
+    void invalidateFile(FileId fileId) noexcept(false);
+    void clear();
+    size_t getMemoryBudget() const;
+    Statistics getStatistics() const;
+
+private:
+    struct File {
+        std::string path;
+        size_t tileByteSize;
+        TileLoader tileLoader;
+        // bumped by invalidateFile() so that loads started before it are not cached
+        mutable std::atomic<uint64_t> generation{0};
+    };
+
+    struct Slot {
+        uint64_t key;
+        TileData data;
+        size_t byteSize;
+        bool isReferenced;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, uint32_t> slotMap;
+        std::vector<Slot> slotList;
+        std::vector<uint32_t> freeSlotList;
+        uint32_t clockHand = 0;
+        size_t residentByteSize = 0;
+        size_t hitCount = 0;
+        size_t missCount = 0;
+        size_t evictionCount = 0;
+    };
+
+private:
+    static uint64_t makeKey(FileId fileId, uint32_t mipLevel, uint32_t tileX, uint32_t tileY);
+    Shard& getShard(uint64_t key);
+    const File& getFile(FileId fileId) const;
+    void evict(Shard& shard, size_t requiredByteSize);
+    void releaseSlot(Shard& shard, uint32_t slotIndex);
+
+private:
+    size_t mMemoryBudget;
+    size_t mShardMemoryBudget;
+    std::unique_ptr<Shard[]> mShardList;
+    size_t mShardCount;
+    mutable std::mutex mFileMutex;
+    std::vector<std::unique_ptr<File>> mFileList;
+    std::unordered_map<std::string, FileId> mFileIdMap;
+};
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,237 @@
+#include "LumiereTiledImage.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "Common/LumiereAssert.h"
+#include "Exception/LumiereException.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr uint32_t TiledImageMagicNumber = 0x4c49544c;
+constexpr uint32_t TiledImageVersion = 1;
+
+struct TiledImageHeader {
+    uint32_t magicNumber;
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t tileSize;
+};
+
+
+// padding pixels repeat the last row and column of the image so that filters reading
+// across the edge of a tile see clamped texels
+void CopyTileFromImage(const Image& image, uint32_t tileSize, uint32_t tileX, uint32_t tileY, uint8_t *tileData)
+{
+    const size_t pixelSize = Image::getSizeOfImageFormat(image.getFormat());
+    const uint32_t beginX = tileX * tileSize;
+    const uint32_t beginY = tileY * tileSize;
+    const uint32_t validWidth = std::min(tileSize, image.getWidth() - beginX);
+    const uint32_t validHeight = std::min(tileSize, image.getHeight() - beginY);
+    const uint8_t *imageData = image.getData();
+
+    for (uint32_t y = 0; y < tileSize; ++ y) {
+        const uint32_t sourceY = beginY + std::min(y, validHeight - 1);
+        const uint8_t *sourceRow = imageData + (static_cast<size_t>(sourceY) * image.getWidth() + beginX) * pixelSize;
+        uint8_t *tileRow = tileData + static_cast<size_t>(y) * tileSize * pixelSize;
+        std::memcpy(tileRow, sourceRow, validWidth * pixelSize);
+        for (uint32_t x = validWidth; x < tileSize; ++ x) {
+            std::memcpy(tileRow + x * pixelSize, tileRow + (validWidth - 1) * pixelSize, pixelSize);
+        }
+    }
+}
+
+} // namespace
+
+
+void TiledImage::writeTiledData(const Image& image, DataStream& dataStream, uint32_t tileSize)
+{
+    LUMIERE_EXPECT(tileSize > 0);
+    if (!dataStream.isWriteable()) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::InvalidParams,
+                "fail to write tiled image [{}] because data stream [{}] is not writeable", image.getName(), dataStream.getName());
+    }
+
+    const TiledImageHeader header = {TiledImageMagicNumber, TiledImageVersion, image.getFormat()._to_integral(),
+                                     image.getWidth(), image.getHeight(), tileSize};
+    dataStream.write(&header, sizeof(header));
+
+    const uint32_t tileCountX = (image.getWidth() + tileSize - 1) / tileSize;
+    const uint32_t tileCountY = (image.getHeight() + tileSize - 1) / tileSize;
+    const size_t tileByteSize = Image::getSizeOfImageFormat(image.getFormat()) * tileSize * tileSize;
+    auto tileData = Image::allocateData(tileByteSize);
+    for (uint32_t tileY = 0; tileY < tileCountY; ++ tileY) {
+        for (uint32_t tileX = 0; tileX < tileCountX; ++ tileX) {
+            CopyTileFromImage(image, tileSize, tileX, tileY, tileData.get());
+            if (dataStream.write(tileData.get(), tileByteSize) != tileByteSize) {
+                LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::FileSystemError,
+                        "fail to write tile [{}, {}] of tiled image [{}] into data stream [{}]", tileX, tileY, image.getName(), dataStream.getName());
+            }
+        }
+    }
+}
+
+
+TiledImage TiledImage::readTiledData(const std::shared_ptr<DataStream>& dataStream)
+{
+    LUMIERE_EXPECT(dataStream);
+    TiledImageHeader header = {};
+    if (!dataStream->isReadable() || dataStream->read(&header, sizeof(header)) != sizeof(header)) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::ImageLoadError,
+                "fail to read tiled image header from data stream [{}]", dataStream->getName());
+    }
+    // the format is stored as 32 bits, values that do not fit into the enum must not wrap onto a valid one
+    const bool isValidFormat = header.format <= std::numeric_limits<uint8_t>::max() &&
+                               ImageFormat::_is_valid(static_cast<uint8_t>(header.format));
+    if (header.magicNumber != TiledImageMagicNumber || header.version != TiledImageVersion ||
+        !isValidFormat || header.width == 0 || header.height == 0 || header.tileSize == 0) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::ImageLoadError,
+                "fail to read tiled image from data stream [{}] because its header is invalid", dataStream->getName());
+    }
+
+    // tiles are read on first touch from whichever thread touches them, so the stream is shared
+    // behind a mutex; tile offsets are relative to the end of the header to allow embedded data
+    const ImageFormat format = ImageFormat::_from_integral(static_cast<uint8_t>(header.format));
+    const uint32_t tileCountX = (header.width + header.tileSize - 1) / header.tileSize;
+    const size_t tileByteSize = Image::getSizeOfImageFormat(format) * header.tileSize * header.tileSize;
+    const size_t firstTileOffset = dataStream->tell();
+    auto streamMutex = std::make_shared<std::mutex>();
+    TileLoader tileLoader = [dataStream, streamMutex, tileCountX, tileByteSize, firstTileOffset](uint32_t tileX, uint32_t tileY, uint8_t *tileData) {
+        const size_t tileIndex = static_cast<size_t>(tileY) * tileCountX + tileX;
+        std::lock_guard<std::mutex> lock(*streamMutex);
+        dataStream->seek(firstTileOffset + tileIndex * tileByteSize);
+        if (dataStream->read(tileData, tileByteSize) != tileByteSize) {
+            LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::ImageLoadError,
+                    "fail to read tile [{}, {}] from data stream [{}]", tileX, tileY, dataStream->getName());
+        }
+    };
+    return TiledImage(dataStream->getName(), format, static_cast<int>(header.width), static_cast<int>(header.height),
+                      header.tileSize, std::move(tileLoader));
+}
+
+
+TiledImage TiledImage::createFromImage(const std::shared_ptr<const Image>& image, uint32_t tileSize)
+{
+    LUMIERE_EXPECT(image);
+    TileLoader tileLoader = [image, tileSize](uint32_t tileX, uint32_t tileY, uint8_t *tileData) {
+        CopyTileFromImage(*image, tileSize, tileX, tileY, tileData);
+    };
+    return TiledImage(image->getName(), image->getFormat(), static_cast<int>(image->getWidth()), static_cast<int>(image->getHeight()),
+                      tileSize, std::move(tileLoader));
+}
+
+
+TiledImage::TiledImage(const std::string& name, ImageFormat format, int width, int height, uint32_t tileSize, TileLoader&& tileLoader)
+    : mName(name)
+    , mWidth(width)
+    , mHeight(height)
+    , mFormat(format)
+    , mTileSize(tileSize)
+    , mTileCountX(0)
+    , mTileCountY(0)
+    , mTileLoader(std::move(tileLoader))
+    , mTileSlotList()
+{
+    LUMIERE_EXPECT(width > 0 && height > 0);
+    LUMIERE_EXPECT(tileSize > 0);
+    LUMIERE_EXPECT(mTileLoader);
+
+    mTileCountX = (static_cast<uint32_t>(mWidth) + mTileSize - 1) / mTileSize;
+    mTileCountY = (static_cast<uint32_t>(mHeight) + mTileSize - 1) / mTileSize;
+    mTileSlotList = std::make_unique<TileSlot[]>(static_cast<size_t>(mTileCountX) * mTileCountY);
+    LUMIERE_ENSURE(mTileCountX > 0 && mTileCountY > 0);
+}
+
+
+const std::string& TiledImage::getName() const
+{
+    return mName;
+}
+
+
+uint32_t TiledImage::getWidth() const
+{
+    return static_cast<uint32_t>(mWidth);
+}
+
+
+uint32_t TiledImage::getHeight() const
+{
+    return static_cast<uint32_t>(mHeight);
+}
+
+
+ImageFormat TiledImage::getFormat() const
+{
+    return mFormat;
+}
+
+
+uint32_t TiledImage::getTileSize() const
+{
+    return mTileSize;
+}
+
+
+uint32_t TiledImage::getTileCountX() const
+{
+    return mTileCountX;
+}
+
+
+uint32_t TiledImage::getTileCountY() const
+{
+    return mTileCountY;
+}
+
+
+size_t TiledImage::getTileByteSize() const
+{
+    return Image::getSizeOfImageFormat(mFormat) * mTileSize * mTileSize;
+}
+
+
+const uint8_t* TiledImage::getTileData(uint32_t tileX, uint32_t tileY) const
+{
+    LUMIERE_EXPECT(tileX < mTileCountX && tileY < mTileCountY);
+    TileSlot& tileSlot = mTileSlotList[static_cast<size_t>(tileY) * mTileCountX + tileX];
+
+    // a throwing loader leaves the flag unset, so the next access retries the tile
+    std::call_once(tileSlot.loadFlag, [this, &tileSlot, tileX, tileY]() {
+        auto data = Image::allocateData(getTileByteSize());
+        mTileLoader(tileX, tileY, data.get());
+        tileSlot.data = std::move(data);
+        tileSlot.isLoaded.store(true, std::memory_order_release);
+    });
+    return tileSlot.data.get();
+}
+
+
+bool TiledImage::isTileLoaded(uint32_t tileX, uint32_t tileY) const
+{
+    LUMIERE_EXPECT(tileX < mTileCountX && tileY < mTileCountY);
+    return mTileSlotList[static_cast<size_t>(tileY) * mTileCountX + tileX].isLoaded.load(std::memory_order_acquire);
+}
+
+
+size_t TiledImage::getLoadedTileCount() const
+{
+    const size_t tileCount = static_cast<size_t>(mTileCountX) * mTileCountY;
+    size_t loadedTileCount = 0;
+    for (size_t i = 0; i < tileCount; ++ i) {
+        loadedTileCount += mTileSlotList[i].isLoaded.load(std::memory_order_relaxed) ? 1 : 0;
+    }
+    return loadedTileCount;
+}
+
+
+void TiledImage::unloadAllTiles()
+{
+    // must not race with getTileData(), a once_flag can not be reset in place
+    mTileSlotList = std::make_unique<TileSlot[]>(static_cast<size_t>(mTileCountX) * mTileCountY);
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "LumiereImage.h"
+#include "Streaming/LumiereDataStream.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// pixels are split into square tiles and every tile is stored contiguously with a row pitch of
+// tileSize pixels; edge tiles are padded to the full tile size so that all tiles share one layout.
+// a tile is only produced by the loader the first time it is touched
+class TiledImage {
+public:
+    static constexpr uint32_t DefaultTileSize = 64;
+
+    // fills the whole tile (tileSize * tileSize pixels, padding included) at tileData
+    using TileLoader = std::function<void(uint32_t tileX, uint32_t tileY, uint8_t *tileData)>;
+
+    static void writeTiledData(const Image& image, DataStream& dataStream, uint32_t tileSize = DefaultTileSize) noexcept(false);
+    static TiledImage readTiledData(const std::shared_ptr<DataStream>& dataStream) noexcept(false);
+    static TiledImage createFromImage(const std::shared_ptr<const Image>& image, uint32_t tileSize = DefaultTileSize);
+
+public:
+    TiledImage(const std::string& name, ImageFormat format, int width, int height, uint32_t tileSize, TileLoader&& tileLoader);
+    ~TiledImage() = default;
+    TiledImage(TiledImage&& tiledImage) noexcept = default;
+    TiledImage(const TiledImage&) = delete;
+    TiledImage& operator=(const TiledImage&) = delete;
+
+    const std::string& getName() const;
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    ImageFormat getFormat() const;
+    uint32_t getTileSize() const;
+    uint32_t getTileCountX() const;
+    uint32_t getTileCountY() const;
+    size_t getTileByteSize() const;
+    const uint8_t* getTileData(uint32_t tileX, uint32_t tileY) const noexcept(false);
+    template <typename T = uint8_t> const T* getPixel(uint32_t x, uint32_t y) const noexcept(false);
+    bool isTileLoaded(uint32_t tileX, uint32_t tileY) const;
+    size_t getLoadedTileCount() const;
+    void unloadAllTiles();
+
+private:
+    struct TileSlot {
+        std::once_flag loadFlag;
+        std::atomic<bool> isLoaded{false};
+        Image::DataPointer data;
+    };
+
+private:
+    std::string mName;
+    int mWidth;
+    int mHeight;
+    ImageFormat mFormat;
+    uint32_t mTileSize;
+    uint32_t mTileCountX;
+    uint32_t mTileCountY;
+    TileLoader mTileLoader;
+    std::unique_ptr<TileSlot[]> mTileSlotList;
+};
+
+
+template <typename T>
+const T* TiledImage::getPixel(uint32_t x, uint32_t y) const
+{
+    const uint8_t *tileData = getTileData(x / mTileSize, y / mTileSize);
+    const size_t pixelOffset = static_cast<size_t>(y % mTileSize) * mTileSize + x % mTileSize;
+    return reinterpret_cast<const T*>(tileData + pixelOffset * Image::getSizeOfImageFormat(mFormat));
+}
+
+END_LUMIERE_NAMESPACE
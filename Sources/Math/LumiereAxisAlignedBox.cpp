@@ -22,6 +22,18 @@ const Vector3f& AxisAlignedBox::getMaximum() const
 }
 
 
+Point3f AxisAlignedBox::getCenter() const
+{
+    return Point3f((mMinimum + mMaximum) * Float(0.5));
+}
+
+
+Vector3f AxisAlignedBox::getHalfSize() const
+{
+    return (mMaximum - mMinimum) * Float(0.5);
+}
+
+
 Point3f AxisAlignedBox::getCornerVertex(AxisAlignedBoxCornerIndex cornerIndex) const
 {
     switch (cornerIndex) {
@@ -21,6 +21,8 @@ public:
     AxisAlignedBox(const Vector3f& minimum, const Vector3f& maximum);
     const Vector3f& getMinimum() const;
     const Vector3f& getMaximum() const;
+    Point3f getCenter() const;
+    Vector3f getHalfSize() const;
     Point3f getCornerVertex(AxisAlignedBoxCornerIndex cornerIndex) const;
 
 private:
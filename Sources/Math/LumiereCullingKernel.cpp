@@ -0,0 +1,140 @@
+#include "LumiereCullingKernel.h"
+#include <cmath>
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+CullingPlaneSet::CullingPlaneSet(const Plane *planeList, size_t planeCount) : mPlaneCount(planeCount)
+{
+    LUMIERE_EXPECT(planeList);
+    LUMIERE_EXPECT(planeCount > 0 && planeCount <= MaxPlaneCount);
+
+    for (size_t i = 0; i < planeCount; ++ i) {
+        const Normal3f normal = planeList[i].getNormal();
+        auto& plane = mPlaneList[i];
+        plane.normal[0] = static_cast<float>(normal.x);
+        plane.normal[1] = static_cast<float>(normal.y);
+        plane.normal[2] = static_cast<float>(normal.z);
+        plane.absNormal[0] = std::abs(plane.normal[0]);
+        plane.absNormal[1] = std::abs(plane.normal[1]);
+        plane.absNormal[2] = std::abs(plane.normal[2]);
+        plane.distance = static_cast<float>(planeList[i].getDistance());
+    }
+    LUMIERE_ENSURE(mPlaneCount == planeCount);
+}
+
+
+size_t CullingPlaneSet::getPlaneCount() const
+{
+    return mPlaneCount;
+}
+
+
+const CullingPlaneSet::CullingPlane& CullingPlaneSet::getPlane(size_t index) const
+{
+    LUMIERE_EXPECT(index < mPlaneCount);
+    return mPlaneList[index];
+}
+
+
+void AxisAlignedBoxBlock::load(const AxisAlignedBox *boxList, size_t boxCount)
+{
+    LUMIERE_EXPECT(boxList);
+    LUMIERE_EXPECT(boxCount > 0 && boxCount <= Size);
+
+    for (size_t i = 0; i < boxCount; ++ i) {
+        const Vector3f& minimum = boxList[i].getMinimum();
+        const Vector3f& maximum = boxList[i].getMaximum();
+        centerX[i] = static_cast<float>((minimum.x + maximum.x) * 0.5);
+        centerY[i] = static_cast<float>((minimum.y + maximum.y) * 0.5);
+        centerZ[i] = static_cast<float>((minimum.z + maximum.z) * 0.5);
+        halfSizeX[i] = static_cast<float>((maximum.x - minimum.x) * 0.5);
+        halfSizeY[i] = static_cast<float>((maximum.y - minimum.y) * 0.5);
+        halfSizeZ[i] = static_cast<float>((maximum.z - minimum.z) * 0.5);
+    }
+
+    for (size_t i = boxCount; i < Size; ++ i) {
+        centerX[i] = centerY[i] = centerZ[i] = 0.0f;
+        halfSizeX[i] = halfSizeY[i] = halfSizeZ[i] = 0.0f;
+    }
+}
+
+
+// The signed distance of the p-vertex (the corner furthest along the plane normal) is
+// dot(n, center) + dot(|n|, halfSize); the box is fully outside when it is negative.
+uint32_t CullAxisAlignedBoxBlock(const CullingPlaneSet& planeSet, const AxisAlignedBoxBlock& block)
+{
+    const size_t planeCount = planeSet.getPlaneCount();
+
+#if defined(LUMIERE_ENABLE_AVX)
+    const __m256 centerX = _mm256_load_ps(block.centerX);
+    const __m256 centerY = _mm256_load_ps(block.centerY);
+    const __m256 centerZ = _mm256_load_ps(block.centerZ);
+    const __m256 halfSizeX = _mm256_load_ps(block.halfSizeX);
+    const __m256 halfSizeY = _mm256_load_ps(block.halfSizeY);
+    const __m256 halfSizeZ = _mm256_load_ps(block.halfSizeZ);
+    const __m256 zero = _mm256_setzero_ps();
+
+    __m256 visible = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+    for (size_t i = 0; i < planeCount; ++ i) {
+        const auto& plane = planeSet.getPlane(i);
+        __m256 distance = _mm256_set1_ps(plane.distance);
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal[0]), centerX));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal[1]), centerY));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normal[2]), centerZ));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.absNormal[0]), halfSizeX));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.absNormal[1]), halfSizeY));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.absNormal[2]), halfSizeZ));
+        visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+    }
+    return static_cast<uint32_t>(_mm256_movemask_ps(visible));
+#elif defined(LUMIERE_ENABLE_SSE)
+    static_assert(AxisAlignedBoxBlock::Size % 4 == 0, "block size must be a multiple of the SSE width");
+
+    uint32_t visibleMask = 0;
+    for (size_t lane = 0; lane < AxisAlignedBoxBlock::Size; lane += 4) {
+        const __m128 centerX = _mm_load_ps(block.centerX + lane);
+        const __m128 centerY = _mm_load_ps(block.centerY + lane);
+        const __m128 centerZ = _mm_load_ps(block.centerZ + lane);
+        const __m128 halfSizeX = _mm_load_ps(block.halfSizeX + lane);
+        const __m128 halfSizeY = _mm_load_ps(block.halfSizeY + lane);
+        const __m128 halfSizeZ = _mm_load_ps(block.halfSizeZ + lane);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 visible = _mm_cmpeq_ps(zero, zero);
+        for (size_t i = 0; i < planeCount; ++ i) {
+            const auto& plane = planeSet.getPlane(i);
+            __m128 distance = _mm_set1_ps(plane.distance);
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal[0]), centerX));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal[1]), centerY));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normal[2]), centerZ));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.absNormal[0]), halfSizeX));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.absNormal[1]), halfSizeY));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.absNormal[2]), halfSizeZ));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, zero));
+        }
+        visibleMask |= static_cast<uint32_t>(_mm_movemask_ps(visible)) << lane;
+    }
+    return visibleMask;
+#else
+    uint32_t visibleMask = 0;
+    for (size_t lane = 0; lane < AxisAlignedBoxBlock::Size; ++ lane) {
+        bool visible = true;
+        for (size_t i = 0; i < planeCount && visible; ++ i) {
+            const auto& plane = planeSet.getPlane(i);
+            const float distance = plane.distance +
+                                   plane.normal[0] * block.centerX[lane] +
+                                   plane.normal[1] * block.centerY[lane] +
+                                   plane.normal[2] * block.centerZ[lane] +
+                                   plane.absNormal[0] * block.halfSizeX[lane] +
+                                   plane.absNormal[1] * block.halfSizeY[lane] +
+                                   plane.absNormal[2] * block.halfSizeZ[lane];
+            visible = distance >= 0.0f;
+        }
+        visibleMask |= static_cast<uint32_t>(visible) << lane;
+    }
+    return visibleMask;
+#endif
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Common/LumiereMacro.h"
+#include "Common/LumiereSIMD.h"
+#include "Math/LumierePlane.h"
+#include "Math/LumiereAxisAlignedBox.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+class CullingPlaneSet {
+public:
+    static constexpr size_t MaxPlaneCount = 8;
+
+    struct CullingPlane {
+        float normal[3];
+        float absNormal[3];
+        float distance;
+    };
+
+public:
+    CullingPlaneSet() = default;
+    CullingPlaneSet(const Plane *planeList, size_t planeCount);
+    size_t getPlaneCount() const;
+    const CullingPlane& getPlane(size_t index) const;
+
+private:
+    CullingPlane mPlaneList[MaxPlaneCount] = {};
+    size_t mPlaneCount = 0;
+};
+
+
+// boxes are stored as center/half-size in structure-of-arrays layout so that one
+// SIMD register holds the same component of Size different boxes
+struct AxisAlignedBoxBlock {
+    static constexpr size_t Size = 8;
+
+    void load(const AxisAlignedBox *boxList, size_t boxCount);
+
+    alignas(LUMIERE_SIMD_ALIGNMENT) float centerX[Size];
+    alignas(LUMIERE_SIMD_ALIGNMENT) float centerY[Size];
+    alignas(LUMIERE_SIMD_ALIGNMENT) float centerZ[Size];
+    alignas(LUMIERE_SIMD_ALIGNMENT) float halfSizeX[Size];
+    alignas(LUMIERE_SIMD_ALIGNMENT) float halfSizeY[Size];
+    alignas(LUMIERE_SIMD_ALIGNMENT) float halfSizeZ[Size];
+};
+
+
+// returns a bit mask with bit i set when box i of the block is not fully outside any plane
+uint32_t CullAxisAlignedBoxBlock(const CullingPlaneSet& planeSet, const AxisAlignedBoxBlock& block);
+
+END_LUMIERE_NAMESPACE
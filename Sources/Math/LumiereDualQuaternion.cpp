@@ -0,0 +1,197 @@
+#include "LumiereDualQuaternion.h"
+#include <algorithm>
+#include "Common/LumiereAssert.h"
+#include "Math/LumiereSIMDFloat.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+DualQuaternion::DualQuaternion(const Quaternionf& rotation, const Vector3f& translation)
+    : real(rotation)
+    , dual(Quaternionf(translation, 0) * rotation * Float(0.5))
+{
+
+}
+
+
+DualQuaternion::DualQuaternion(const Transform& transform)
+    : DualQuaternion(Quaternionf(transform), Vector3f(transform.getMatrix()[0][3], transform.getMatrix()[1][3], transform.getMatrix()[2][3]))
+{
+
+}
+
+
+Vector3f DualQuaternion::getTranslation() const
+{
+    return 2 * (dual * Conjugate(real)).v;
+}
+
+
+Point3f DualQuaternion::transformPoint(const Point3f& point) const
+{
+    return Point3f(real.rotate(Vector3f(point)) + getTranslation());
+}
+
+
+Vector3f DualQuaternion::transformVector(const Vector3f& vector) const
+{
+    return real.rotate(vector);
+}
+
+
+Matrix4x4 DualQuaternion::toMatrix() const
+{
+    Matrix4x4 matrix = real.toMatrix();
+    const Vector3f translation = getTranslation();
+    matrix[0][3] = translation.x;
+    matrix[1][3] = translation.y;
+    matrix[2][3] = translation.z;
+    return matrix;
+}
+
+
+Transform DualQuaternion::toTransform() const
+{
+    return Transform(toMatrix());
+}
+
+
+DualQuaternion Normalize(const DualQuaternion& q)
+{
+    const Float inverseLength = 1 / Length(q.real);
+    const Quaternionf real = q.real * inverseLength;
+    const Quaternionf dual = q.dual * inverseLength;
+    // keep the dual part orthogonal to the real part so the result stays a rigid transform
+    return {real, dual - real * Dot(real, dual)};
+}
+
+
+DualQuaternion Blend(const DualQuaternion *jointList, const Float *weightList, size_t jointCount)
+{
+    LUMIERE_EXPECT(jointList && weightList && jointCount > 0);
+    DualQuaternion result(Quaternionf(Vector3f(0, 0, 0), 0), Quaternionf(Vector3f(0, 0, 0), 0));
+    for (size_t i = 0; i < jointCount; ++ i) {
+        const bool isOpposite = Dot(jointList[0].real, jointList[i].real) < 0;
+        result += jointList[i] * (isOpposite ? -weightList[i] : weightList[i]);
+    }
+    return Normalize(result);
+}
+
+
+namespace {
+
+using Lanes = SIMDFloat<Float>;
+
+struct DualQuaternionLanes {
+    Lanes component[8];
+};
+
+
+DualQuaternionLanes LoadDualQuaternionLanes(const DualQuaternion *const *dualQuaternionList, int laneCount)
+{
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float component[8][Lanes::Width];
+    for (int k = 0; k < Lanes::Width; ++ k) {
+        const DualQuaternion q = k < laneCount ? *dualQuaternionList[k] : DualQuaternion();
+        component[0][k] = q.real.v.x;
+        component[1][k] = q.real.v.y;
+        component[2][k] = q.real.v.z;
+        component[3][k] = q.real.w;
+        component[4][k] = q.dual.v.x;
+        component[5][k] = q.dual.v.y;
+        component[6][k] = q.dual.v.z;
+        component[7][k] = q.dual.w;
+    }
+    DualQuaternionLanes lanes;
+    for (int c = 0; c < 8; ++ c) {
+        lanes.component[c] = Lanes::Load(component[c]);
+    }
+    return lanes;
+}
+
+
+void StoreDualQuaternionLanes(const DualQuaternionLanes& lanes, DualQuaternion *dualQuaternionList, int laneCount)
+{
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float component[8][Lanes::Width];
+    for (int c = 0; c < 8; ++ c) {
+        lanes.component[c].store(component[c]);
+    }
+    for (int k = 0; k < laneCount; ++ k) {
+        dualQuaternionList[k] = DualQuaternion(Quaternionf(Vector3f(component[0][k], component[1][k], component[2][k]), component[3][k]),
+                                               Quaternionf(Vector3f(component[4][k], component[5][k], component[6][k]), component[7][k]));
+    }
+}
+
+
+DualQuaternionLanes Normalize(const DualQuaternionLanes& q)
+{
+    const Lanes* c = q.component;
+    const Lanes inverseLength = Lanes(Float(1)) / Sqrt(FMA(c[0], c[0], FMA(c[1], c[1], FMA(c[2], c[2], c[3] * c[3]))));
+    DualQuaternionLanes result;
+    for (int i = 0; i < 8; ++ i) {
+        result.component[i] = c[i] * inverseLength;
+    }
+    const Lanes* r = result.component;
+    const Lanes realDotDual = FMA(r[0], r[4], FMA(r[1], r[5], FMA(r[2], r[6], r[3] * r[7])));
+    for (int i = 0; i < 4; ++ i) {
+        result.component[4 + i] = result.component[4 + i] - r[i] * realDotDual;
+    }
+    return result;
+}
+
+} // namespace
+
+
+void NormalizeDualQuaternions(const DualQuaternion *dualQuaternionList, size_t count, DualQuaternion *resultList)
+{
+    LUMIERE_EXPECT((dualQuaternionList && resultList) || count == 0);
+    const DualQuaternion *sourceList[Lanes::Width];
+    for (size_t first = 0; first < count; first += Lanes::Width) {
+        const int laneCount = static_cast<int>(std::min<size_t>(Lanes::Width, count - first));
+        for (int k = 0; k < laneCount; ++ k) {
+            sourceList[k] = dualQuaternionList + first + k;
+        }
+        StoreDualQuaternionLanes(Normalize(LoadDualQuaternionLanes(sourceList, laneCount)), resultList + first, laneCount);
+    }
+}
+
+
+void BlendDualQuaternions(const DualQuaternion *jointList, const uint32_t *jointIndexList, const Float *weightList,
+                          size_t influenceCount, size_t count, DualQuaternion *resultList)
+{
+    LUMIERE_EXPECT((jointList && jointIndexList && weightList && resultList) || count == 0);
+    LUMIERE_EXPECT(influenceCount > 0);
+
+    const DualQuaternion *sourceList[Lanes::Width];
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float weight[Lanes::Width];
+    for (size_t first = 0; first < count; first += Lanes::Width) {
+        const int laneCount = static_cast<int>(std::min<size_t>(Lanes::Width, count - first));
+        auto loadInfluence = [&](size_t influence, Lanes& scale) {
+            for (int k = 0; k < Lanes::Width; ++ k) {
+                const size_t slot = (first + k) * influenceCount + influence;
+                sourceList[k] = k < laneCount ? jointList + jointIndexList[slot] : nullptr;
+                weight[k] = k < laneCount ? weightList[slot] : 0;
+            }
+            scale = Lanes::Load(weight);
+            return LoadDualQuaternionLanes(sourceList, laneCount);
+        };
+
+        Lanes scale;
+        const DualQuaternionLanes pivot = loadInfluence(0, scale);
+        DualQuaternionLanes sum;
+        for (int c = 0; c < 8; ++ c) {
+            sum.component[c] = pivot.component[c] * scale;
+        }
+        for (size_t influence = 1; influence < influenceCount; ++ influence) {
+            const DualQuaternionLanes joint = loadInfluence(influence, scale);
+            const Lanes* p = pivot.component;
+            const Lanes* j = joint.component;
+            const Lanes pivotDotJoint = FMA(p[0], j[0], FMA(p[1], j[1], FMA(p[2], j[2], p[3] * j[3])));
+            scale = Select(pivotDotJoint < Lanes(Float(0)), -scale, scale);
+            for (int c = 0; c < 8; ++ c) {
+                sum.component[c] = FMA(joint.component[c], scale, sum.component[c]);
+            }
+        }
+        StoreDualQuaternionLanes(Normalize(sum), resultList + first, laneCount);
+    }
+}
+
+END_LUMIERE_NAMESPACE
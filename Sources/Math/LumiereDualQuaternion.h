@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereQuaternion.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// rigid transform q = real + dual * e with real the rotation and dual = (translation, 0) * real / 2
+class DualQuaternion {
+public:
+    DualQuaternion() = default;
+    DualQuaternion(const Quaternionf& real, const Quaternionf& dual) : real(real), dual(dual) {}
+    DualQuaternion(const Quaternionf& rotation, const Vector3f& translation);
+    explicit DualQuaternion(const Transform& transform);
+
+    DualQuaternion& operator+=(const DualQuaternion& q) { real += q.real; dual += q.dual; return *this; }
+    DualQuaternion operator+(const DualQuaternion& q) const { return {real + q.real, dual + q.dual}; }
+    DualQuaternion operator*(Float f) const { return {real * f, dual * f}; }
+    DualQuaternion operator*(const DualQuaternion& q) const { return {real * q.real, real * q.dual + dual * q.real}; }
+
+    const Quaternionf& getRotation() const { return real; }
+    Vector3f getTranslation() const;
+    Point3f transformPoint(const Point3f& point) const;
+    Vector3f transformVector(const Vector3f& vector) const;
+    Matrix4x4 toMatrix() const;
+    Transform toTransform() const;
+
+    Quaternionf real;
+    Quaternionf dual{Vector3f(0, 0, 0), 0};
+};
+
+
+DualQuaternion Normalize(const DualQuaternion& q);
+
+// dual quaternion linear blending: every joint is flipped into the hemisphere of the first one
+DualQuaternion Blend(const DualQuaternion *jointList, const Float *weightList, size_t jointCount);
+
+void NormalizeDualQuaternions(const DualQuaternion *dualQuaternionList, size_t count, DualQuaternion *resultList);
+
+// result i blends the influenceCount joints jointIndexList[i * influenceCount + k] with weightList[i * influenceCount + k]
+void BlendDualQuaternions(const DualQuaternion *jointList, const uint32_t *jointIndexList, const Float *weightList,
+                          size_t influenceCount, size_t count, DualQuaternion *resultList);
+
+END_LUMIERE_NAMESPACE
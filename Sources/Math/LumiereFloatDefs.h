@@ -1,6 +1,9 @@
 #pragma once
 #include <limits>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include "Common/LumiereMacro.h"
 
 #if defined(LUMIERE_IS_DEVICE_CODE)
@@ -104,6 +107,26 @@ bit_cast(const From &src) noexcept
     return dst;
 }
 
+LUMIERE_HOST_DEVICE
+inline uint32_t FloatToBits(float f)
+{
+#ifdef LUMIERE_IS_DEVICE_CODE
+    return __float_as_uint(f);
+#else
+    return bit_cast<uint32_t>(f);
+#endif
+}
+
+LUMIERE_HOST_DEVICE
+inline float BitsToFloat(uint32_t ui)
+{
+#ifdef LUMIERE_IS_DEVICE_CODE
+    return __uint_as_float(ui);
+#else
+    return bit_cast<float>(ui);
+#endif
+}
+
 LUMIERE_HOST_DEVICE
 inline uint64_t FloatToBits(double f)
 {
@@ -158,6 +181,49 @@ inline float NextFloatDown(float v)
     return BitsToFloat(ui);
 }
 
+LUMIERE_HOST_DEVICE
+inline double NextFloatUp(double v)
+{
+    if (IsInf(v) && v > 0.)
+        return v;
+    if (v == -0.)
+        v = 0.;
+    uint64_t ui = FloatToBits(v);
+    if (v >= 0.)
+        ++ui;
+    else
+        --ui;
+    return BitsToFloat(ui);
+}
+
+LUMIERE_HOST_DEVICE
+inline double NextFloatDown(double v)
+{
+    if (IsInf(v) && v < 0.)
+        return v;
+    if (v == 0.)
+        v = -0.;
+    uint64_t ui = FloatToBits(v);
+    if (v > 0.)
+        --ui;
+    else
+        ++ui;
+    return BitsToFloat(ui);
+}
+
+template <typename T>
+LUMIERE_HOST_DEVICE inline constexpr T gamma(int n)
+{
+    constexpr T epsilon = std::numeric_limits<T>::epsilon() * T(0.5);
+    return (n * epsilon) / (1 - n * epsilon);
+}
+
+LUMIERE_HOST_DEVICE
+inline constexpr Float gamma(int n)
+{
+    return gamma<Float>(n);
+}
+
 inline LUMIERE_HOST_DEVICE Float AddRoundUp(Float a, Float b)
 {
 #ifdef LUMIERE_IS_DEVICE_CODE
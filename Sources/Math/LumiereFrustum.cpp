@@ -1,4 +1,6 @@
 #include "LumiereFrustum.h"
+#include <algorithm>
+#include <cmath>
 #include "Common/LumiereAssert.h"
 
 BEGIN_LUMIERE_NAMESPACE
@@ -15,6 +17,7 @@ Frustum::Frustum()
     , mViewMatrix()
     , mProjectionMatrix()
     , mFrustumPlaneList()
+    , mCullingPlaneSet()
     , mIsFrustumValid(false)
 {
     invalidateFrustum();
@@ -22,7 +25,7 @@ Frustum::Frustum()
 }
 
 
-void Frustum::setFOVy(float FOVy)
+void Frustum::setFOVy(Float FOVy)
 {
     mFOVy = FOVy;
     LUMIERE_ENSURE(mFOVy > 0.0 && mFOVy < 180.0);
@@ -30,7 +33,7 @@ void Frustum::setFOVy(float FOVy)
 }
 
 
-void Frustum::setAspectRatio(float aspectRatio)
+void Frustum::setAspectRatio(Float aspectRatio)
 {
     mAspectRatio = aspectRatio;
     LUMIERE_ENSURE(mAspectRatio > 0.0);
@@ -38,7 +41,7 @@ void Frustum::setAspectRatio(float aspectRatio)
 }
 
 
-void Frustum::setNearClipDistance(float nearClipDistance)
+void Frustum::setNearClipDistance(Float nearClipDistance)
 {
     mNearClipDistance = nearClipDistance;
     LUMIERE_ENSURE(mNearClipDistance > 0.0);
@@ -46,7 +49,7 @@ void Frustum::setNearClipDistance(float nearClipDistance)
 }
 
 
-void Frustum::setFarClipDistance(float farClipDistance)
+void Frustum::setFarClipDistance(Float farClipDistance)
 {
     mFarClipDistance = farClipDistance;
     LUMIERE_ENSURE(mFarClipDistance > 0.0);
@@ -93,25 +96,25 @@ const Matrix4x4& Frustum::getProjectionMatrix()
 }
 
 
-float Frustum::getFOVy() const
+Float Frustum::getFOVy() const
 {
     return mFOVy;
 }
 
 
-float Frustum::getAspectRation() const
+Float Frustum::getAspectRation() const
 {
     return mAspectRatio;
 }
 
 
-float Frustum::getNearClipDistance() const
+Float Frustum::getNearClipDistance() const
 {
     return mNearClipDistance;
 }
 
 
-float Frustum::getFarClipDistance() const
+Float Frustum::getFarClipDistance() const
 {
     return mFarClipDistance;
 }
@@ -150,18 +153,13 @@ bool Frustum::inFrustum(const AxisAlignedBox& axisAlignedBox)
         updateFrustum();
     }
 
+    const Point3f center = axisAlignedBox.getCenter();
+    const Vector3f halfSize = axisAlignedBox.getHalfSize();
     for (int i = 0; i < FrustumPlane::_size(); ++ i) {
         const auto& plane = mFrustumPlaneList[i];
-
-        bool allCornerOutside = true;
-        for (size_t cornerIndex = 0; cornerIndex < AxisAlignedBoxCornerIndex::_size() && allCornerOutside; ++ cornerIndex) {
-            const Point3f corner = axisAlignedBox.getCornerVertex(AxisAlignedBoxCornerIndex::_from_index(cornerIndex));
-            if (plane.distanceToPoint(corner) > 0.0) {
-                allCornerOutside = false;
-            }
-        }
-
-        if (allCornerOutside) {
+        const Normal3f normal = plane.getNormal();
+        const Float radius = std::abs(normal.x) * halfSize.x + std::abs(normal.y) * halfSize.y + std::abs(normal.z) * halfSize.z;
+        if (plane.distanceToPoint(center) + radius < 0.0) {
             return false;
         }
     }
@@ -169,6 +167,44 @@ bool Frustum::inFrustum(const AxisAlignedBox& axisAlignedBox)
 }
 
 
+void Frustum::cull(const AxisAlignedBox *axisAlignedBoxList, size_t count, uint8_t *visibleMask)
+{
+    LUMIERE_EXPECT(axisAlignedBoxList || count == 0);
+    LUMIERE_EXPECT(visibleMask || count == 0);
+    if (!mIsFrustumValid) {
+        updateFrustum();
+    }
+
+    AxisAlignedBoxBlock block;
+    for (size_t first = 0; first < count; first += AxisAlignedBoxBlock::Size) {
+        const size_t blockSize = std::min(AxisAlignedBoxBlock::Size, count - first);
+        block.load(axisAlignedBoxList + first, blockSize);
+        const uint32_t blockMask = CullAxisAlignedBoxBlock(mCullingPlaneSet, block);
+        for (size_t i = 0; i < blockSize; ++ i) {
+            visibleMask[first + i] = static_cast<uint8_t>((blockMask >> i) & 1u);
+        }
+    }
+}
+
+
+const Frustum::FrustumPlaneList& Frustum::getFrustumPlaneList()
+{
+    if (!mIsFrustumValid) {
+        updateFrustum();
+    }
+    return mFrustumPlaneList;
+}
+
+
+const CullingPlaneSet& Frustum::getCullingPlaneSet()
+{
+    if (!mIsFrustumValid) {
+        updateFrustum();
+    }
+    return mCullingPlaneSet;
+}
+
+
 void Frustum::updateFrustum()
 {
     updateViewMatrix();
@@ -184,67 +220,40 @@ void Frustum::updateViewMatrix()
     mFrontDir = Normalize(mFrontDir);
     mRightDir = Normalize(Cross(mFrontDir, worldUp));
     mUpDir = Normalize(Cross(mRightDir, mFrontDir));
-    //mViewMatrix = CalculateViewMatrix(mPosition, mPosition + mFrontDir, mUpDir);
+    mViewMatrix = CalculateViewMatrix(mPosition, mPosition + mFrontDir, mUpDir);
 }
 
 
 void Frustum::updateProjectionMatrix()
 {
-    //mProjectionMatrix = CalculateProjectionMatrix(mFOVy, mAspectRatio, mNearClipDistance, mFarClipDistance);
+    mProjectionMatrix = CalculateProjectionMatrix(ConvertDegreeToRadians(mFOVy), mAspectRatio, mNearClipDistance, mFarClipDistance);
 }
 
 
 void Frustum::updateFrustumPlaneList()
 {
-    float nearPlaneHeight = mNearClipDistance * std::tan(ConvertDegreeToRadians(mFOVy / 2.0));
-    float nearPlaneWidth = nearPlaneHeight * mAspectRatio;
-
-    float farPlaneHeight = mFarClipDistance * std::tan(ConvertDegreeToRadians(mFOVy / 2.0));
-    float farPlaneWidth = farPlaneHeight * mAspectRatio;
-
-    const Point3f farPlaneCenter = mPosition + mFrontDir * mFarClipDistance;
-    Point3f farPlaneTopLeft     = farPlaneCenter + (mUpDir * (farPlaneHeight / 2.0f)) - (mRightDir * (farPlaneWidth / 2.0f));
-    Point3f farPlaneTopRight    = farPlaneCenter + (mUpDir * (farPlaneHeight / 2.0f)) + (mRightDir * (farPlaneWidth / 2.0f));
-    Point3f farPlaneBottomLeft  = farPlaneCenter - (mUpDir * (farPlaneHeight / 2.0f)) - (mRightDir * (farPlaneWidth / 2.0f));
-    Point3f farPlaneBottomRight = farPlaneCenter - (mUpDir * (farPlaneHeight / 2.0f)) + (mRightDir * (farPlaneWidth / 2.0f));
-
-    const Point3f nearPlaneCenter = mPosition + mFrontDir * mNearClipDistance;
-    Point3f nearPlaneTopLeft     = nearPlaneCenter + (mUpDir * (nearPlaneHeight / 2.0f)) - (mRightDir * (nearPlaneWidth / 2.0f));
-    Point3f nearPlaneTopRight    = nearPlaneCenter + (mUpDir * (nearPlaneHeight / 2.0f)) + (mRightDir * (nearPlaneWidth / 2.0f));
-    Point3f nearPlaneBottomLeft  = nearPlaneCenter - (mUpDir * (nearPlaneHeight / 2.0f)) - (mRightDir * (nearPlaneWidth / 2.0f));
-    Point3f nearPlaneBottomRight = nearPlaneCenter - (mUpDir * (nearPlaneHeight / 2.0f)) + (mRightDir * (nearPlaneWidth / 2.0f));
-
-    Plane planeList[FrustumPlane::_size()];
-
-    /*
-    planeList[FrustumPlane::NearPlane] = Plane(mFrontDir, nearPlaneCenter);
-    planeList[FrustumPlane::FarPlane] = Plane(-mFrontDir, farPlaneCenter);
-
-    Vector3f tmpVector;
-    tmpVector = (nearPlaneCenter + mRightDir * (nearPlaneWidth / 2.0f)) - mPosition;
-    tmpVector = Normalize(tmpVector);
-    Normal3f rightPlaneNormal = Normalize(Cross(mUpDir, tmpVector));
-    planeList[FrustumPlane::RightPlane] = Plane(rightPlaneNormal, nearPlaneTopRight);
-
-    tmpVector = (nearPlaneCenter - mRightDir * (nearPlaneWidth / 2.0f)) - mPosition;
-    tmpVector = Normalize(tmpVector);
-    Normal3f leftPlaneNormal = Normalize(Cross(tmpVector, mUpDir));
-    planeList[FrustumPlane::LeftPlane] = Plane(leftPlaneNormal, nearPlaneTopLeft);
-
-    tmpVector = (nearPlaneCenter + mUpDir * (nearPlaneHeight / 2.0f)) - mPosition;
-    tmpVector = Normalize(tmpVector);
-    Normal3f topPlaneNormal = Normalize(Cross(tmpVector, mRightDir));
-    planeList[FrustumPlane::TopPlane] = Plane(topPlaneNormal, nearPlaneTopLeft);
-
-    tmpVector = (nearPlaneCenter - mUpDir * (nearPlaneHeight / 2.0f)) - mPosition;
-    tmpVector = Normalize(tmpVector);
-    Normal3f bottomPlaneNormal = Normalize(Cross(mRightDir, tmpVector));
-    planeList[FrustumPlane::BottomPlane] = Plane(bottomPlaneNormal, nearPlaneBottomLeft);
-    */
-    for (const auto& plane : planeList) {
-        mFrustumPlaneList.push_back(plane);
+    // Gribb/Hartmann: every clip plane is a sum or difference of the fourth row of the
+    // view-projection matrix and one of its other rows, with normals pointing inwards
+    const Matrix4x4 viewProjectionMatrix = mProjectionMatrix * mViewMatrix;
+    auto row = [&viewProjectionMatrix](int index, Float sign) {
+        return Plane(viewProjectionMatrix[3][0] + sign * viewProjectionMatrix[index][0],
+                     viewProjectionMatrix[3][1] + sign * viewProjectionMatrix[index][1],
+                     viewProjectionMatrix[3][2] + sign * viewProjectionMatrix[index][2],
+                     viewProjectionMatrix[3][3] + sign * viewProjectionMatrix[index][3]);
+    };
+
+    mFrustumPlaneList[FrustumPlane::LeftPlane] = row(0, 1.0f);
+    mFrustumPlaneList[FrustumPlane::RightPlane] = row(0, -1.0f);
+    mFrustumPlaneList[FrustumPlane::BottomPlane] = row(1, 1.0f);
+    mFrustumPlaneList[FrustumPlane::TopPlane] = row(1, -1.0f);
+    mFrustumPlaneList[FrustumPlane::NearPlane] = row(2, 1.0f);
+    mFrustumPlaneList[FrustumPlane::FarPlane] = row(2, -1.0f);
+    for (auto& plane : mFrustumPlaneList) {
+        plane.normalize();
     }
-    LUMIERE_ENSURE(mFrustumPlaneList.size() == FrustumPlane::_size());
+
+    mCullingPlaneSet = CullingPlaneSet(mFrustumPlaneList.data(), mFrustumPlaneList.size());
+    LUMIERE_ENSURE(mCullingPlaneSet.getPlaneCount() == FrustumPlane::_size());
 }
 
 
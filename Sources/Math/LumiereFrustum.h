@@ -1,9 +1,10 @@
 #pragma once
-#include <vector>
+#include <array>
 #include <better-enums/enum.h>
 #include "Math/LumiereMath.h"
 #include "Math/LumierePlane.h"
 #include "Math/LumiereAxisAlignedBox.h"
+#include "Math/LumiereCullingKernel.h"
 
 BEGIN_LUMIERE_NAMESPACE
 
@@ -12,28 +13,31 @@ BETTER_ENUM(FrustumPlane, uint8_t, NearPlane, FarPlane, LeftPlane, RightPlane, T
 
 class Frustum {
 public:
-    using FrustumPlaneList = std::vector<Plane>;
+    using FrustumPlaneList = std::array<Plane, FrustumPlane::_size()>;
 
 public:
     Frustum();
     ~Frustum() = default;
-    void setFOVy(float FOVy);
-    void setAspectRatio(float aspectRatio);
-    void setNearClipDistance(float nearClipDistance);
-    void setFarClipDistance(float farClipDistance);
+    void setFOVy(Float FOVy);
+    void setAspectRatio(Float aspectRatio);
+    void setNearClipDistance(Float nearClipDistance);
+    void setFarClipDistance(Float farClipDistance);
     void setPosition(const Point3f& position);
     void lookAt(const Point3f& lookAt);
     void setFrontDir(const Vector3f& frontDir);
     const Matrix4x4& getViewMatrix();
     const Matrix4x4& getProjectionMatrix();
-    float getFOVy() const;
-    float getAspectRation() const;
-    float getNearClipDistance() const;
-    float getFarClipDistance() const;
+    Float getFOVy() const;
+    Float getAspectRation() const;
+    Float getNearClipDistance() const;
+    Float getFarClipDistance() const;
     const Point3f& getPosition() const;
     const Vector3f& getFrontDir() const;
     bool inFrustum(const Point3f& point);
     bool inFrustum(const AxisAlignedBox& axisAlignedBox);
+    void cull(const AxisAlignedBox *axisAlignedBoxList, size_t count, uint8_t *visibleMask);
+    const FrustumPlaneList& getFrustumPlaneList();
+    const CullingPlaneSet& getCullingPlaneSet();
 
 private:
     void updateFrustum();
@@ -43,10 +47,10 @@ private:
     void invalidateFrustum();
 
 private:
-    float mFOVy;
-    float mAspectRatio;
-    float mNearClipDistance;
-    float mFarClipDistance;
+    Float mFOVy;
+    Float mAspectRatio;
+    Float mNearClipDistance;
+    Float mFarClipDistance;
     Point3f mPosition;
     Vector3f mFrontDir;
     Vector3f mUpDir;
@@ -54,6 +58,7 @@ private:
     Matrix4x4 mViewMatrix;
     Matrix4x4 mProjectionMatrix;
     FrustumPlaneList mFrustumPlaneList;
+    CullingPlaneSet mCullingPlaneSet;
     bool mIsFrustumValid;
 };
 
@@ -0,0 +1,126 @@
+#include "LumiereIntervalPack.h"
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+template <typename LaneOperation, typename ScalarOperation>
+void ApplyRounded(const Float *a, const Float *b, Float *result, size_t count, LaneOperation laneOperation, ScalarOperation scalarOperation)
+{
+    LUMIERE_EXPECT((a && b && result) || count == 0);
+    using Lanes = SIMDFloat<Float>;
+    size_t i = 0;
+    for (; i + Lanes::Width <= count; i += Lanes::Width) {
+        laneOperation(Lanes::LoadUnaligned(a + i), Lanes::LoadUnaligned(b + i)).storeUnaligned(result + i);
+    }
+    for (; i < count; ++ i) {
+        result[i] = scalarOperation(a[i], b[i]);
+    }
+}
+
+
+template <typename PackOperation, typename ScalarOperation>
+void ApplyIntervals(const Interval *a, const Interval *b, Interval *result, size_t count, PackOperation packOperation, ScalarOperation scalarOperation)
+{
+    LUMIERE_EXPECT((a && b && result) || count == 0);
+    size_t i = 0;
+    for (; i + IntervalPack::Width <= count; i += IntervalPack::Width) {
+        packOperation(IntervalPack::Load(a + i), IntervalPack::Load(b + i)).store(result + i);
+    }
+    for (; i < count; ++ i) {
+        result[i] = scalarOperation(a[i], b[i]);
+    }
+}
+
+} // namespace
+
+
+void AddRoundUp(const Float *a, const Float *b, Float *result, size_t count)
+{
+    ApplyRounded(a, b, result, count,
+                 [](auto x, auto y) { return NextFloatUp(x + y); },
+                 [](Float x, Float y) { return AddRoundUp(x, y); });
+}
+
+
+void AddRoundDown(const Float *a, const Float *b, Float *result, size_t count)
+{
+    ApplyRounded(a, b, result, count,
+                 [](auto x, auto y) { return NextFloatDown(x + y); },
+                 [](Float x, Float y) { return AddRoundDown(x, y); });
+}
+
+
+void SubRoundUp(const Float *a, const Float *b, Float *result, size_t count)
+{
+    ApplyRounded(a, b, result, count,
+                 [](auto x, auto y) { return NextFloatUp(x - y); },
+                 [](Float x, Float y) { return SubRoundUp(x, y); });
+}
+
+
+void SubRoundDown(const Float *a, const Float *b, Float *result, size_t count)
+{
+    ApplyRounded(a, b, result, count,
+                 [](auto x, auto y) { return NextFloatDown(x - y); },
+                 [](Float x, Float y) { return SubRoundDown(x, y); });
+}
+
+
+void MulRoundUp(const Float *a, const Float *b, Float *result, size_t count)
+{
+    ApplyRounded(a, b, result, count,
+                 [](auto x, auto y) { return NextFloatUp(x * y); },
+                 [](Float x, Float y) { return MulRoundUp(x, y); });
+}
+
+
+void MulRoundDown(const Float *a, const Float *b, Float *result, size_t count)
+{
+    ApplyRounded(a, b, result, count,
+                 [](auto x, auto y) { return NextFloatDown(x * y); },
+                 [](Float x, Float y) { return MulRoundDown(x, y); });
+}
+
+
+void DivRoundUp(const Float *a, const Float *b, Float *result, size_t count)
+{
+    ApplyRounded(a, b, result, count,
+                 [](auto x, auto y) { return NextFloatUp(x / y); },
+                 [](Float x, Float y) { return DivRoundUp(x, y); });
+}
+
+
+void DivRoundDown(const Float *a, const Float *b, Float *result, size_t count)
+{
+    ApplyRounded(a, b, result, count,
+                 [](auto x, auto y) { return NextFloatDown(x / y); },
+                 [](Float x, Float y) { return DivRoundDown(x, y); });
+}
+
+
+void AddIntervals(const Interval *a, const Interval *b, Interval *result, size_t count)
+{
+    ApplyIntervals(a, b, result, count,
+                   [](const IntervalPack& x, const IntervalPack& y) { return x + y; },
+                   [](const Interval& x, const Interval& y) { return x + y; });
+}
+
+
+void SubIntervals(const Interval *a, const Interval *b, Interval *result, size_t count)
+{
+    ApplyIntervals(a, b, result, count,
+                   [](const IntervalPack& x, const IntervalPack& y) { return x - y; },
+                   [](const Interval& x, const Interval& y) { return x - y; });
+}
+
+
+void MulIntervals(const Interval *a, const Interval *b, Interval *result, size_t count)
+{
+    ApplyIntervals(a, b, result, count,
+                   [](const IntervalPack& x, const IntervalPack& y) { return x * y; },
+                   [](const Interval& x, const Interval& y) { return x * y; });
+}
+
+END_LUMIERE_NAMESPACE
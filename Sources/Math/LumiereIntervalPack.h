@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereSIMDFloat.h"
+#include "Math/LumiereVector.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// Width intervals evaluated side by side. Bounds are widened by one ulp after every
+// operation exactly like Interval does, so each lane matches the scalar result bit for bit
+// without touching the rounding mode of the calling thread.
+class IntervalPack {
+public:
+    using Lanes = SIMDFloat<Float>;
+    static constexpr int Width = Lanes::Width;
+
+public:
+    IntervalPack() = default;
+    IntervalPack(Lanes low, Lanes high) : mLow(low), mHigh(high) {}
+    explicit IntervalPack(Float value) : mLow(value), mHigh(value) {}
+    explicit IntervalPack(const Interval& interval) : mLow(interval.LowerBound()), mHigh(interval.UpperBound()) {}
+
+    static IntervalPack Load(const Interval *intervalList);
+    static IntervalPack LoadBounds(const Float *lowList, const Float *highList);
+    void store(Interval *intervalList) const;
+    void storeBounds(Float *lowList, Float *highList) const;
+
+    Lanes lowerBound() const { return mLow; }
+    Lanes upperBound() const { return mHigh; }
+    Lanes midpoint() const { return (mLow + mHigh) * Lanes(Float(0.5)); }
+    Lanes width() const { return mHigh - mLow; }
+
+    IntervalPack operator-() const { return {-mHigh, -mLow}; }
+    IntervalPack operator+(const IntervalPack& rhs) const;
+    IntervalPack operator-(const IntervalPack& rhs) const;
+    IntervalPack operator*(const IntervalPack& rhs) const;
+    IntervalPack& operator+=(const IntervalPack& rhs) { return *this = *this + rhs; }
+    IntervalPack& operator-=(const IntervalPack& rhs) { return *this = *this - rhs; }
+    IntervalPack& operator*=(const IntervalPack& rhs) { return *this = *this * rhs; }
+
+    // a lane bit is set only when the predicate holds for every value inside the intervals
+    int definitelyPositive() const { return MoveMask(mLow > Lanes(Float(0))); }
+    int definitelyNegative() const { return MoveMask(mHigh < Lanes(Float(0))); }
+    int containsZero() const { return MoveMask(mLow <= Lanes(Float(0))) & MoveMask(mHigh >= Lanes(Float(0))); }
+
+private:
+    Lanes mLow;
+    Lanes mHigh;
+};
+
+
+inline IntervalPack IntervalPack::Load(const Interval *intervalList)
+{
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float lowList[Width];
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float highList[Width];
+    for (int i = 0; i < Width; ++ i) {
+        lowList[i] = intervalList[i].LowerBound();
+        highList[i] = intervalList[i].UpperBound();
+    }
+    return {Lanes::Load(lowList), Lanes::Load(highList)};
+}
+
+
+inline IntervalPack IntervalPack::LoadBounds(const Float *lowList, const Float *highList)
+{
+    return {Lanes::LoadUnaligned(lowList), Lanes::LoadUnaligned(highList)};
+}
+
+
+inline void IntervalPack::store(Interval *intervalList) const
+{
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float lowList[Width];
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float highList[Width];
+    mLow.store(lowList);
+    mHigh.store(highList);
+    for (int i = 0; i < Width; ++ i) {
+        intervalList[i] = Interval(lowList[i], highList[i]);
+    }
+}
+
+
+inline void IntervalPack::storeBounds(Float *lowList, Float *highList) const
+{
+    mLow.storeUnaligned(lowList);
+    mHigh.storeUnaligned(highList);
+}
+
+
+inline IntervalPack IntervalPack::operator+(const IntervalPack& rhs) const
+{
+    return {NextFloatDown(mLow + rhs.mLow), NextFloatUp(mHigh + rhs.mHigh)};
+}
+
+
+inline IntervalPack IntervalPack::operator-(const IntervalPack& rhs) const
+{
+    return {NextFloatDown(mLow - rhs.mHigh), NextFloatUp(mHigh - rhs.mLow)};
+}
+
+
+inline IntervalPack IntervalPack::operator*(const IntervalPack& rhs) const
+{
+    // rounding is monotonic, so widening the extreme products equals widening each of them
+    const Lanes p0 = mLow * rhs.mLow;
+    const Lanes p1 = mHigh * rhs.mLow;
+    const Lanes p2 = mLow * rhs.mHigh;
+    const Lanes p3 = mHigh * rhs.mHigh;
+    return {NextFloatDown(Min(Min(p0, p1), Min(p2, p3))), NextFloatUp(Max(Max(p0, p1), Max(p2, p3)))};
+}
+
+
+void AddRoundUp(const Float *a, const Float *b, Float *result, size_t count);
+void AddRoundDown(const Float *a, const Float *b, Float *result, size_t count);
+void SubRoundUp(const Float *a, const Float *b, Float *result, size_t count);
+void SubRoundDown(const Float *a, const Float *b, Float *result, size_t count);
+void MulRoundUp(const Float *a, const Float *b, Float *result, size_t count);
+void MulRoundDown(const Float *a, const Float *b, Float *result, size_t count);
+void DivRoundUp(const Float *a, const Float *b, Float *result, size_t count);
+void DivRoundDown(const Float *a, const Float *b, Float *result, size_t count);
+
+void AddIntervals(const Interval *a, const Interval *b, Interval *result, size_t count);
+void SubIntervals(const Interval *a, const Interval *b, Interval *result, size_t count);
+void MulIntervals(const Interval *a, const Interval *b, Interval *result, size_t count);
+
+END_LUMIERE_NAMESPACE
@@ -1,9 +1,13 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include "LumiereColor.h"
 #include "LumiereGeometry.h"
 #include "LumiereVector.h"
+#if !LUMIERE_USE_GLM
+#include "LumiereTransform.h"
+#endif
 
 BEGIN_LUMIERE_NAMESPACE
 
@@ -27,9 +31,6 @@ using Normal3f = glm::vec3;
 #else
 
 using Matrix3x3 = glm::mat3;
-using Matrix4x4 = glm::mat4;
-
-using Transform = glm::mat4;
 
 #endif
 
@@ -78,13 +79,37 @@ inline float Length(const Normal3f& normal)
 
 #else
 
+// right-handed view matrix looking down -z, equivalent to glm::lookAt
+inline Matrix4x4 CalculateViewMatrix(const Point3f& eyePosition, const Point3f& lookAt, const Vector3f& upVector)
+{
+    const Vector3f front = Normalize(lookAt - eyePosition);
+    const Vector3f right = Normalize(Cross(front, upVector));
+    const Vector3f up = Cross(right, front);
+    const Vector3f eye(eyePosition);
+    return {right.x, right.y, right.z, -Dot(right, eye),
+            up.x, up.y, up.z, -Dot(up, eye),
+            -front.x, -front.y, -front.z, Dot(front, eye),
+            0, 0, 0, 1};
+}
+
+
+// maps view space depth [-near, -far] to clip space [-1, 1], equivalent to glm::perspective
+inline Matrix4x4 CalculateProjectionMatrix(Float FOVy, Float aspect, Float nearClipDistance, Float farClipDistance)
+{
+    const Float tanHalfFOVy = std::tan(FOVy / 2);
+    const Float depthRange = farClipDistance - nearClipDistance;
+    return {1 / (aspect * tanHalfFOVy), 0, 0, 0,
+            0, 1 / tanHalfFOVy, 0, 0,
+            0, 0, -(farClipDistance + nearClipDistance) / depthRange, -2 * farClipDistance * nearClipDistance / depthRange,
+            0, 0, -1, 0};
+}
 
 #endif
 
 
-inline float ConvertDegreeToRadians(float angle)
+inline Float ConvertDegreeToRadians(Float angle)
 {
-    return glm::radians(angle);
+    return Radians(angle);
 }
 
 END_LUMIERE_NAMESPACE
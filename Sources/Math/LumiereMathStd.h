@@ -1,6 +1,9 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
 #include "Common/LumiereMacro.h"
 #include "LumiereFloatDefs.h"
+#include "LumiereCheck.h"
 
 
 BEGIN_LUMIERE_NAMESPACE
@@ -63,4 +66,28 @@ LUMIERE_HOST_DEVICE inline constexpr T Sqr(T v)
     return v * v;
 }
 
+template <typename T>
+LUMIERE_HOST_DEVICE inline T SafeASin(T x)
+{
+    DCHECK(x >= -1.0001 && x <= 1.0001);
+    return std::asin(std::clamp<T>(x, -1, 1));
+}
+
+template <typename T>
+LUMIERE_HOST_DEVICE inline T SafeACos(T x)
+{
+    DCHECK(x >= -1.0001 && x <= 1.0001);
+    return std::acos(std::clamp<T>(x, -1, 1));
+}
+
+LUMIERE_HOST_DEVICE inline constexpr Float Radians(Float degree)
+{
+    return (Pi / 180) * degree;
+}
+
+LUMIERE_HOST_DEVICE inline constexpr Float Degrees(Float radian)
+{
+    return (180 / Pi) * radian;
+}
+
 END_LUMIERE_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "LumiereMatrix.h"
+#include <fmt/format.h>
+#include "Math/LumiereMathStd.h"
+#include "Math/LumiereSIMDFloat.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+Matrix4x4::Matrix4x4()
+    : mData{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}}
+{
+
+}
+
+
+Matrix4x4::Matrix4x4(Float m00, Float m01, Float m02, Float m03,
+                     Float m10, Float m11, Float m12, Float m13,
+                     Float m20, Float m21, Float m22, Float m23,
+                     Float m30, Float m31, Float m32, Float m33)
+    : mData{{m00, m01, m02, m03}, {m10, m11, m12, m13}, {m20, m21, m22, m23}, {m30, m31, m32, m33}}
+{
+
+}
+
+
+Matrix4x4::Matrix4x4(const Float values[4][4])
+{
+    for (int i = 0; i < 4; ++ i) {
+        for (int j = 0; j < 4; ++ j) {
+            mData[i][j] = values[i][j];
+        }
+    }
+}
+
+
+bool Matrix4x4::operator==(const Matrix4x4& rhs) const
+{
+    for (int i = 0; i < 4; ++ i) {
+        for (int j = 0; j < 4; ++ j) {
+            if (mData[i][j] != rhs.mData[i][j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+Matrix4x4 Matrix4x4::operator*(const Matrix4x4& rhs) const
+{
+    Matrix4x4 result;
+    using Lanes = SIMDFloat<Float>;
+    if constexpr (Lanes::Width <= 4) {
+        // every result row is a linear combination of the rows of rhs
+        for (int i = 0; i < 4; ++ i) {
+            for (int j = 0; j < 4; j += Lanes::Width) {
+                Lanes row = Lanes(mData[i][0]) * Lanes::LoadUnaligned(&rhs.mData[0][j]);
+                row = FMA(Lanes(mData[i][1]), Lanes::LoadUnaligned(&rhs.mData[1][j]), row);
+                row = FMA(Lanes(mData[i][2]), Lanes::LoadUnaligned(&rhs.mData[2][j]), row);
+                row = FMA(Lanes(mData[i][3]), Lanes::LoadUnaligned(&rhs.mData[3][j]), row);
+                row.storeUnaligned(&result.mData[i][j]);
+            }
+        }
+    } else {
+        for (int i = 0; i < 4; ++ i) {
+            for (int j = 0; j < 4; ++ j) {
+                result.mData[i][j] = mData[i][0] * rhs.mData[0][j] + mData[i][1] * rhs.mData[1][j] +
+                                     mData[i][2] * rhs.mData[2][j] + mData[i][3] * rhs.mData[3][j];
+            }
+        }
+    }
+    return result;
+}
+
+
+bool Matrix4x4::isIdentity() const
+{
+    return *this == Matrix4x4();
+}
+
+
+std::string Matrix4x4::toString() const
+{
+    return fmt::format("[ [ {}, {}, {}, {} ] [ {}, {}, {}, {} ] [ {}, {}, {}, {} ] [ {}, {}, {}, {} ] ]",
+                       mData[0][0], mData[0][1], mData[0][2], mData[0][3],
+                       mData[1][0], mData[1][1], mData[1][2], mData[1][3],
+                       mData[2][0], mData[2][1], mData[2][2], mData[2][3],
+                       mData[3][0], mData[3][1], mData[3][2], mData[3][3]);
+}
+
+
+Matrix4x4 Transpose(const Matrix4x4& matrix)
+{
+    return {matrix[0][0], matrix[1][0], matrix[2][0], matrix[3][0],
+            matrix[0][1], matrix[1][1], matrix[2][1], matrix[3][1],
+            matrix[0][2], matrix[1][2], matrix[2][2], matrix[3][2],
+            matrix[0][3], matrix[1][3], matrix[2][3], matrix[3][3]};
+}
+
+
+namespace {
+
+// 2x2 minors of the upper (s) and lower (c) row pairs, shared by the determinant and the inverse
+struct Minors {
+    explicit Minors(const Matrix4x4& m)
+        : s0(DifferenceOfProducts(m[0][0], m[1][1], m[1][0], m[0][1]))
+        , s1(DifferenceOfProducts(m[0][0], m[1][2], m[1][0], m[0][2]))
+        , s2(DifferenceOfProducts(m[0][0], m[1][3], m[1][0], m[0][3]))
+        , s3(DifferenceOfProducts(m[0][1], m[1][2], m[1][1], m[0][2]))
+        , s4(DifferenceOfProducts(m[0][1], m[1][3], m[1][1], m[0][3]))
+        , s5(DifferenceOfProducts(m[0][2], m[1][3], m[1][2], m[0][3]))
+        , c0(DifferenceOfProducts(m[2][0], m[3][1], m[3][0], m[2][1]))
+        , c1(DifferenceOfProducts(m[2][0], m[3][2], m[3][0], m[2][2]))
+        , c2(DifferenceOfProducts(m[2][0], m[3][3], m[3][0], m[2][3]))
+        , c3(DifferenceOfProducts(m[2][1], m[3][2], m[3][1], m[2][2]))
+        , c4(DifferenceOfProducts(m[2][1], m[3][3], m[3][1], m[2][3]))
+        , c5(DifferenceOfProducts(m[2][2], m[3][3], m[3][2], m[2][3])) {}
+
+    Float determinant() const
+    {
+        return DifferenceOfProducts(s0, c5, s1, c4) + DifferenceOfProducts(s2, c3, -s3, c2) + DifferenceOfProducts(s5, c0, s4, c1);
+    }
+
+    Float s0, s1, s2, s3, s4, s5;
+    Float c0, c1, c2, c3, c4, c5;
+};
+
+} // namespace
+
+
+Float Determinant(const Matrix4x4& matrix)
+{
+    return Minors(matrix).determinant();
+}
+
+
+std::optional<Matrix4x4> Inverse(const Matrix4x4& m)
+{
+    const Minors minors(m);
+    const Float determinant = minors.determinant();
+    if (determinant == 0) {
+        return {};
+    }
+
+    const Float s = 1 / determinant;
+    const Float s0 = minors.s0, s1 = minors.s1, s2 = minors.s2, s3 = minors.s3, s4 = minors.s4, s5 = minors.s5;
+    const Float c0 = minors.c0, c1 = minors.c1, c2 = minors.c2, c3 = minors.c3, c4 = minors.c4, c5 = minors.c5;
+    const Float inverse[4][4] = {
+        {s * (m[1][1] * c5 + m[1][3] * c3 - m[1][2] * c4),
+         s * (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3),
+         s * (m[3][1] * s5 + m[3][3] * s3 - m[3][2] * s4),
+         s * (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3)},
+        {s * (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1),
+         s * (m[0][0] * c5 + m[0][3] * c1 - m[0][2] * c2),
+         s * (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1),
+         s * (m[2][0] * s5 + m[2][3] * s1 - m[2][2] * s2)},
+        {s * (m[1][0] * c4 + m[1][3] * c0 - m[1][1] * c2),
+         s * (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0),
+         s * (m[3][0] * s4 + m[3][3] * s0 - m[3][1] * s2),
+         s * (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0)},
+        {s * (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0),
+         s * (m[0][0] * c3 + m[0][2] * c0 - m[0][1] * c1),
+         s * (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0),
+         s * (m[2][0] * s3 + m[2][2] * s0 - m[2][1] * s1)}};
+    return Matrix4x4(inverse);
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,38 @@
+#pragma once
+#include <optional>
+#include <string>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereFloatDefs.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// row-major 4x4 matrix, points and vectors are treated as column vectors: p' = M * p
+class Matrix4x4 {
+public:
+    Matrix4x4();
+    Matrix4x4(Float m00, Float m01, Float m02, Float m03,
+              Float m10, Float m11, Float m12, Float m13,
+              Float m20, Float m21, Float m22, Float m23,
+              Float m30, Float m31, Float m32, Float m33);
+    explicit Matrix4x4(const Float values[4][4]);
+    ~Matrix4x4() = default;
+
+    Float* operator[](int row) { return mData[row]; }
+    const Float* operator[](int row) const { return mData[row]; }
+    const Float* data() const { return &mData[0][0]; }
+    bool operator==(const Matrix4x4& rhs) const;
+    bool operator!=(const Matrix4x4& rhs) const { return !(*this == rhs); }
+    Matrix4x4 operator*(const Matrix4x4& rhs) const;
+    bool isIdentity() const;
+    std::string toString() const;
+
+private:
+    Float mData[4][4];
+};
+
+
+Matrix4x4 Transpose(const Matrix4x4& matrix);
+Float Determinant(const Matrix4x4& matrix);
+std::optional<Matrix4x4> Inverse(const Matrix4x4& matrix);
+
+END_LUMIERE_NAMESPACE
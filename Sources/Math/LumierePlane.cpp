@@ -1,9 +1,11 @@
 #include "LumierePlane.h"
+#include <cmath>
+#include "Common/LumiereAssert.h"
 
 BEGIN_LUMIERE_NAMESPACE
 
 
-Plane::Plane(float A, float B, float C, float D) : mA(A), mB(B), mC(C), mD(D)
+Plane::Plane(Float A, Float B, Float C, Float D) : mA(A), mB(B), mC(C), mD(D)
 {
 
 }
@@ -19,9 +21,33 @@ Plane::Plane(const Normal3f& normal, const Point3f& point)
 }
 
 
-float Plane::distanceToPoint(const Point3f& point) const
+Float Plane::distanceToPoint(const Point3f& point) const
 {
     return point.x * mA + point.y * mB + point.z * mC + mD;
 }
 
+
+Normal3f Plane::getNormal() const
+{
+    return {mA, mB, mC};
+}
+
+
+Float Plane::getDistance() const
+{
+    return mD;
+}
+
+
+void Plane::normalize()
+{
+    const Float length = std::sqrt(mA * mA + mB * mB + mC * mC);
+    LUMIERE_EXPECT(length > 0.0);
+    const Float invLength = Float(1) / length;
+    mA *= invLength;
+    mB *= invLength;
+    mC *= invLength;
+    mD *= invLength;
+}
+
 END_LUMIERE_NAMESPACE
@@ -7,15 +7,18 @@ class Plane {
 public:
     Plane() = default;
     ~Plane() = default;
-    Plane(float A, float B, float C, float D);
+    Plane(Float A, Float B, Float C, Float D);
     Plane(const Normal3f& normal, const Point3f& point);
-    float distanceToPoint(const Point3f& point) const;
+    Float distanceToPoint(const Point3f& point) const;
+    Normal3f getNormal() const;
+    Float getDistance() const;
+    void normalize();
 
 private:
-    float mA = 0.0f;
-    float mB = 0.0f;
-    float mC = 0.0f;
-    float mD = 0.0f;
+    Float mA = 0.0;
+    Float mB = 0.0;
+    Float mC = 0.0;
+    Float mD = 0.0;
 };
 
 END_LUMIERE_NAMESPACE
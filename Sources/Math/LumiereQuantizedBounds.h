@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereVector.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// child bounds stored as 8 or 16 bit offsets on a grid spanning the parent bounds; the grid
+// spacing is a power of two, so origin + q * scale rounds once and decodes identically whether
+// or not the compiler contracts it into an FMA
+struct QuantizationFrame {
+    Point3f origin;
+    Vector3f scale;
+};
+
+
+template <typename Q>
+struct QuantizedBounds3 {
+    static_assert(std::is_same<Q, uint8_t>::value || std::is_same<Q, uint16_t>::value, "only 8 and 16 bit offsets are supported");
+    static constexpr uint32_t MaxLevel = std::numeric_limits<Q>::max();
+
+    Q qMin[3];
+    Q qMax[3];
+};
+
+
+template <typename Q>
+inline QuantizationFrame MakeQuantizationFrame(const Bounds3f& parentBounds)
+{
+    DCHECK(parentBounds.pMin.x <= parentBounds.pMax.x && parentBounds.pMin.y <= parentBounds.pMax.y && parentBounds.pMin.z <= parentBounds.pMax.z);
+    QuantizationFrame frame;
+    frame.origin = parentBounds.pMin;
+    for (int axis = 0; axis < 3; ++ axis) {
+        // rounding up twice keeps MaxLevel * scale above the exact extent
+        const Float extent = NextFloatUp(parentBounds.pMax[axis] - parentBounds.pMin[axis]);
+        const Float step = NextFloatUp(extent / QuantizedBounds3<Q>::MaxLevel);
+
+        // round the step up to a power of two by carrying any mantissa bits into the exponent
+        constexpr auto MantissaMask = (decltype(FloatToBits(step))(1) << (std::numeric_limits<Float>::digits - 1)) - 1;
+        auto bits = FloatToBits(step);
+        if ((bits & MantissaMask) != 0) {
+            bits = (bits & ~MantissaMask) + MantissaMask + 1;
+        }
+        frame.scale[axis] = step > 0 ? BitsToFloat(bits) : 0;
+    }
+    return frame;
+}
+
+
+inline Float DequantizeCoordinate(const QuantizationFrame& frame, int axis, uint32_t level)
+{
+    return frame.origin[axis] + static_cast<Float>(level) * frame.scale[axis];
+}
+
+
+template <typename Q>
+inline Bounds3f Dequantize(const QuantizationFrame& frame, const QuantizedBounds3<Q>& bounds)
+{
+    Bounds3f result;
+    for (int axis = 0; axis < 3; ++ axis) {
+        result.pMin[axis] = DequantizeCoordinate(frame, axis, bounds.qMin[axis]);
+        result.pMax[axis] = DequantizeCoordinate(frame, axis, bounds.qMax[axis]);
+    }
+    return result;
+}
+
+
+// the decoded bounds always contain the input, provided the input lies inside the parent bounds
+template <typename Q>
+inline QuantizedBounds3<Q> Quantize(const QuantizationFrame& frame, const Bounds3f& bounds)
+{
+    constexpr uint32_t MaxLevel = QuantizedBounds3<Q>::MaxLevel;
+    QuantizedBounds3<Q> result;
+    for (int axis = 0; axis < 3; ++ axis) {
+        uint32_t lower = 0;
+        uint32_t upper = MaxLevel;
+        if (frame.scale[axis] > 0) {
+            const Float lowerLevel = std::floor(NextFloatDown((bounds.pMin[axis] - frame.origin[axis]) / frame.scale[axis]));
+            const Float upperLevel = std::ceil(NextFloatUp((bounds.pMax[axis] - frame.origin[axis]) / frame.scale[axis]));
+            lower = static_cast<uint32_t>(std::clamp(lowerLevel, Float(0), Float(MaxLevel)));
+            upper = static_cast<uint32_t>(std::clamp(upperLevel, Float(0), Float(MaxLevel)));
+        }
+        while (lower > 0 && DequantizeCoordinate(frame, axis, lower) > bounds.pMin[axis]) {
+            lower -= 1;
+        }
+        while (upper < MaxLevel && DequantizeCoordinate(frame, axis, upper) < bounds.pMax[axis]) {
+            upper += 1;
+        }
+        result.qMin[axis] = static_cast<Q>(lower);
+        result.qMax[axis] = static_cast<Q>(upper);
+    }
+    return result;
+}
+
+
+template <typename Q>
+inline bool Overlaps(const QuantizationFrame& frame, const QuantizedBounds3<Q>& quantizedBounds, const Bounds3f& bounds)
+{
+    for (int axis = 0; axis < 3; ++ axis) {
+        if (DequantizeCoordinate(frame, axis, quantizedBounds.qMin[axis]) > bounds.pMax[axis] ||
+            DequantizeCoordinate(frame, axis, quantizedBounds.qMax[axis]) < bounds.pMin[axis]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,212 @@
+#include "LumiereQuaternion.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include "Common/LumiereAssert.h"
+#include "Math/LumiereSIMDFloat.h"
+#include "Math/LumiereSIMDMath.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+using Lanes = SIMDFloat<Float>;
+
+struct QuaternionLanes {
+    Lanes x, y, z, w;
+};
+
+
+// blocks shorter than the lane width are padded with identity rotations and t = 0
+QuaternionLanes LoadQuaternionLanes(const Quaternionf *quaternionList, int laneCount)
+{
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float component[4][Lanes::Width];
+    for (int k = 0; k < Lanes::Width; ++ k) {
+        const Quaternionf q = k < laneCount ? quaternionList[k] : Quaternionf();
+        component[0][k] = q.v.x;
+        component[1][k] = q.v.y;
+        component[2][k] = q.v.z;
+        component[3][k] = q.w;
+    }
+    return {Lanes::Load(component[0]), Lanes::Load(component[1]), Lanes::Load(component[2]), Lanes::Load(component[3])};
+}
+
+
+Lanes LoadFloatLanes(const Float *valueList, int laneCount)
+{
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float value[Lanes::Width];
+    for (int k = 0; k < Lanes::Width; ++ k) {
+        value[k] = k < laneCount ? valueList[k] : 0;
+    }
+    return Lanes::Load(value);
+}
+
+
+void StoreQuaternionLanes(const QuaternionLanes& lanes, Quaternionf *quaternionList, int laneCount)
+{
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float component[4][Lanes::Width];
+    lanes.x.store(component[0]);
+    lanes.y.store(component[1]);
+    lanes.z.store(component[2]);
+    lanes.w.store(component[3]);
+    for (int k = 0; k < laneCount; ++ k) {
+        quaternionList[k] = Quaternionf(Vector3f(component[0][k], component[1][k], component[2][k]), component[3][k]);
+    }
+}
+
+
+Lanes Dot(const QuaternionLanes& a, const QuaternionLanes& b)
+{
+    return FMA(a.x, b.x, FMA(a.y, b.y, FMA(a.z, b.z, a.w * b.w)));
+}
+
+
+QuaternionLanes Normalize(const QuaternionLanes& q)
+{
+    const Lanes inverseLength = Lanes(Float(1)) / Sqrt(Dot(q, q));
+    return {q.x * inverseLength, q.y * inverseLength, q.z * inverseLength, q.w * inverseLength};
+}
+
+
+// weights are applied to the hemisphere-corrected second quaternion
+QuaternionLanes Blend(const QuaternionLanes& q1, Lanes weight1, const QuaternionLanes& q2, Lanes weight2)
+{
+    return {FMA(q1.x, weight1, q2.x * weight2), FMA(q1.y, weight1, q2.y * weight2),
+            FMA(q1.z, weight1, q2.z * weight2), FMA(q1.w, weight1, q2.w * weight2)};
+}
+
+
+QuaternionLanes ShorterArcTarget(const QuaternionLanes& q1, const QuaternionLanes& q2, Lanes& cosTheta)
+{
+    cosTheta = Dot(q1, q2);
+    const auto isOpposite = cosTheta < Lanes(Float(0));
+    cosTheta = Abs(cosTheta);
+    return {Select(isOpposite, -q2.x, q2.x), Select(isOpposite, -q2.y, q2.y),
+            Select(isOpposite, -q2.z, q2.z), Select(isOpposite, -q2.w, q2.w)};
+}
+
+
+// Eberly's series for sin(t * theta) / sin(theta) in powers of (cos(theta) - 1). Sixteen
+// terms with the last one scaled by Mu keep the error below 4e-8 for theta in [0, pi / 2]
+// using only multiply-adds, which is enough for float lanes but not for double ones.
+Lanes SlerpWeight(Lanes t, Lanes cosThetaMinusOne)
+{
+    constexpr int TermCount = 16;
+    constexpr Float Mu = 1.9168;
+    const Lanes tSquared = t * t;
+    Lanes result(Float(1));
+    for (int i = TermCount; i >= 1; -- i) {
+        const Float scale = i == TermCount ? Mu : 1;
+        const Lanes u(scale / (i * (2 * i + 1)));
+        const Lanes v(scale * i / (2 * i + 1));
+        result = FMA((FMA(u, tSquared, -v) * cosThetaMinusOne), result, Lanes(Float(1)));
+    }
+    return t * result;
+}
+
+
+// coefficients (2k)! / (4^k (k!)^2 (2k + 1)) of asin(z) = z + z^3 / 6 + 3 z^5 / 40 + ..., enough
+// terms to stay below half a double ulp for |z| <= 0.5
+struct ArcSineCoefficients {
+    static constexpr int TermCount = 25;
+
+    constexpr ArcSineCoefficients() : value()
+    {
+        double binomial = 1;
+        for (int k = 0; k < TermCount; ++ k) {
+            value[k] = static_cast<Float>(binomial / (2 * k + 1));
+            binomial *= (2.0 * k + 1) / (2.0 * k + 2);
+        }
+    }
+
+    Float value[TermCount];
+};
+
+
+// asin(x) for x in [0, 1], folding x > 0.5 onto the series through asin(x) = pi / 2 - 2 asin(sqrt((1 - x) / 2))
+Lanes ArcSine(Lanes x)
+{
+    constexpr ArcSineCoefficients Coefficients;
+    const auto isFolded = x > Lanes(Float(0.5));
+    const Lanes z = Select(isFolded, Sqrt((Lanes(Float(1)) - x) * Lanes(Float(0.5))), x);
+    const Lanes result = z * SIMDMathDetail::EvaluateHorner(Coefficients.value, z * z);
+    return Select(isFolded, FMA(Lanes(Float(-2)), result, Lanes(Float(1.57079632679489661923))), result);
+}
+
+
+// theta from the chord |q1 - q2| = 2 sin(theta / 2), which unlike acos(cos(theta)) keeps full
+// precision for small angles
+Lanes ChordAngle(const QuaternionLanes& q1, const QuaternionLanes& q2)
+{
+    const QuaternionLanes chord = {q1.x - q2.x, q1.y - q2.y, q1.z - q2.z, q1.w - q2.w};
+    const Lanes halfChord = Min(Lanes(Float(0.5)) * Sqrt(Dot(chord, chord)), Lanes(Float(1)));
+    return Lanes(Float(2)) * ArcSine(halfChord);
+}
+
+
+// sin(t * theta) / sin(theta) evaluated directly, for double lanes where the series falls short
+Lanes ExactSlerpWeight(Lanes t, Lanes theta, Lanes sinTheta)
+{
+    const auto isZero = sinTheta == Lanes(Float(0));
+    return Select(isZero, t, Sin(t * theta) / Select(isZero, Lanes(Float(1)), sinTheta));
+}
+
+
+template <typename Kernel>
+void ForEachQuaternionBlock(size_t count, Kernel kernel)
+{
+    for (size_t first = 0; first < count; first += Lanes::Width) {
+        kernel(first, static_cast<int>(std::min<size_t>(Lanes::Width, count - first)));
+    }
+}
+
+} // namespace
+
+
+void NormalizeQuaternions(const Quaternionf *quaternionList, size_t count, Quaternionf *resultList)
+{
+    LUMIERE_EXPECT((quaternionList && resultList) || count == 0);
+    ForEachQuaternionBlock(count, [&](size_t first, int laneCount) {
+        const QuaternionLanes q = LoadQuaternionLanes(quaternionList + first, laneCount);
+        StoreQuaternionLanes(Normalize(q), resultList + first, laneCount);
+    });
+}
+
+
+void NlerpQuaternions(const Float *tList, const Quaternionf *q1List, const Quaternionf *q2List, size_t count, Quaternionf *resultList)
+{
+    LUMIERE_EXPECT((tList && q1List && q2List && resultList) || count == 0);
+    ForEachQuaternionBlock(count, [&](size_t first, int laneCount) {
+        const Lanes t = LoadFloatLanes(tList + first, laneCount);
+        const QuaternionLanes q1 = LoadQuaternionLanes(q1List + first, laneCount);
+        Lanes cosTheta;
+        const QuaternionLanes q2 = ShorterArcTarget(q1, LoadQuaternionLanes(q2List + first, laneCount), cosTheta);
+        StoreQuaternionLanes(Normalize(Blend(q1, Lanes(Float(1)) - t, q2, t)), resultList + first, laneCount);
+    });
+}
+
+
+void SlerpQuaternions(const Float *tList, const Quaternionf *q1List, const Quaternionf *q2List, size_t count, Quaternionf *resultList)
+{
+    LUMIERE_EXPECT((tList && q1List && q2List && resultList) || count == 0);
+    ForEachQuaternionBlock(count, [&](size_t first, int laneCount) {
+        const Lanes t = LoadFloatLanes(tList + first, laneCount);
+        const QuaternionLanes q1 = LoadQuaternionLanes(q1List + first, laneCount);
+        Lanes cosTheta;
+        const QuaternionLanes q2 = ShorterArcTarget(q1, LoadQuaternionLanes(q2List + first, laneCount), cosTheta);
+        Lanes weight1, weight2;
+        if constexpr (std::is_same_v<Float, double>) {
+            const Lanes theta = ChordAngle(q1, q2);
+            const Lanes sinTheta = Sin(theta);
+            weight1 = ExactSlerpWeight(Lanes(Float(1)) - t, theta, sinTheta);
+            weight2 = ExactSlerpWeight(t, theta, sinTheta);
+        } else {
+            const Lanes cosThetaMinusOne = cosTheta - Lanes(Float(1));
+            weight1 = SlerpWeight(Lanes(Float(1)) - t, cosThetaMinusOne);
+            weight2 = SlerpWeight(t, cosThetaMinusOne);
+        }
+        StoreQuaternionLanes(Blend(q1, weight1, q2, weight2), resultList + first, laneCount);
+    });
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,191 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <fmt/format.h>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereMathStd.h"
+#include "Math/LumiereTransform.h"
+#include "Math/LumiereVector.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// q = (v, w) = v.x * i + v.y * j + v.z * k + w, unit quaternions represent rotations
+template <typename T>
+class Quaternion {
+public:
+    Quaternion() = default;
+    Quaternion(const Vector3<T>& v, T w) : v(v), w(w) {}
+    template <typename U> explicit Quaternion(const Quaternion<U>& q) : v(Vector3<T>(q.v)), w(static_cast<T>(q.w)) {}
+    explicit Quaternion(const Transform& transform);
+
+    static Quaternion FromAxisAngle(T theta, const Vector3<T>& axis);
+
+    Quaternion& operator+=(const Quaternion& q) { v += q.v; w += q.w; return *this; }
+    Quaternion& operator-=(const Quaternion& q) { v -= q.v; w -= q.w; return *this; }
+    Quaternion& operator*=(T f) { v *= f; w *= f; return *this; }
+    Quaternion& operator/=(T f) { v /= f; w /= f; return *this; }
+    Quaternion operator+(const Quaternion& q) const { return {v + q.v, w + q.w}; }
+    Quaternion operator-(const Quaternion& q) const { return {v - q.v, w - q.w}; }
+    Quaternion operator-() const { return {-v, -w}; }
+    Quaternion operator*(T f) const { return {v * f, w * f}; }
+    Quaternion operator/(T f) const { return {v / f, w / f}; }
+    Quaternion operator*(const Quaternion& q) const { return {w * q.v + q.w * v + Cross(v, q.v), w * q.w - Dot(v, q.v)}; }
+    bool operator==(const Quaternion& q) const { return v == q.v && w == q.w; }
+    bool operator!=(const Quaternion& q) const { return !(*this == q); }
+
+    Vector3<T> rotate(const Vector3<T>& vector) const;
+    Matrix4x4 toMatrix() const;
+    Transform toTransform() const;
+    std::string toString() const { return fmt::format("[ {}, {}, {}, {} ]", v.x, v.y, v.z, w); }
+
+    Vector3<T> v{0, 0, 0};
+    T w = 1;
+};
+
+
+using Quaternionf = Quaternion<Float>;
+
+
+template <typename T>
+Quaternion<T>::Quaternion(const Transform& transform)
+{
+    const auto& m = transform.getMatrix();
+    const Float trace = m[0][0] + m[1][1] + m[2][2];
+    if (trace > 0) {
+        Float s = std::sqrt(trace + 1);
+        w = static_cast<T>(s / 2);
+        s = Float(0.5) / s;
+        v = Vector3<T>(static_cast<T>((m[2][1] - m[1][2]) * s), static_cast<T>((m[0][2] - m[2][0]) * s),
+                       static_cast<T>((m[1][0] - m[0][1]) * s));
+        return;
+    }
+
+    // start from the largest diagonal entry to keep the square root away from zero
+    const int next[3] = {1, 2, 0};
+    int i = 0;
+    if (m[1][1] > m[0][0]) {
+        i = 1;
+    }
+    if (m[2][2] > m[i][i]) {
+        i = 2;
+    }
+    const int j = next[i];
+    const int k = next[j];
+    Float s = std::sqrt(std::max<Float>(0, (m[i][i] - (m[j][j] + m[k][k])) + 1));
+    Float q[3];
+    q[i] = s / 2;
+    if (s != 0) {
+        s = Float(0.5) / s;
+    }
+    w = static_cast<T>((m[k][j] - m[j][k]) * s);
+    q[j] = (m[j][i] + m[i][j]) * s;
+    q[k] = (m[k][i] + m[i][k]) * s;
+    v = Vector3<T>(static_cast<T>(q[0]), static_cast<T>(q[1]), static_cast<T>(q[2]));
+}
+
+
+template <typename T>
+Quaternion<T> Quaternion<T>::FromAxisAngle(T theta, const Vector3<T>& axis)
+{
+    const T halfTheta = static_cast<T>(Radians(theta)) / 2;
+    return {Vector3<T>(Normalize(axis)) * std::sin(halfTheta), std::cos(halfTheta)};
+}
+
+
+template <typename T>
+Vector3<T> Quaternion<T>::rotate(const Vector3<T>& vector) const
+{
+    const Vector3<T> t = 2 * Cross(v, vector);
+    return vector + w * t + Cross(v, t);
+}
+
+
+template <typename T>
+Matrix4x4 Quaternion<T>::toMatrix() const
+{
+    const Float x = v.x, y = v.y, z = v.z, s = w;
+    const Float xx = x * x, yy = y * y, zz = z * z;
+    const Float xy = x * y, xz = x * z, yz = y * z;
+    const Float wx = x * s, wy = y * s, wz = z * s;
+    return {1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy), 0,
+            2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx), 0,
+            2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy), 0,
+            0, 0, 0, 1};
+}
+
+
+template <typename T>
+Transform Quaternion<T>::toTransform() const
+{
+    const Matrix4x4 matrix = toMatrix();
+    return Transform(matrix, Transpose(matrix));
+}
+
+
+template <typename T>
+inline Quaternion<T> operator*(T f, const Quaternion<T>& q)
+{
+    return q * f;
+}
+
+
+template <typename T>
+inline T Dot(const Quaternion<T>& q1, const Quaternion<T>& q2)
+{
+    return Dot(q1.v, q2.v) + q1.w * q2.w;
+}
+
+
+template <typename T>
+inline T Length(const Quaternion<T>& q)
+{
+    return std::sqrt(Dot(q, q));
+}
+
+
+template <typename T>
+inline Quaternion<T> Normalize(const Quaternion<T>& q)
+{
+    return q / Length(q);
+}
+
+
+template <typename T>
+inline Quaternion<T> Conjugate(const Quaternion<T>& q)
+{
+    return {-q.v, q.w};
+}
+
+
+// both interpolations take the shorter arc, so q2 is negated when the quaternions lie in opposite hemispheres
+template <typename T>
+Quaternion<T> Slerp(T t, const Quaternion<T>& q1, const Quaternion<T>& q2)
+{
+    T cosTheta = Dot(q1, q2);
+    const Quaternion<T> target = cosTheta < 0 ? -q2 : q2;
+    cosTheta = std::abs(cosTheta);
+    if (cosTheta > T(0.9995)) {
+        return Normalize((1 - t) * q1 + t * target);
+    }
+    const T theta = SafeACos(cosTheta);
+    const T sinTheta = std::sin(theta);
+    return (std::sin((1 - t) * theta) / sinTheta) * q1 + (std::sin(t * theta) / sinTheta) * target;
+}
+
+
+template <typename T>
+Quaternion<T> Nlerp(T t, const Quaternion<T>& q1, const Quaternion<T>& q2)
+{
+    const Quaternion<T> target = Dot(q1, q2) < 0 ? -q2 : q2;
+    return Normalize((1 - t) * q1 + t * target);
+}
+
+
+// batched versions run on Float lanes
+void NormalizeQuaternions(const Quaternionf *quaternionList, size_t count, Quaternionf *resultList);
+void NlerpQuaternions(const Float *tList, const Quaternionf *q1List, const Quaternionf *q2List, size_t count, Quaternionf *resultList);
+void SlerpQuaternions(const Float *tList, const Quaternionf *q1List, const Quaternionf *q2List, size_t count, Quaternionf *resultList);
+
+END_LUMIERE_NAMESPACE
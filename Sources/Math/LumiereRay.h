@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include "Common/LumiereMacro.h"
+#include "Common/LumiereSIMD.h"
+#include "Math/LumiereSIMDFloat.h"
+#include "Math/LumiereVector.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// invDir and dirIsNeg are derived once here in the layout Bounds3f::IntersectP() expects;
+// construct a new ray instead of changing d in place
+class Ray {
+public:
+    Ray() = default;
+    Ray(const Point3f& o, const Vector3f& d, Float tMax = Infinity)
+        : o(o), d(d), tMax(tMax), invDir(1 / d.x, 1 / d.y, 1 / d.z)
+        , dirIsNeg{invDir.x < 0 ? 1 : 0, invDir.y < 0 ? 1 : 0, invDir.z < 0 ? 1 : 0} {}
+
+    Point3f operator()(Float t) const { return o + d * t; }
+    bool intersectP(const Bounds3f& bounds) const { return bounds.IntersectP(o, d, tMax, invDir, dirIsNeg); }
+
+    Point3f o;
+    Vector3f d;
+    Float tMax = Infinity;
+    Vector3f invDir;
+    int dirIsNeg[3] = {0, 0, 0};
+};
+
+
+// one ray per SIMD lane in structure-of-arrays layout; lanes outside activeMask are ignored
+struct alignas(LUMIERE_SIMD_ALIGNMENT) RayPacket {
+    using Lanes = SIMDFloat<Float>;
+    static constexpr int Size = Lanes::Width;
+    static constexpr uint32_t FullMask = (1u << Size) - 1;
+
+    void setRay(int lane, const Ray& ray)
+    {
+        DCHECK(lane >= 0 && lane < Size);
+        for (int axis = 0; axis < 3; ++ axis) {
+            origin[axis][lane] = ray.o[axis];
+            direction[axis][lane] = ray.d[axis];
+            invDir[axis][lane] = ray.invDir[axis];
+        }
+        tMax[lane] = ray.tMax;
+        activeMask |= 1u << lane;
+    }
+
+    Ray getRay(int lane) const
+    {
+        DCHECK(lane >= 0 && lane < Size);
+        return Ray(Point3f(origin[0][lane], origin[1][lane], origin[2][lane]),
+                   Vector3f(direction[0][lane], direction[1][lane], direction[2][lane]), tMax[lane]);
+    }
+
+    // slab test of every lane at once, returns the lanes whose [0, tMax] overlaps the bounds
+    uint32_t intersectP(const Bounds3f& bounds) const
+    {
+        Lanes tNear(Float(0));
+        Lanes tFar = Lanes::Load(tMax);
+        for (int axis = 0; axis < 3; ++ axis) {
+            const Lanes o = Lanes::Load(origin[axis]);
+            const Lanes inverse = Lanes::Load(invDir[axis]);
+            const Lanes t0 = (Lanes(bounds.pMin[axis]) - o) * inverse;
+            const Lanes t1 = (Lanes(bounds.pMax[axis]) - o) * inverse;
+            tNear = Max(tNear, Min(t0, t1));
+            // same robustness margin as Bounds3f::IntersectP()
+            tFar = Min(tFar, Max(t0, t1) * Lanes(1 + 2 * gamma(3)));
+        }
+        return static_cast<uint32_t>(MoveMask(tNear <= tFar)) & activeMask;
+    }
+
+    Float origin[3][Size];
+    Float direction[3][Size];
+    Float invDir[3][Size];
+    Float tMax[Size];
+    uint32_t activeMask = 0;
+};
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,270 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "Common/LumiereMacro.h"
+#include "Common/LumiereSIMD.h"
+#include "Math/LumiereFloatDefs.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// SIMDFloat<T> holds Width lanes of T in the widest register the build enables.
+// Comparisons return masks with all bits of a lane set, consumed by Select() and MoveMask().
+template <typename T> struct SIMDFloat;
+
+#if defined(LUMIERE_ENABLE_AVX2)
+
+template <>
+struct SIMDFloat<float> {
+    static constexpr int Width = 8;
+
+    SIMDFloat() = default;
+    SIMDFloat(__m256 value) : v(value) {}
+    explicit SIMDFloat(float value) : v(_mm256_set1_ps(value)) {}
+    static SIMDFloat Load(const float *data) { return _mm256_load_ps(data); }
+    static SIMDFloat LoadUnaligned(const float *data) { return _mm256_loadu_ps(data); }
+    void store(float *data) const { _mm256_store_ps(data, v); }
+    void storeUnaligned(float *data) const { _mm256_storeu_ps(data, v); }
+
+    __m256 v;
+};
+
+inline SIMDFloat<float> operator+(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_add_ps(a.v, b.v); }
+inline SIMDFloat<float> operator-(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_sub_ps(a.v, b.v); }
+inline SIMDFloat<float> operator*(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_mul_ps(a.v, b.v); }
+inline SIMDFloat<float> operator/(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_div_ps(a.v, b.v); }
+inline SIMDFloat<float> operator-(SIMDFloat<float> a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+inline SIMDFloat<float> operator<(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+inline SIMDFloat<float> operator<=(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+inline SIMDFloat<float> operator>(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+inline SIMDFloat<float> operator>=(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+inline SIMDFloat<float> operator==(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+inline SIMDFloat<float> operator&(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_and_ps(a.v, b.v); }
+inline SIMDFloat<float> operator|(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_or_ps(a.v, b.v); }
+inline SIMDFloat<float> Min(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_min_ps(a.v, b.v); }
+inline SIMDFloat<float> Max(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_max_ps(a.v, b.v); }
+inline SIMDFloat<float> Abs(SIMDFloat<float> a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+inline SIMDFloat<float> Sqrt(SIMDFloat<float> a) { return _mm256_sqrt_ps(a.v); }
+inline SIMDFloat<float> Select(SIMDFloat<float> mask, SIMDFloat<float> a, SIMDFloat<float> b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+inline int MoveMask(SIMDFloat<float> mask) { return _mm256_movemask_ps(mask.v); }
+
+inline SIMDFloat<float> FMA(SIMDFloat<float> a, SIMDFloat<float> b, SIMDFloat<float> c)
+{
+#if defined(LUMIERE_ENABLE_FMA)
+    return _mm256_fmadd_ps(a.v, b.v, c.v);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v);
+#endif
+}
+
+inline SIMDFloat<float> NextFloatUp(SIMDFloat<float> a)
+{
+    // adding zero turns -0 into +0, after which stepping the bit pattern matches NextFloatUp(float)
+    const __m256 value = _mm256_add_ps(a.v, _mm256_setzero_ps());
+    const __m256i bits = _mm256_castps_si256(value);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 nonNegative = _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_GE_OQ);
+    const __m256i next = _mm256_blendv_epi8(_mm256_sub_epi32(bits, one), _mm256_add_epi32(bits, one), _mm256_castps_si256(nonNegative));
+    const __m256 isInfinity = _mm256_cmp_ps(value, _mm256_set1_ps(std::numeric_limits<float>::infinity()), _CMP_EQ_OQ);
+    return _mm256_blendv_ps(_mm256_castsi256_ps(next), value, isInfinity);
+}
+
+
+template <>
+struct SIMDFloat<double> {
+    static constexpr int Width = 4;
+
+    SIMDFloat() = default;
+    SIMDFloat(__m256d value) : v(value) {}
+    explicit SIMDFloat(double value) : v(_mm256_set1_pd(value)) {}
+    static SIMDFloat Load(const double *data) { return _mm256_load_pd(data); }
+    static SIMDFloat LoadUnaligned(const double *data) { return _mm256_loadu_pd(data); }
+    void store(double *data) const { _mm256_store_pd(data, v); }
+    void storeUnaligned(double *data) const { _mm256_storeu_pd(data, v); }
+
+    __m256d v;
+};
+
+inline SIMDFloat<double> operator+(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_add_pd(a.v, b.v); }
+inline SIMDFloat<double> operator-(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_sub_pd(a.v, b.v); }
+inline SIMDFloat<double> operator*(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_mul_pd(a.v, b.v); }
+inline SIMDFloat<double> operator/(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_div_pd(a.v, b.v); }
+inline SIMDFloat<double> operator-(SIMDFloat<double> a) { return _mm256_xor_pd(a.v, _mm256_set1_pd(-0.0)); }
+inline SIMDFloat<double> operator<(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+inline SIMDFloat<double> operator<=(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ); }
+inline SIMDFloat<double> operator>(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ); }
+inline SIMDFloat<double> operator>=(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ); }
+inline SIMDFloat<double> operator==(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ); }
+inline SIMDFloat<double> operator&(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_and_pd(a.v, b.v); }
+inline SIMDFloat<double> operator|(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_or_pd(a.v, b.v); }
+inline SIMDFloat<double> Min(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_min_pd(a.v, b.v); }
+inline SIMDFloat<double> Max(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_max_pd(a.v, b.v); }
+inline SIMDFloat<double> Abs(SIMDFloat<double> a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v); }
+inline SIMDFloat<double> Sqrt(SIMDFloat<double> a) { return _mm256_sqrt_pd(a.v); }
+inline SIMDFloat<double> Select(SIMDFloat<double> mask, SIMDFloat<double> a, SIMDFloat<double> b) { return _mm256_blendv_pd(b.v, a.v, mask.v); }
+inline int MoveMask(SIMDFloat<double> mask) { return _mm256_movemask_pd(mask.v); }
+
+inline SIMDFloat<double> FMA(SIMDFloat<double> a, SIMDFloat<double> b, SIMDFloat<double> c)
+{
+#if defined(LUMIERE_ENABLE_FMA)
+    return _mm256_fmadd_pd(a.v, b.v, c.v);
+#else
+    return _mm256_add_pd(_mm256_mul_pd(a.v, b.v), c.v);
+#endif
+}
+
+inline SIMDFloat<double> NextFloatUp(SIMDFloat<double> a)
+{
+    const __m256d value = _mm256_add_pd(a.v, _mm256_setzero_pd());
+    const __m256i bits = _mm256_castpd_si256(value);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256d nonNegative = _mm256_cmp_pd(value, _mm256_setzero_pd(), _CMP_GE_OQ);
+    const __m256i next = _mm256_blendv_epi8(_mm256_sub_epi64(bits, one), _mm256_add_epi64(bits, one), _mm256_castpd_si256(nonNegative));
+    const __m256d isInfinity = _mm256_cmp_pd(value, _mm256_set1_pd(std::numeric_limits<double>::infinity()), _CMP_EQ_OQ);
+    return _mm256_blendv_pd(_mm256_castsi256_pd(next), value, isInfinity);
+}
+
+#elif defined(LUMIERE_ENABLE_SSE)
+
+template <>
+struct SIMDFloat<float> {
+    static constexpr int Width = 4;
+
+    SIMDFloat() = default;
+    SIMDFloat(__m128 value) : v(value) {}
+    explicit SIMDFloat(float value) : v(_mm_set1_ps(value)) {}
+    static SIMDFloat Load(const float *data) { return _mm_load_ps(data); }
+    static SIMDFloat LoadUnaligned(const float *data) { return _mm_loadu_ps(data); }
+    void store(float *data) const { _mm_store_ps(data, v); }
+    void storeUnaligned(float *data) const { _mm_storeu_ps(data, v); }
+
+    __m128 v;
+};
+
+inline SIMDFloat<float> operator+(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_add_ps(a.v, b.v); }
+inline SIMDFloat<float> operator-(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_sub_ps(a.v, b.v); }
+inline SIMDFloat<float> operator*(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_mul_ps(a.v, b.v); }
+inline SIMDFloat<float> operator/(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_div_ps(a.v, b.v); }
+inline SIMDFloat<float> operator-(SIMDFloat<float> a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+inline SIMDFloat<float> operator<(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_cmplt_ps(a.v, b.v); }
+inline SIMDFloat<float> operator<=(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_cmple_ps(a.v, b.v); }
+inline SIMDFloat<float> operator>(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline SIMDFloat<float> operator>=(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_cmpge_ps(a.v, b.v); }
+inline SIMDFloat<float> operator==(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_cmpeq_ps(a.v, b.v); }
+inline SIMDFloat<float> operator&(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_and_ps(a.v, b.v); }
+inline SIMDFloat<float> operator|(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_or_ps(a.v, b.v); }
+inline SIMDFloat<float> Min(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_min_ps(a.v, b.v); }
+inline SIMDFloat<float> Max(SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_max_ps(a.v, b.v); }
+inline SIMDFloat<float> Abs(SIMDFloat<float> a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+inline SIMDFloat<float> Sqrt(SIMDFloat<float> a) { return _mm_sqrt_ps(a.v); }
+inline SIMDFloat<float> Select(SIMDFloat<float> mask, SIMDFloat<float> a, SIMDFloat<float> b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+inline int MoveMask(SIMDFloat<float> mask) { return _mm_movemask_ps(mask.v); }
+inline SIMDFloat<float> FMA(SIMDFloat<float> a, SIMDFloat<float> b, SIMDFloat<float> c) { return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v); }
+
+inline SIMDFloat<float> NextFloatUp(SIMDFloat<float> a)
+{
+    const __m128 value = _mm_add_ps(a.v, _mm_setzero_ps());
+    const __m128i bits = _mm_castps_si128(value);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128 nonNegative = _mm_cmpge_ps(value, _mm_setzero_ps());
+    const __m128 up = _mm_castsi128_ps(_mm_add_epi32(bits, one));
+    const __m128 down = _mm_castsi128_ps(_mm_sub_epi32(bits, one));
+    const __m128 next = _mm_or_ps(_mm_and_ps(nonNegative, up), _mm_andnot_ps(nonNegative, down));
+    const __m128 isInfinity = _mm_cmpeq_ps(value, _mm_set1_ps(std::numeric_limits<float>::infinity()));
+    return _mm_or_ps(_mm_and_ps(isInfinity, value), _mm_andnot_ps(isInfinity, next));
+}
+
+
+template <>
+struct SIMDFloat<double> {
+    static constexpr int Width = 2;
+
+    SIMDFloat() = default;
+    SIMDFloat(__m128d value) : v(value) {}
+    explicit SIMDFloat(double value) : v(_mm_set1_pd(value)) {}
+    static SIMDFloat Load(const double *data) { return _mm_load_pd(data); }
+    static SIMDFloat LoadUnaligned(const double *data) { return _mm_loadu_pd(data); }
+    void store(double *data) const { _mm_store_pd(data, v); }
+    void storeUnaligned(double *data) const { _mm_storeu_pd(data, v); }
+
+    __m128d v;
+};
+
+inline SIMDFloat<double> operator+(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_add_pd(a.v, b.v); }
+inline SIMDFloat<double> operator-(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_sub_pd(a.v, b.v); }
+inline SIMDFloat<double> operator*(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_mul_pd(a.v, b.v); }
+inline SIMDFloat<double> operator/(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_div_pd(a.v, b.v); }
+inline SIMDFloat<double> operator-(SIMDFloat<double> a) { return _mm_xor_pd(a.v, _mm_set1_pd(-0.0)); }
+inline SIMDFloat<double> operator<(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_cmplt_pd(a.v, b.v); }
+inline SIMDFloat<double> operator<=(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_cmple_pd(a.v, b.v); }
+inline SIMDFloat<double> operator>(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_cmpgt_pd(a.v, b.v); }
+inline SIMDFloat<double> operator>=(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_cmpge_pd(a.v, b.v); }
+inline SIMDFloat<double> operator==(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_cmpeq_pd(a.v, b.v); }
+inline SIMDFloat<double> operator&(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_and_pd(a.v, b.v); }
+inline SIMDFloat<double> operator|(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_or_pd(a.v, b.v); }
+inline SIMDFloat<double> Min(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_min_pd(a.v, b.v); }
+inline SIMDFloat<double> Max(SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_max_pd(a.v, b.v); }
+inline SIMDFloat<double> Abs(SIMDFloat<double> a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a.v); }
+inline SIMDFloat<double> Sqrt(SIMDFloat<double> a) { return _mm_sqrt_pd(a.v); }
+inline SIMDFloat<double> Select(SIMDFloat<double> mask, SIMDFloat<double> a, SIMDFloat<double> b) { return _mm_or_pd(_mm_and_pd(mask.v, a.v), _mm_andnot_pd(mask.v, b.v)); }
+inline int MoveMask(SIMDFloat<double> mask) { return _mm_movemask_pd(mask.v); }
+inline SIMDFloat<double> FMA(SIMDFloat<double> a, SIMDFloat<double> b, SIMDFloat<double> c) { return _mm_add_pd(_mm_mul_pd(a.v, b.v), c.v); }
+
+inline SIMDFloat<double> NextFloatUp(SIMDFloat<double> a)
+{
+    const __m128d value = _mm_add_pd(a.v, _mm_setzero_pd());
+    const __m128i bits = _mm_castpd_si128(value);
+    const __m128i one = _mm_set1_epi64x(1);
+    const __m128d nonNegative = _mm_cmpge_pd(value, _mm_setzero_pd());
+    const __m128d up = _mm_castsi128_pd(_mm_add_epi64(bits, one));
+    const __m128d down = _mm_castsi128_pd(_mm_sub_epi64(bits, one));
+    const __m128d next = _mm_or_pd(_mm_and_pd(nonNegative, up), _mm_andnot_pd(nonNegative, down));
+    const __m128d isInfinity = _mm_cmpeq_pd(value, _mm_set1_pd(std::numeric_limits<double>::infinity()));
+    return _mm_or_pd(_mm_and_pd(isInfinity, value), _mm_andnot_pd(isInfinity, next));
+}
+
+#else
+
+template <typename T>
+struct SIMDFloat {
+    static constexpr int Width = 1;
+
+    SIMDFloat() = default;
+    explicit SIMDFloat(T value) : v(value) {}
+    static SIMDFloat Load(const T *data) { return SIMDFloat(*data); }
+    static SIMDFloat LoadUnaligned(const T *data) { return SIMDFloat(*data); }
+    void store(T *data) const { *data = v; }
+    void storeUnaligned(T *data) const { *data = v; }
+
+    T v;
+};
+
+template <typename T> inline SIMDFloat<T> operator+(SIMDFloat<T> a, SIMDFloat<T> b) { return SIMDFloat<T>(a.v + b.v); }
+template <typename T> inline SIMDFloat<T> operator-(SIMDFloat<T> a, SIMDFloat<T> b) { return SIMDFloat<T>(a.v - b.v); }
+template <typename T> inline SIMDFloat<T> operator*(SIMDFloat<T> a, SIMDFloat<T> b) { return SIMDFloat<T>(a.v * b.v); }
+template <typename T> inline SIMDFloat<T> operator/(SIMDFloat<T> a, SIMDFloat<T> b) { return SIMDFloat<T>(a.v / b.v); }
+template <typename T> inline SIMDFloat<T> operator-(SIMDFloat<T> a) { return SIMDFloat<T>(-a.v); }
+template <typename T> inline bool operator<(SIMDFloat<T> a, SIMDFloat<T> b) { return a.v < b.v; }
+template <typename T> inline bool operator<=(SIMDFloat<T> a, SIMDFloat<T> b) { return a.v <= b.v; }
+template <typename T> inline bool operator>(SIMDFloat<T> a, SIMDFloat<T> b) { return a.v > b.v; }
+template <typename T> inline bool operator>=(SIMDFloat<T> a, SIMDFloat<T> b) { return a.v >= b.v; }
+template <typename T> inline bool operator==(SIMDFloat<T> a, SIMDFloat<T> b) { return a.v == b.v; }
+template <typename T> inline SIMDFloat<T> Min(SIMDFloat<T> a, SIMDFloat<T> b) { return SIMDFloat<T>(std::min(a.v, b.v)); }
+template <typename T> inline SIMDFloat<T> Max(SIMDFloat<T> a, SIMDFloat<T> b) { return SIMDFloat<T>(std::max(a.v, b.v)); }
+template <typename T> inline SIMDFloat<T> Abs(SIMDFloat<T> a) { return SIMDFloat<T>(std::abs(a.v)); }
+template <typename T> inline SIMDFloat<T> Sqrt(SIMDFloat<T> a) { return SIMDFloat<T>(std::sqrt(a.v)); }
+template <typename T> inline SIMDFloat<T> Select(bool mask, SIMDFloat<T> a, SIMDFloat<T> b) { return mask ? a : b; }
+inline int MoveMask(bool mask) { return mask ? 1 : 0; }
+template <typename T> inline SIMDFloat<T> FMA(SIMDFloat<T> a, SIMDFloat<T> b, SIMDFloat<T> c) { return SIMDFloat<T>(FMA(a.v, b.v, c.v)); }
+template <typename T> inline SIMDFloat<T> NextFloatUp(SIMDFloat<T> a) { return SIMDFloat<T>(NextFloatUp(a.v)); }
+
+#endif
+
+
+template <typename T>
+inline SIMDFloat<T> NextFloatDown(SIMDFloat<T> a)
+{
+    return -NextFloatUp(-a);
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,157 @@
+#include "LumiereSIMDMath.h"
+#include <algorithm>
+#include "Common/LumiereAssert.h"
+#include "Math/LumiereColor.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr size_t ColorBlockSize = 64;
+
+static_assert(sizeof(Vector3f) == 3 * sizeof(Float), "Vector3f must be three packed Floats");
+static_assert(sizeof(Color) == 4 * sizeof(float), "Color must be four packed floats");
+
+
+template <typename T, typename Function>
+void ApplyLanes(const T *valueList, size_t count, T *resultList, Function function)
+{
+    using Lanes = SIMDFloat<T>;
+    LUMIERE_EXPECT((valueList && resultList) || count == 0);
+    size_t i = 0;
+    for (; i + Lanes::Width <= count; i += Lanes::Width) {
+        function(Lanes::LoadUnaligned(valueList + i)).storeUnaligned(resultList + i);
+    }
+    if (i < count) {
+        // the tail is padded with ones, which are in the domain of every function
+        alignas(LUMIERE_SIMD_ALIGNMENT) T block[Lanes::Width];
+        std::fill(std::begin(block), std::end(block), T(1));
+        std::copy(valueList + i, valueList + count, block);
+        function(Lanes::Load(block)).store(block);
+        std::copy(block, block + (count - i), resultList + i);
+    }
+}
+
+
+template <typename Function>
+void ApplyColorChannels(const Color *colorList, size_t count, Color *resultList, Function function)
+{
+    LUMIERE_EXPECT((colorList && resultList) || count == 0);
+    const auto *source = reinterpret_cast<const float*>(colorList);
+    auto *destination = reinterpret_cast<float*>(resultList);
+    float channelList[3 * ColorBlockSize];
+    for (size_t first = 0; first < count; first += ColorBlockSize) {
+        const size_t blockCount = std::min(ColorBlockSize, count - first);
+        for (size_t i = 0; i < blockCount; ++ i) {
+            std::copy(source + 4 * (first + i), source + 4 * (first + i) + 3, channelList + 3 * i);
+        }
+        ApplyLanes(channelList, 3 * blockCount, channelList, function);
+        for (size_t i = 0; i < blockCount; ++ i) {
+            destination[4 * (first + i) + 3] = source[4 * (first + i) + 3];
+            std::copy(channelList + 3 * i, channelList + 3 * i + 3, destination + 4 * (first + i));
+        }
+    }
+}
+
+} // namespace
+
+
+void ExpList(const float *valueList, size_t count, float *resultList)
+{
+    ApplyLanes(valueList, count, resultList, [](SIMDFloat<float> x) { return Exp(x); });
+}
+
+
+void ExpList(const double *valueList, size_t count, double *resultList)
+{
+    ApplyLanes(valueList, count, resultList, [](SIMDFloat<double> x) { return Exp(x); });
+}
+
+
+void ExpList(const Vector3f *vectorList, size_t count, Vector3f *resultList)
+{
+    ExpList(reinterpret_cast<const Float*>(vectorList), 3 * count, reinterpret_cast<Float*>(resultList));
+}
+
+
+void ExpList(const Color *colorList, size_t count, Color *resultList)
+{
+    ApplyColorChannels(colorList, count, resultList, [](SIMDFloat<float> x) { return Exp(x); });
+}
+
+
+void LogList(const float *valueList, size_t count, float *resultList)
+{
+    ApplyLanes(valueList, count, resultList, [](SIMDFloat<float> x) { return Log(x); });
+}
+
+
+void LogList(const double *valueList, size_t count, double *resultList)
+{
+    ApplyLanes(valueList, count, resultList, [](SIMDFloat<double> x) { return Log(x); });
+}
+
+
+void LogList(const Vector3f *vectorList, size_t count, Vector3f *resultList)
+{
+    LogList(reinterpret_cast<const Float*>(vectorList), 3 * count, reinterpret_cast<Float*>(resultList));
+}
+
+
+void LogList(const Color *colorList, size_t count, Color *resultList)
+{
+    ApplyColorChannels(colorList, count, resultList, [](SIMDFloat<float> x) { return Log(x); });
+}
+
+
+void SinList(const float *valueList, size_t count, float *resultList)
+{
+    ApplyLanes(valueList, count, resultList, [](SIMDFloat<float> x) { return Sin(x); });
+}
+
+
+void SinList(const double *valueList, size_t count, double *resultList)
+{
+    ApplyLanes(valueList, count, resultList, [](SIMDFloat<double> x) { return Sin(x); });
+}
+
+
+void CosList(const float *valueList, size_t count, float *resultList)
+{
+    ApplyLanes(valueList, count, resultList, [](SIMDFloat<float> x) { return Cos(x); });
+}
+
+
+void CosList(const double *valueList, size_t count, double *resultList)
+{
+    ApplyLanes(valueList, count, resultList, [](SIMDFloat<double> x) { return Cos(x); });
+}
+
+
+void PowList(const float *valueList, float exponent, size_t count, float *resultList)
+{
+    const SIMDFloat<float> exponentLanes(exponent);
+    ApplyLanes(valueList, count, resultList, [exponentLanes](SIMDFloat<float> x) { return Pow(x, exponentLanes); });
+}
+
+
+void PowList(const double *valueList, double exponent, size_t count, double *resultList)
+{
+    const SIMDFloat<double> exponentLanes(exponent);
+    ApplyLanes(valueList, count, resultList, [exponentLanes](SIMDFloat<double> x) { return Pow(x, exponentLanes); });
+}
+
+
+void PowList(const Vector3f *vectorList, Float exponent, size_t count, Vector3f *resultList)
+{
+    PowList(reinterpret_cast<const Float*>(vectorList), exponent, 3 * count, reinterpret_cast<Float*>(resultList));
+}
+
+
+void PowList(const Color *colorList, float exponent, size_t count, Color *resultList)
+{
+    const SIMDFloat<float> exponentLanes(exponent);
+    ApplyColorChannels(colorList, count, resultList, [exponentLanes](SIMDFloat<float> x) { return Pow(x, exponentLanes); });
+}
+
+END_LUMIERE_NAMESPACE
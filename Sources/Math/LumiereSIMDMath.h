@@ -0,0 +1,410 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "Common/LumiereMacro.h"
+#include "Common/LumiereSIMD.h"
+#include "Math/LumiereSIMDFloat.h"
+#include "Math/LumiereVector.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+class Color;
+
+// Lane-wise exp, log, sin, cos and pow built from Cody-Waite range reduction and Taylor or
+// atanh series truncated below half an ulp. Maximum errors measured against long double, for
+// float and double lanes alike and with or without FMA:
+//   Exp 1.3 ulp, Log 3 ulp, Sin and Cos 2.5 ulp for |x| < 8192, Pow 1.5 ulp
+// Pow(x, y) forms y * log(x) in about twice the working precision before exponentiating, so its
+// error does not grow with |y * log(x)|. Infinities, NaNs and subnormals are handled as in
+// std::, zeros may lose their sign and Pow() of a negative base is always NaN.
+
+namespace SIMDMathDetail {
+
+template <typename T> struct Constants;
+
+template <>
+struct Constants<float> {
+    static constexpr int MantissaBits = 23;
+    static constexpr int ExponentBias = 127;
+    static constexpr int ExpDegree = 7;
+    static constexpr int LogTermCount = 5;
+    static constexpr int SinTermCount = 5;
+    static constexpr int CosTermCount = 5;
+    static constexpr float MaxLog = 88.72283935546875f;
+    static constexpr float MinLog = -103.972084045410156f;
+    static constexpr float Ln2High = 0.693359375f;
+    static constexpr float Ln2Low = -2.12194440e-4f;
+    static constexpr float PiOver2Part1 = 1.5703125f;
+    static constexpr float PiOver2Part2 = 4.837512969970703125e-4f;
+    static constexpr float PiOver2Part3 = 7.5495336204767227e-8f;
+    static constexpr float PiOver2Part4 = 2.5633440682570896e-12f;
+    // 2^12 + 1 splits a float into two halves of 12 bits
+    static constexpr float Splitter = 4097.0f;
+};
+
+template <>
+struct Constants<double> {
+    static constexpr int MantissaBits = 52;
+    static constexpr int ExponentBias = 1023;
+    static constexpr int ExpDegree = 13;
+    static constexpr int LogTermCount = 10;
+    static constexpr int SinTermCount = 8;
+    static constexpr int CosTermCount = 8;
+    static constexpr double MaxLog = 709.782712893383973096;
+    static constexpr double MinLog = -745.133219101941108420;
+    static constexpr double Ln2High = 6.93145751953125e-1;
+    static constexpr double Ln2Low = 1.42860682030941723212e-6;
+    static constexpr double PiOver2Part1 = 1.57079625129699707031e0;
+    static constexpr double PiOver2Part2 = 7.54978941586159635336e-8;
+    static constexpr double PiOver2Part3 = 5.39030285815811905290e-15;
+    static constexpr double PiOver2Part4 = 0;
+    static constexpr double Splitter = 134217729.0;
+};
+
+
+constexpr double InverseFactorial(int n)
+{
+    double result = 1;
+    for (int i = 2; i <= n; ++ i) {
+        result /= i;
+    }
+    return result;
+}
+
+
+// rounds to nearest for |x| below 2^(MantissaBits - 1), which covers every reduced argument
+template <typename T>
+inline SIMDFloat<T> Round(SIMDFloat<T> x)
+{
+    const SIMDFloat<T> magic(static_cast<T>(1.5) * static_cast<T>(uint64_t(1) << Constants<T>::MantissaBits));
+    return (x + magic) - magic;
+}
+
+
+#if defined(LUMIERE_ENABLE_AVX2)
+
+inline SIMDFloat<float> ShiftLeftBits(SIMDFloat<float> a, int count) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_castps_si256(a.v), count)); }
+inline SIMDFloat<float> ShiftRightBits(SIMDFloat<float> a, int count) { return _mm256_castsi256_ps(_mm256_srli_epi32(_mm256_castps_si256(a.v), count)); }
+inline SIMDFloat<double> ShiftLeftBits(SIMDFloat<double> a, int count) { return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(a.v), count)); }
+inline SIMDFloat<double> ShiftRightBits(SIMDFloat<double> a, int count) { return _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(a.v), count)); }
+
+#elif defined(LUMIERE_ENABLE_SSE)
+
+inline SIMDFloat<float> ShiftLeftBits(SIMDFloat<float> a, int count) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_castps_si128(a.v), count)); }
+inline SIMDFloat<float> ShiftRightBits(SIMDFloat<float> a, int count) { return _mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(a.v), count)); }
+inline SIMDFloat<double> ShiftLeftBits(SIMDFloat<double> a, int count) { return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a.v), count)); }
+inline SIMDFloat<double> ShiftRightBits(SIMDFloat<double> a, int count) { return _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a.v), count)); }
+
+#endif
+
+#if defined(LUMIERE_ENABLE_SSE)
+
+// 2^n for integral n inside the normal exponent range: adding the magic constant leaves
+// n + bias in the low mantissa bits, which are then shifted into the exponent field
+template <typename T>
+inline SIMDFloat<T> Pow2(SIMDFloat<T> n)
+{
+    constexpr int MantissaBits = Constants<T>::MantissaBits;
+    const SIMDFloat<T> magic(static_cast<T>(uint64_t(1) << MantissaBits) + Constants<T>::ExponentBias);
+    return ShiftLeftBits(n + magic, MantissaBits);
+}
+
+
+// mantissa in [0.5, 1) and exponent of a positive normal x
+template <typename T>
+inline SIMDFloat<T> Frexp(SIMDFloat<T> x, SIMDFloat<T>& exponent)
+{
+    constexpr int MantissaBits = Constants<T>::MantissaBits;
+    const SIMDFloat<T> magic(static_cast<T>(uint64_t(1) << MantissaBits));
+    exponent = (ShiftRightBits(x, MantissaBits) | magic) - magic - SIMDFloat<T>(static_cast<T>(Constants<T>::ExponentBias - 1));
+    const SIMDFloat<T> mantissaMask(BitsToFloat(decltype(FloatToBits(T()))((uint64_t(1) << MantissaBits) - 1)));
+    return (x & mantissaMask) | SIMDFloat<T>(static_cast<T>(0.5));
+}
+
+#else
+
+template <typename T>
+inline SIMDFloat<T> Pow2(SIMDFloat<T> n)
+{
+    return SIMDFloat<T>(std::ldexp(T(1), static_cast<int>(n.v)));
+}
+
+
+template <typename T>
+inline SIMDFloat<T> Frexp(SIMDFloat<T> x, SIMDFloat<T>& exponent)
+{
+    int exponentValue = 0;
+    const T mantissa = std::frexp(x.v, &exponentValue);
+    exponent = SIMDFloat<T>(static_cast<T>(exponentValue));
+    return SIMDFloat<T>(mantissa);
+}
+
+#endif
+
+
+// coefficients sign^k / factorial(first + step * k) of a truncated Taylor series
+template <typename T, int TermCount, int First, int Step, int Sign>
+struct FactorialSeriesCoefficients {
+    constexpr FactorialSeriesCoefficients() : value()
+    {
+        for (int k = 0; k < TermCount; ++ k) {
+            value[k] = static_cast<T>(((Sign < 0 && (k & 1)) ? -1.0 : 1.0) * InverseFactorial(First + Step * k));
+        }
+    }
+
+    T value[TermCount];
+};
+
+
+// coefficients 1 / (2k + 1) of the atanh series, starting from k == First
+template <typename T, int TermCount, int First = 0>
+struct AtanhSeriesCoefficients {
+    constexpr AtanhSeriesCoefficients() : value()
+    {
+        for (int k = 0; k < TermCount; ++ k) {
+            value[k] = static_cast<T>(1.0 / (2 * (k + First) + 1));
+        }
+    }
+
+    T value[TermCount];
+};
+
+
+template <typename T, int TermCount>
+inline SIMDFloat<T> EvaluateHorner(const T (&coefficientList)[TermCount], SIMDFloat<T> x)
+{
+    SIMDFloat<T> result(coefficientList[TermCount - 1]);
+    for (int k = TermCount - 2; k >= 0; -- k) {
+        result = FMA(result, x, SIMDFloat<T>(coefficientList[k]));
+    }
+    return result;
+}
+
+
+// a + b == sum + error exactly
+template <typename T>
+inline SIMDFloat<T> TwoSum(SIMDFloat<T> a, SIMDFloat<T> b, SIMDFloat<T>& error)
+{
+    const SIMDFloat<T> sum = a + b;
+    const SIMDFloat<T> bVirtual = sum - a;
+    error = (a - (sum - bVirtual)) + (b - bVirtual);
+    return sum;
+}
+
+
+// a * b == product + error exactly unless the product underflows; without a fused FMA the
+// operands are split into halves whose products are exact (Dekker)
+template <typename T>
+inline SIMDFloat<T> TwoProduct(SIMDFloat<T> a, SIMDFloat<T> b, SIMDFloat<T>& error)
+{
+    const SIMDFloat<T> product = a * b;
+#if defined(LUMIERE_ENABLE_AVX2) && defined(LUMIERE_ENABLE_FMA)
+    error = FMA(a, b, -product);
+#else
+    auto split = [](SIMDFloat<T> value, SIMDFloat<T>& low) {
+        const SIMDFloat<T> scaled = value * SIMDFloat<T>(Constants<T>::Splitter);
+        const SIMDFloat<T> high = scaled - (scaled - value);
+        low = value - high;
+        return high;
+    };
+    SIMDFloat<T> aLow, bLow;
+    const SIMDFloat<T> aHigh = split(a, aLow);
+    const SIMDFloat<T> bHigh = split(b, bLow);
+    error = ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh) + aLow * bLow;
+#endif
+    return product;
+}
+
+
+// x == mantissa * 2^exponent with the mantissa in [sqrt(2) / 2, sqrt(2)), for positive x
+// including subnormals
+template <typename T>
+inline SIMDFloat<T> ReduceLogArgument(SIMDFloat<T> x, SIMDFloat<T>& exponent)
+{
+    using Lanes = SIMDFloat<T>;
+    constexpr int SubnormalShift = Constants<T>::MantissaBits + 2;
+    const auto isSubnormal = x < Lanes(std::numeric_limits<T>::min());
+    const Lanes scaled = Select(isSubnormal, x * Lanes(static_cast<T>(uint64_t(1) << SubnormalShift)), x);
+    Lanes mantissa = Frexp(scaled, exponent);
+    exponent = exponent - Select(isSubnormal, Lanes(static_cast<T>(SubnormalShift)), Lanes(T(0)));
+    const auto isLow = mantissa < Lanes(static_cast<T>(0.707106781186547524401));
+    exponent = Select(isLow, exponent - Lanes(T(1)), exponent);
+    return Select(isLow, mantissa + mantissa, mantissa);
+}
+
+
+// log(x) as high + low with about twice the working precision
+template <typename T>
+inline SIMDFloat<T> LogExtended(SIMDFloat<T> x, SIMDFloat<T>& low)
+{
+    using Lanes = SIMDFloat<T>;
+    using C = Constants<T>;
+    Lanes exponent;
+    const Lanes mantissa = ReduceLogArgument(x, exponent);
+
+    // z = (m - 1) / (m + 1) carried as zHigh + zLow; m - 1 is exact, m + 1 is kept as a pair
+    const Lanes numerator = mantissa - Lanes(T(1));
+    Lanes denominatorLow;
+    const Lanes denominator = TwoSum(mantissa, Lanes(T(1)), denominatorLow);
+    const Lanes zHigh = numerator / denominator;
+    Lanes productError;
+    const Lanes product = TwoProduct(zHigh, denominator, productError);
+    const Lanes zLow = (((numerator - product) - productError) - zHigh * denominatorLow) / denominator;
+
+    // 2 atanh(z) = 2z + 2z^3 / 3 + ..., the series tail is below 1% of 2z so working precision
+    // suffices for it, but it runs two terms longer than in Log() to reach the extended precision
+    const Lanes z2 = zHigh * zHigh;
+    constexpr AtanhSeriesCoefficients<T, C::LogTermCount + 1, 1> Coefficients;
+    const Lanes tail = Lanes(T(2)) * zHigh * z2 * EvaluateHorner(Coefficients.value, z2);
+    Lanes sumError;
+    const Lanes high = TwoSum(exponent * Lanes(C::Ln2High), zHigh + zHigh, sumError);
+    const Lanes lowSum = sumError + (zLow + zLow) + tail + exponent * Lanes(C::Ln2Low);
+    // renormalise so that low is below half an ulp of the result
+    const Lanes result = high + lowSum;
+    low = lowSum - (result - high);
+
+    // zeros, infinities, negative numbers and NaNs come out as from Log() with a zero low part
+    const auto isRegular = (x > Lanes(T(0))) & (x < Lanes(std::numeric_limits<T>::infinity()));
+    low = Select(isRegular, low, Lanes(T(0)));
+    Lanes special = Select(x < Lanes(T(0)), Lanes(std::numeric_limits<T>::quiet_NaN()), x);
+    special = Select(x == Lanes(T(0)), Lanes(-std::numeric_limits<T>::infinity()), special);
+    return Select(isRegular, result, special);
+}
+
+
+// exp(x + low) for a low part below an ulp of x. arguments are clamped only a little above
+// MaxLog, so close to the threshold the final scaling decides whether x + low overflows
+template <typename T>
+inline SIMDFloat<T> ExpExtended(SIMDFloat<T> x, SIMDFloat<T> low)
+{
+    using Lanes = SIMDFloat<T>;
+    using C = Constants<T>;
+    const Lanes clamped = Min(Max(x, Lanes(C::MinLog)), Lanes(C::MaxLog + T(1)));
+    const Lanes k = Round(clamped * Lanes(static_cast<T>(1.44269504088896340736)));
+    // the low part of a clamped argument is meaningless next to the clamped value
+    const Lanes r = ((clamped - k * Lanes(C::Ln2High)) - k * Lanes(C::Ln2Low)) + Select(clamped == x, low, Lanes(T(0)));
+    constexpr FactorialSeriesCoefficients<T, C::ExpDegree + 1, 0, 1, 1> Coefficients;
+    const Lanes polynomial = EvaluateHorner(Coefficients.value, r);
+
+    // 2^k is applied in two halves so that subnormal results and k == 128 / 1024 stay representable
+    const Lanes lowerHalf = Round(k * Lanes(T(0.5)) - Lanes(T(0.25)));
+    const Lanes result = polynomial * Pow2(lowerHalf) * Pow2(k - lowerHalf);
+    return Select(x == x, Select(x < Lanes(C::MinLog), Lanes(T(0)), result), x);
+}
+
+
+// sin(r) or cos(r) on |r| <= pi / 4 depending on the quadrant of the reduced argument
+template <typename T>
+inline SIMDFloat<T> SinCosQuadrant(SIMDFloat<T> x, T quadrantOffset)
+{
+    using Lanes = SIMDFloat<T>;
+    using C = Constants<T>;
+    const Lanes k = Round(x * Lanes(static_cast<T>(0.636619772367581343076)));
+    // the leading parts of pi / 2 have few enough bits that k * part is exact
+    Lanes r = ((x - k * Lanes(C::PiOver2Part1)) - k * Lanes(C::PiOver2Part2)) - k * Lanes(C::PiOver2Part3);
+    if (C::PiOver2Part4 != 0) {
+        r = r - k * Lanes(C::PiOver2Part4);
+    }
+    const Lanes quadrantIndex = k + Lanes(quadrantOffset);
+    // k - 4 * floor(k / 4) with floor(k / 4) == round(k / 4 - 0.375) for integral k
+    const Lanes quadrant = quadrantIndex - Lanes(T(4)) * Round(quadrantIndex * Lanes(T(0.25)) - Lanes(T(0.375)));
+
+    const Lanes r2 = r * r;
+    // sin(r) = r - r^3 / 3! + ..., cos(r) = 1 - r^2 / 2! + ...
+    constexpr FactorialSeriesCoefficients<T, C::SinTermCount, 3, 2, -1> SineCoefficients;
+    constexpr FactorialSeriesCoefficients<T, C::CosTermCount + 1, 0, 2, -1> CosineCoefficients;
+    const Lanes sine = FMA(r * r2, -EvaluateHorner(SineCoefficients.value, r2), r);
+    const Lanes cosine = EvaluateHorner(CosineCoefficients.value, r2);
+    const auto useCosine = (quadrant == Lanes(T(1))) | (quadrant == Lanes(T(3)));
+    const Lanes result = Select(useCosine, cosine, sine);
+    return Select(quadrant >= Lanes(T(2)), -result, result);
+}
+
+} // namespace SIMDMathDetail
+
+
+template <typename T>
+inline SIMDFloat<T> Exp(SIMDFloat<T> x)
+{
+    using Lanes = SIMDFloat<T>;
+    using C = SIMDMathDetail::Constants<T>;
+    const Lanes result = SIMDMathDetail::ExpExtended(x, Lanes(T(0)));
+    return Select(x > Lanes(C::MaxLog), Lanes(std::numeric_limits<T>::infinity()), result);
+}
+
+
+template <typename T>
+inline SIMDFloat<T> Log(SIMDFloat<T> x)
+{
+    using Lanes = SIMDFloat<T>;
+    using C = SIMDMathDetail::Constants<T>;
+    Lanes exponent;
+    const Lanes mantissa = SIMDMathDetail::ReduceLogArgument(x, exponent);
+
+    // log(m) = 2 atanh(z) with z = (m - 1) / (m + 1), |z| <= 0.1716
+    const Lanes z = (mantissa - Lanes(T(1))) / (mantissa + Lanes(T(1)));
+    const Lanes z2 = z * z;
+    constexpr SIMDMathDetail::AtanhSeriesCoefficients<T, C::LogTermCount> Coefficients;
+    const Lanes logMantissa = Lanes(T(2)) * z * SIMDMathDetail::EvaluateHorner(Coefficients.value, z2);
+    // ln 2 is split so that exponent * Ln2High is exact
+    const Lanes result0 = FMA(exponent, Lanes(C::Ln2High), FMA(exponent, Lanes(C::Ln2Low), logMantissa));
+
+    Lanes result = Select(x == Lanes(std::numeric_limits<T>::infinity()), x, result0);
+    result = Select(x == Lanes(T(0)), Lanes(-std::numeric_limits<T>::infinity()), result);
+    result = Select(x < Lanes(T(0)), Lanes(std::numeric_limits<T>::quiet_NaN()), result);
+    return Select(x == x, result, x);
+}
+
+
+template <typename T>
+inline SIMDFloat<T> Sin(SIMDFloat<T> x)
+{
+    return SIMDMathDetail::SinCosQuadrant(x, T(0));
+}
+
+
+template <typename T>
+inline SIMDFloat<T> Cos(SIMDFloat<T> x)
+{
+    return SIMDMathDetail::SinCosQuadrant(x, T(1));
+}
+
+
+template <typename T>
+inline SIMDFloat<T> Pow(SIMDFloat<T> x, SIMDFloat<T> y)
+{
+    using Lanes = SIMDFloat<T>;
+    // y * log(x) is carried as high + low, since Exp() would scale a rounding error of the
+    // product by |y * log(x)|
+    Lanes logLow;
+    const Lanes logHigh = SIMDMathDetail::LogExtended(x, logLow);
+    Lanes productError;
+    const Lanes high = SIMDMathDetail::TwoProduct(y, logHigh, productError);
+    const Lanes low = FMA(y, logLow, productError);
+    // the error term is NaN when the product overflows
+    const Lanes result = SIMDMathDetail::ExpExtended(high, Select(low == low, low, Lanes(T(0))));
+    return Select((y == Lanes(T(0))) | (x == Lanes(T(1))), Lanes(T(1)), result);
+}
+
+
+// element-wise over arrays, resultList may alias the input; vectors are processed per
+// component and colors per RGB channel with alpha copied through
+void ExpList(const float *valueList, size_t count, float *resultList);
+void ExpList(const double *valueList, size_t count, double *resultList);
+void ExpList(const Vector3f *vectorList, size_t count, Vector3f *resultList);
+void ExpList(const Color *colorList, size_t count, Color *resultList);
+void LogList(const float *valueList, size_t count, float *resultList);
+void LogList(const double *valueList, size_t count, double *resultList);
+void LogList(const Vector3f *vectorList, size_t count, Vector3f *resultList);
+void LogList(const Color *colorList, size_t count, Color *resultList);
+void SinList(const float *valueList, size_t count, float *resultList);
+void SinList(const double *valueList, size_t count, double *resultList);
+void CosList(const float *valueList, size_t count, float *resultList);
+void CosList(const double *valueList, size_t count, double *resultList);
+void PowList(const float *valueList, float exponent, size_t count, float *resultList);
+void PowList(const double *valueList, double exponent, size_t count, double *resultList);
+void PowList(const Vector3f *vectorList, Float exponent, size_t count, Vector3f *resultList);
+void PowList(const Color *colorList, float exponent, size_t count, Color *resultList);
+
+END_LUMIERE_NAMESPACE
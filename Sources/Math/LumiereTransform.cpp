@@ -0,0 +1,334 @@
+#include "LumiereTransform.h"
+#include <cmath>
+#include <limits>
+#include "Common/LumiereAssert.h"
+#include "Math/LumiereSIMDFloat.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+using Lanes = SIMDFloat<Float>;
+
+// Width tuples are transposed into x/y/z lanes so that every lane runs the same
+// three (or four, for projective point transforms) multiply-add chains
+template <typename Tuple>
+void TransformTupleList(const Float rows[4][4], bool isProjective, const Tuple *input, size_t count, Tuple *output)
+{
+    static_assert(sizeof(Tuple) == 3 * sizeof(Float), "tuples are read as packed x/y/z triples");
+    LUMIERE_EXPECT((input && output) || count == 0);
+    const Lanes m00(rows[0][0]), m01(rows[0][1]), m02(rows[0][2]), m03(rows[0][3]);
+    const Lanes m10(rows[1][0]), m11(rows[1][1]), m12(rows[1][2]), m13(rows[1][3]);
+    const Lanes m20(rows[2][0]), m21(rows[2][1]), m22(rows[2][2]), m23(rows[2][3]);
+    const Lanes m30(rows[3][0]), m31(rows[3][1]), m32(rows[3][2]), m33(rows[3][3]);
+    const Lanes one(Float(1));
+    constexpr int AllLanes = (1 << Lanes::Width) - 1;
+
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float x[Lanes::Width];
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float y[Lanes::Width];
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float z[Lanes::Width];
+    size_t i = 0;
+    for (; i + Lanes::Width <= count; i += Lanes::Width) {
+        const Float *source = &input[i].x;
+        for (int k = 0; k < Lanes::Width; ++ k) {
+            x[k] = source[3 * k];
+            y[k] = source[3 * k + 1];
+            z[k] = source[3 * k + 2];
+        }
+        const Lanes px = Lanes::Load(x);
+        const Lanes py = Lanes::Load(y);
+        const Lanes pz = Lanes::Load(z);
+        Lanes rx = FMA(m00, px, FMA(m01, py, FMA(m02, pz, m03)));
+        Lanes ry = FMA(m10, px, FMA(m11, py, FMA(m12, pz, m13)));
+        Lanes rz = FMA(m20, px, FMA(m21, py, FMA(m22, pz, m23)));
+        if (isProjective) {
+            const Lanes w = FMA(m30, px, FMA(m31, py, FMA(m32, pz, m33)));
+            if (MoveMask(w == one) != AllLanes) {
+                rx = rx / w;
+                ry = ry / w;
+                rz = rz / w;
+            }
+        }
+        rx.store(x);
+        ry.store(y);
+        rz.store(z);
+        Float *destination = &output[i].x;
+        for (int k = 0; k < Lanes::Width; ++ k) {
+            destination[3 * k] = x[k];
+            destination[3 * k + 1] = y[k];
+            destination[3 * k + 2] = z[k];
+        }
+    }
+
+    for (; i < count; ++ i) {
+        const Float px = input[i].x, py = input[i].y, pz = input[i].z;
+        Float rx = FMA(rows[0][0], px, FMA(rows[0][1], py, FMA(rows[0][2], pz, rows[0][3])));
+        Float ry = FMA(rows[1][0], px, FMA(rows[1][1], py, FMA(rows[1][2], pz, rows[1][3])));
+        Float rz = FMA(rows[2][0], px, FMA(rows[2][1], py, FMA(rows[2][2], pz, rows[2][3])));
+        if (isProjective) {
+            const Float w = FMA(rows[3][0], px, FMA(rows[3][1], py, FMA(rows[3][2], pz, rows[3][3])));
+            if (w != 1) {
+                rx /= w;
+                ry /= w;
+                rz /= w;
+            }
+        }
+        output[i] = Tuple(rx, ry, rz);
+    }
+}
+
+} // namespace
+
+
+Transform::Transform(const Matrix4x4& matrix)
+    : mMatrix(matrix)
+    , mInverseMatrix()
+{
+    const std::optional<Matrix4x4> inverseMatrix = Inverse(matrix);
+    if (inverseMatrix) {
+        mInverseMatrix = *inverseMatrix;
+    } else {
+        // a singular matrix keeps a poisoned inverse instead of failing construction
+        const Float nan = std::numeric_limits<Float>::quiet_NaN();
+        for (int i = 0; i < 4; ++ i) {
+            for (int j = 0; j < 4; ++ j) {
+                mInverseMatrix[i][j] = nan;
+            }
+        }
+    }
+}
+
+
+Transform::Transform(const Matrix4x4& matrix, const Matrix4x4& inverseMatrix)
+    : mMatrix(matrix)
+    , mInverseMatrix(inverseMatrix)
+{
+
+}
+
+
+bool Transform::hasScale(Float tolerance) const
+{
+    const Float lengthX = LengthSquared((*this)(Vector3f(1, 0, 0)));
+    const Float lengthY = LengthSquared((*this)(Vector3f(0, 1, 0)));
+    const Float lengthZ = LengthSquared((*this)(Vector3f(0, 0, 1)));
+    return std::abs(lengthX - 1) > tolerance || std::abs(lengthY - 1) > tolerance || std::abs(lengthZ - 1) > tolerance;
+}
+
+
+bool Transform::isProjective() const
+{
+    return mMatrix[3][0] != 0 || mMatrix[3][1] != 0 || mMatrix[3][2] != 0 || mMatrix[3][3] != 1;
+}
+
+
+Transform Transform::operator*(const Transform& rhs) const
+{
+    return Transform(mMatrix * rhs.mMatrix, rhs.mInverseMatrix * mInverseMatrix);
+}
+
+
+Bounds3f Transform::operator()(const Bounds3f& bounds) const
+{
+    if (isProjective()) {
+        Bounds3f result;
+        for (int i = 0; i < 8; ++ i) {
+            result = Union(result, (*this)(bounds.Corner(i)));
+        }
+        return result;
+    }
+
+    // Arvo: each output extent is the translation plus, per input axis, the smaller and
+    // the larger of the matrix entry applied to the input minimum and maximum
+    const auto& m = mMatrix;
+    Point3f minimum(m[0][3], m[1][3], m[2][3]);
+    Point3f maximum(minimum);
+    for (int i = 0; i < 3; ++ i) {
+        for (int j = 0; j < 3; ++ j) {
+            const Float a = m[i][j] * bounds.pMin[j];
+            const Float b = m[i][j] * bounds.pMax[j];
+            minimum[i] += std::min(a, b);
+            maximum[i] += std::max(a, b);
+        }
+    }
+    return {minimum, maximum};
+}
+
+
+void Transform::transformPoints(const Point3f *pointList, size_t count, Point3f *resultList) const
+{
+    const auto& m = mMatrix;
+    const Float rows[4][4] = {{m[0][0], m[0][1], m[0][2], m[0][3]},
+                              {m[1][0], m[1][1], m[1][2], m[1][3]},
+                              {m[2][0], m[2][1], m[2][2], m[2][3]},
+                              {m[3][0], m[3][1], m[3][2], m[3][3]}};
+    TransformTupleList(rows, isProjective(), pointList, count, resultList);
+}
+
+
+void Transform::transformVectors(const Vector3f *vectorList, size_t count, Vector3f *resultList) const
+{
+    const auto& m = mMatrix;
+    const Float rows[4][4] = {{m[0][0], m[0][1], m[0][2], 0},
+                              {m[1][0], m[1][1], m[1][2], 0},
+                              {m[2][0], m[2][1], m[2][2], 0},
+                              {0, 0, 0, 1}};
+    TransformTupleList(rows, false, vectorList, count, resultList);
+}
+
+
+void Transform::transformNormals(const Normal3f *normalList, size_t count, Normal3f *resultList) const
+{
+    const auto& m = mInverseMatrix;
+    const Float rows[4][4] = {{m[0][0], m[1][0], m[2][0], 0},
+                              {m[0][1], m[1][1], m[2][1], 0},
+                              {m[0][2], m[1][2], m[2][2], 0},
+                              {0, 0, 0, 1}};
+    TransformTupleList(rows, false, normalList, count, resultList);
+}
+
+
+void Transform::transformBounds(const Bounds3f *boundsList, size_t count, Bounds3f *resultList) const
+{
+    static_assert(sizeof(Bounds3f) == 6 * sizeof(Float), "bounds are read as packed minimum/maximum triples");
+    LUMIERE_EXPECT((boundsList && resultList) || count == 0);
+    if (isProjective()) {
+        for (size_t i = 0; i < count; ++ i) {
+            resultList[i] = (*this)(boundsList[i]);
+        }
+        return;
+    }
+
+    const auto& m = mMatrix;
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float input[6][Lanes::Width];
+    alignas(LUMIERE_SIMD_ALIGNMENT) Float output[6][Lanes::Width];
+    size_t i = 0;
+    for (; i + Lanes::Width <= count; i += Lanes::Width) {
+        const Float *source = &boundsList[i].pMin.x;
+        for (int k = 0; k < Lanes::Width; ++ k) {
+            for (int c = 0; c < 6; ++ c) {
+                input[c][k] = source[6 * k + c];
+            }
+        }
+        for (int axis = 0; axis < 3; ++ axis) {
+            Lanes minimum(m[axis][3]);
+            Lanes maximum(m[axis][3]);
+            for (int j = 0; j < 3; ++ j) {
+                const Lanes entry(m[axis][j]);
+                const Lanes a = entry * Lanes::Load(input[j]);
+                const Lanes b = entry * Lanes::Load(input[3 + j]);
+                minimum = minimum + Min(a, b);
+                maximum = maximum + Max(a, b);
+            }
+            minimum.store(output[axis]);
+            maximum.store(output[3 + axis]);
+        }
+        Float *destination = &resultList[i].pMin.x;
+        for (int k = 0; k < Lanes::Width; ++ k) {
+            for (int c = 0; c < 6; ++ c) {
+                destination[6 * k + c] = output[c][k];
+            }
+        }
+    }
+
+    for (; i < count; ++ i) {
+        resultList[i] = (*this)(boundsList[i]);
+    }
+}
+
+
+Transform Inverse(const Transform& transform)
+{
+    return Transform(transform.getInverseMatrix(), transform.getMatrix());
+}
+
+
+Transform Transpose(const Transform& transform)
+{
+    return Transform(Transpose(transform.getMatrix()), Transpose(transform.getInverseMatrix()));
+}
+
+
+Transform Translate(const Vector3f& delta)
+{
+    const Matrix4x4 matrix(1, 0, 0, delta.x,
+                           0, 1, 0, delta.y,
+                           0, 0, 1, delta.z,
+                           0, 0, 0, 1);
+    const Matrix4x4 inverseMatrix(1, 0, 0, -delta.x,
+                                  0, 1, 0, -delta.y,
+                                  0, 0, 1, -delta.z,
+                                  0, 0, 0, 1);
+    return Transform(matrix, inverseMatrix);
+}
+
+
+Transform Scale(Float x, Float y, Float z)
+{
+    const Matrix4x4 matrix(x, 0, 0, 0,
+                           0, y, 0, 0,
+                           0, 0, z, 0,
+                           0, 0, 0, 1);
+    const Matrix4x4 inverseMatrix(1 / x, 0, 0, 0,
+                                  0, 1 / y, 0, 0,
+                                  0, 0, 1 / z, 0,
+                                  0, 0, 0, 1);
+    return Transform(matrix, inverseMatrix);
+}
+
+
+Transform RotateX(Float theta)
+{
+    const Float sinTheta = std::sin(Radians(theta));
+    const Float cosTheta = std::cos(Radians(theta));
+    const Matrix4x4 matrix(1, 0, 0, 0,
+                           0, cosTheta, -sinTheta, 0,
+                           0, sinTheta, cosTheta, 0,
+                           0, 0, 0, 1);
+    return Transform(matrix, Transpose(matrix));
+}
+
+
+Transform RotateY(Float theta)
+{
+    const Float sinTheta = std::sin(Radians(theta));
+    const Float cosTheta = std::cos(Radians(theta));
+    const Matrix4x4 matrix(cosTheta, 0, sinTheta, 0,
+                           0, 1, 0, 0,
+                           -sinTheta, 0, cosTheta, 0,
+                           0, 0, 0, 1);
+    return Transform(matrix, Transpose(matrix));
+}
+
+
+Transform RotateZ(Float theta)
+{
+    const Float sinTheta = std::sin(Radians(theta));
+    const Float cosTheta = std::cos(Radians(theta));
+    const Matrix4x4 matrix(cosTheta, -sinTheta, 0, 0,
+                           sinTheta, cosTheta, 0, 0,
+                           0, 0, 1, 0,
+                           0, 0, 0, 1);
+    return Transform(matrix, Transpose(matrix));
+}
+
+
+Transform Rotate(Float theta, const Vector3f& axis)
+{
+    const Vector3f a = Normalize(axis);
+    const Float sinTheta = std::sin(Radians(theta));
+    const Float cosTheta = std::cos(Radians(theta));
+    Matrix4x4 matrix;
+    matrix[0][0] = a.x * a.x + (1 - a.x * a.x) * cosTheta;
+    matrix[0][1] = a.x * a.y * (1 - cosTheta) - a.z * sinTheta;
+    matrix[0][2] = a.x * a.z * (1 - cosTheta) + a.y * sinTheta;
+    matrix[1][0] = a.x * a.y * (1 - cosTheta) + a.z * sinTheta;
+    matrix[1][1] = a.y * a.y + (1 - a.y * a.y) * cosTheta;
+    matrix[1][2] = a.y * a.z * (1 - cosTheta) - a.x * sinTheta;
+    matrix[2][0] = a.x * a.z * (1 - cosTheta) - a.y * sinTheta;
+    matrix[2][1] = a.y * a.z * (1 - cosTheta) + a.x * sinTheta;
+    matrix[2][2] = a.z * a.z + (1 - a.z * a.z) * cosTheta;
+    return Transform(matrix, Transpose(matrix));
+}
+
+END_LUMIERE_NAMESPACE
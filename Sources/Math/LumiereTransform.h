@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereMatrix.h"
+#include "Math/LumiereVector.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// a matrix together with its cached inverse, normals are transformed by the inverse transpose
+class Transform {
+public:
+    Transform() = default;
+    explicit Transform(const Matrix4x4& matrix);
+    Transform(const Matrix4x4& matrix, const Matrix4x4& inverseMatrix);
+    ~Transform() = default;
+
+    const Matrix4x4& getMatrix() const { return mMatrix; }
+    const Matrix4x4& getInverseMatrix() const { return mInverseMatrix; }
+    bool operator==(const Transform& rhs) const { return mMatrix == rhs.mMatrix; }
+    bool operator!=(const Transform& rhs) const { return mMatrix != rhs.mMatrix; }
+    bool isIdentity() const { return mMatrix.isIdentity(); }
+    bool hasScale(Float tolerance = 1e-3) const;
+    bool isProjective() const;
+    Transform operator*(const Transform& rhs) const;
+
+    template <typename T> Point3<T> operator()(const Point3<T>& point) const;
+    template <typename T> Vector3<T> operator()(const Vector3<T>& vector) const;
+    template <typename T> Normal3<T> operator()(const Normal3<T>& normal) const;
+    Bounds3f operator()(const Bounds3f& bounds) const;
+
+    // results may be written over the input array
+    void transformPoints(const Point3f *pointList, size_t count, Point3f *resultList) const;
+    void transformVectors(const Vector3f *vectorList, size_t count, Vector3f *resultList) const;
+    void transformNormals(const Normal3f *normalList, size_t count, Normal3f *resultList) const;
+    void transformBounds(const Bounds3f *boundsList, size_t count, Bounds3f *resultList) const;
+
+private:
+    Matrix4x4 mMatrix;
+    Matrix4x4 mInverseMatrix;
+};
+
+
+Transform Inverse(const Transform& transform);
+Transform Transpose(const Transform& transform);
+Transform Translate(const Vector3f& delta);
+Transform Scale(Float x, Float y, Float z);
+Transform RotateX(Float theta);
+Transform RotateY(Float theta);
+Transform RotateZ(Float theta);
+Transform Rotate(Float theta, const Vector3f& axis);
+
+
+template <typename T>
+inline Point3<T> Transform::operator()(const Point3<T>& point) const
+{
+    const auto& m = mMatrix;
+    const T x = m[0][0] * point.x + m[0][1] * point.y + m[0][2] * point.z + m[0][3];
+    const T y = m[1][0] * point.x + m[1][1] * point.y + m[1][2] * point.z + m[1][3];
+    const T z = m[2][0] * point.x + m[2][1] * point.y + m[2][2] * point.z + m[2][3];
+    const T w = m[3][0] * point.x + m[3][1] * point.y + m[3][2] * point.z + m[3][3];
+    if (w == 1) {
+        return Point3<T>(x, y, z);
+    }
+    return Point3<T>(x / w, y / w, z / w);
+}
+
+
+template <typename T>
+inline Vector3<T> Transform::operator()(const Vector3<T>& vector) const
+{
+    const auto& m = mMatrix;
+    return Vector3<T>(m[0][0] * vector.x + m[0][1] * vector.y + m[0][2] * vector.z,
+                      m[1][0] * vector.x + m[1][1] * vector.y + m[1][2] * vector.z,
+                      m[2][0] * vector.x + m[2][1] * vector.y + m[2][2] * vector.z);
+}
+
+
+template <typename T>
+inline Normal3<T> Transform::operator()(const Normal3<T>& normal) const
+{
+    const auto& m = mInverseMatrix;
+    return Normal3<T>(m[0][0] * normal.x + m[1][0] * normal.y + m[2][0] * normal.z,
+                      m[0][1] * normal.x + m[1][1] * normal.y + m[2][1] * normal.z,
+                      m[0][2] * normal.x + m[1][2] * normal.y + m[2][2] * normal.z);
+}
+
+END_LUMIERE_NAMESPACE
@@ -1349,8 +1349,8 @@ public:
         return b.pMin != pMin || b.pMax != pMax;
     }
 
-    LUMIERE_HOST_DEVICE bool IntersectP(const Point3f &o, const Vector3f &d, Float tMax = Infinity, Float *hitt0 = nullptr, Float *hitt1 = nullptr) const;
-    LUMIERE_HOST_DEVICE bool IntersectP(const Point3f &o, const Vector3f &d, Float tMax,const Vector3f &invDir, const int dirIsNeg[3]) const;
+    LUMIERE_HOST_DEVICE bool IntersectP(const Point3<T> &o, const Vector3<T> &d, T tMax = std::numeric_limits<T>::infinity(), T *hitt0 = nullptr, T *hitt1 = nullptr) const;
+    LUMIERE_HOST_DEVICE bool IntersectP(const Point3<T> &o, const Vector3<T> &d, T tMax, const Vector3<T> &invDir, const int dirIsNeg[3]) const;
 
     std::string ToString() const { return LUMIERE_FORMAT("[ {} - {} ]", pMin, pMax); }
 
@@ -1497,21 +1497,20 @@ LUMIERE_HOST_DEVICE inline Bounds3<T> Expand(const Bounds3<T> &b, U delta)
     return ret;
 }
 
-/*
 template <typename T>
-LUMIERE_HOST_DEVICE inline bool Bounds3<T>::IntersectP(const Point3f &o, const Vector3f &d, Float tMax, Float *hitt0, Float *hitt1) const
+LUMIERE_HOST_DEVICE inline bool Bounds3<T>::IntersectP(const Point3<T> &o, const Vector3<T> &d, T tMax, T *hitt0, T *hitt1) const
 {
-    Float t0 = 0, t1 = tMax;
+    T t0 = 0, t1 = tMax;
     for (int i = 0; i < 3; ++i) {
         // Update interval for _i_th bounding box slab
-        Float invRayDir = 1 / d[i];
-        Float tNear = (pMin[i] - o[i]) * invRayDir;
-        Float tFar = (pMax[i] - o[i]) * invRayDir;
+        T invRayDir = 1 / d[i];
+        T tNear = (pMin[i] - o[i]) * invRayDir;
+        T tFar = (pMax[i] - o[i]) * invRayDir;
         // Update parametric interval from slab intersection $t$ values
         if (tNear > tFar)
-            pstd::swap(tNear, tFar);
+            std::swap(tNear, tFar);
         // Update _tFar_ to ensure robust ray--bounds intersection
-        tFar *= 1 + 2 * gamma(3);
+        tFar *= 1 + 2 * gamma<T>(3);
 
         t0 = tNear > t0 ? tNear : t0;
         t1 = tFar < t1 ? tFar : t1;
@@ -1526,17 +1525,17 @@ LUMIERE_HOST_DEVICE inline bool Bounds3<T>::IntersectP(const Point3f &o, const V
 }
 
 template <typename T>
-LUMIERE_HOST_DEVICE inline bool Bounds3<T>::IntersectP(const Point3f &o, const Vector3f &d, Float raytMax, const Vector3f &invDir, const int dirIsNeg[3]) const
+LUMIERE_HOST_DEVICE inline bool Bounds3<T>::IntersectP(const Point3<T> &o, const Vector3<T> &, T raytMax, const Vector3<T> &invDir, const int dirIsNeg[3]) const
 {
-    const Bounds3f &bounds = *this;
+    const Bounds3<T> &bounds = *this;
     // Check for ray intersection against $x$ and $y$ slabs
-    Float tMin = (bounds[dirIsNeg[0]].x - o.x) * invDir.x;
-    Float tMax = (bounds[1 - dirIsNeg[0]].x - o.x) * invDir.x;
-    Float tyMin = (bounds[dirIsNeg[1]].y - o.y) * invDir.y;
-    Float tyMax = (bounds[1 - dirIsNeg[1]].y - o.y) * invDir.y;
+    T tMin = (bounds[dirIsNeg[0]].x - o.x) * invDir.x;
+    T tMax = (bounds[1 - dirIsNeg[0]].x - o.x) * invDir.x;
+    T tyMin = (bounds[dirIsNeg[1]].y - o.y) * invDir.y;
+    T tyMax = (bounds[1 - dirIsNeg[1]].y - o.y) * invDir.y;
     // Update _tMax_ and _tyMax_ to ensure robust bounds intersection
-    tMax *= 1 + 2 * gamma(3);
-    tyMax *= 1 + 2 * gamma(3);
+    tMax *= 1 + 2 * gamma<T>(3);
+    tyMax *= 1 + 2 * gamma<T>(3);
 
     if (tMin > tyMax || tyMin > tMax)
         return false;
@@ -1546,10 +1545,10 @@ LUMIERE_HOST_DEVICE inline bool Bounds3<T>::IntersectP(const Point3f &o, const V
         tMax = tyMax;
 
     // Check for ray intersection against $z$ slab
-    Float tzMin = (bounds[dirIsNeg[2]].z - o.z) * invDir.z;
-    Float tzMax = (bounds[1 - dirIsNeg[2]].z - o.z) * invDir.z;
+    T tzMin = (bounds[dirIsNeg[2]].z - o.z) * invDir.z;
+    T tzMax = (bounds[1 - dirIsNeg[2]].z - o.z) * invDir.z;
     // Update _tzMax_ to ensure robust bounds intersection
-    tzMax *= 1 + 2 * gamma(3);
+    tzMax *= 1 + 2 * gamma<T>(3);
 
     if (tMin > tzMax || tzMin > tMax)
         return false;
@@ -1560,6 +1559,5 @@ LUMIERE_HOST_DEVICE inline bool Bounds3<T>::IntersectP(const Point3f &o, const V
 
     return (tMin < raytMax) && (tMax > 0);
 }
-*/
 
 END_LUMIERE_NAMESPACE
\ No newline at end of file
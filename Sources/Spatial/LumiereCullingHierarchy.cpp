@@ -0,0 +1,249 @@
+#include "LumiereCullingHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+void CullingHierarchy::build(const AxisAlignedBox *objectBoundsList, size_t objectCount, uint32_t maxLeafSize)
+{
+    LUMIERE_EXPECT(objectBoundsList || objectCount == 0);
+    LUMIERE_EXPECT(objectCount < CullingNode::InvalidIndex);
+    LUMIERE_EXPECT(maxLeafSize > 0);
+
+    mNodeList.clear();
+    mObjectIndexList.resize(objectCount);
+    std::iota(std::begin(mObjectIndexList), std::end(mObjectIndexList), 0u);
+    mObjectBoundsList.assign(objectBoundsList, objectBoundsList + objectCount);
+    if (objectCount == 0) {
+        return;
+    }
+
+    mNodeList.reserve(2 * objectCount / maxLeafSize + 1);
+    buildRecursive(0, static_cast<uint32_t>(objectCount), maxLeafSize);
+    LUMIERE_ENSURE(!mNodeList.empty());
+    LUMIERE_ENSURE(mNodeList[0].objectCount == objectCount);
+}
+
+
+void CullingHierarchy::refit(const AxisAlignedBox *objectBoundsList, size_t objectCount)
+{
+    LUMIERE_EXPECT(objectBoundsList || objectCount == 0);
+    LUMIERE_EXPECT(objectCount == mObjectBoundsList.size());
+
+    mObjectBoundsList.assign(objectBoundsList, objectBoundsList + objectCount);
+
+    // children always follow their parent, so a reverse sweep visits children first
+    for (size_t i = mNodeList.size(); i-- > 0;) {
+        auto& node = mNodeList[i];
+        if (node.isLeaf()) {
+            node.bounds = computeBounds(node.firstObject, node.objectCount);
+        } else {
+            const auto& firstChild = mNodeList[i + 1];
+            const auto& secondChild = mNodeList[node.secondChild];
+            node.bounds = AxisAlignedBox(Min(firstChild.bounds.getMinimum(), secondChild.bounds.getMinimum()),
+                                         Max(firstChild.bounds.getMaximum(), secondChild.bounds.getMaximum()));
+        }
+    }
+}
+
+
+const CullingHierarchy::NodeList& CullingHierarchy::getNodeList() const
+{
+    return mNodeList;
+}
+
+
+const CullingHierarchy::ObjectIndexList& CullingHierarchy::getObjectIndexList() const
+{
+    return mObjectIndexList;
+}
+
+
+const CullingHierarchy::BoundsList& CullingHierarchy::getObjectBoundsList() const
+{
+    return mObjectBoundsList;
+}
+
+
+bool CullingHierarchy::empty() const
+{
+    return mNodeList.empty();
+}
+
+
+uint32_t CullingHierarchy::buildRecursive(uint32_t firstObject, uint32_t objectCount, uint32_t maxLeafSize)
+{
+    const auto nodeIndex = static_cast<uint32_t>(mNodeList.size());
+    mNodeList.emplace_back(computeBounds(firstObject, objectCount), firstObject, objectCount);
+    if (objectCount <= maxLeafSize) {
+        return nodeIndex;
+    }
+
+    Vector3f centerMinimum(Infinity, Infinity, Infinity);
+    Vector3f centerMaximum(-Infinity, -Infinity, -Infinity);
+    for (uint32_t i = firstObject; i < firstObject + objectCount; ++ i) {
+        const Vector3f center(mObjectBoundsList[mObjectIndexList[i]].getCenter());
+        centerMinimum = Min(centerMinimum, center);
+        centerMaximum = Max(centerMaximum, center);
+    }
+    const int axis = MaxComponentIndex(centerMaximum - centerMinimum);
+
+    const uint32_t halfCount = objectCount / 2;
+    auto first = std::begin(mObjectIndexList) + firstObject;
+    std::nth_element(first, first + halfCount, first + objectCount, [this, axis](uint32_t lhs, uint32_t rhs) {
+        return mObjectBoundsList[lhs].getCenter()[axis] < mObjectBoundsList[rhs].getCenter()[axis];
+    });
+
+    buildRecursive(firstObject, halfCount, maxLeafSize);
+    const uint32_t secondChild = buildRecursive(firstObject + halfCount, objectCount - halfCount, maxLeafSize);
+    mNodeList[nodeIndex].secondChild = secondChild;
+    return nodeIndex;
+}
+
+
+AxisAlignedBox CullingHierarchy::computeBounds(uint32_t firstObject, uint32_t objectCount) const
+{
+    LUMIERE_EXPECT(objectCount > 0);
+    Vector3f minimum = mObjectBoundsList[mObjectIndexList[firstObject]].getMinimum();
+    Vector3f maximum = mObjectBoundsList[mObjectIndexList[firstObject]].getMaximum();
+    for (uint32_t i = firstObject + 1; i < firstObject + objectCount; ++ i) {
+        const auto& bounds = mObjectBoundsList[mObjectIndexList[i]];
+        minimum = Min(minimum, bounds.getMinimum());
+        maximum = Max(maximum, bounds.getMaximum());
+    }
+    return {minimum, maximum};
+}
+
+
+
+
+HierarchicalCuller::HierarchicalCuller(const CullingHierarchy& hierarchy)
+    : mHierarchy(hierarchy)
+    , mPlaneList(nullptr)
+    , mLastRejectPlaneList()
+    , mStatistics()
+{
+
+}
+
+
+void HierarchicalCuller::cull(Frustum& frustum, std::vector<uint32_t>& visibleObjectList)
+{
+    visibleObjectList.clear();
+    mStatistics = Statistics();
+    if (mHierarchy.empty()) {
+        return;
+    }
+
+    const auto& nodeList = mHierarchy.getNodeList();
+    const auto& objectIndexList = mHierarchy.getObjectIndexList();
+    const auto& objectBoundsList = mHierarchy.getObjectBoundsList();
+
+    // the rejecting plane is remembered for every node followed by every object slot
+    const size_t coherencySize = nodeList.size() + objectIndexList.size();
+    if (mLastRejectPlaneList.size() != coherencySize) {
+        mLastRejectPlaneList.assign(coherencySize, 0);
+    }
+    mPlaneList = &frustum.getFrustumPlaneList();
+
+    struct TraversalEntry {
+        uint32_t nodeIndex;
+        uint32_t planeMask;
+    };
+    TraversalEntry traversalStack[64];
+    size_t stackSize = 0;
+    traversalStack[stackSize++] = {0, (1u << FrustumPlane::_size()) - 1};
+
+    while (stackSize > 0) {
+        const TraversalEntry entry = traversalStack[--stackSize];
+        const auto& node = nodeList[entry.nodeIndex];
+        mStatistics.visitedNodeCount += 1;
+
+        uint32_t childPlaneMask = 0;
+        const TestResult result = testBox(node.bounds, entry.planeMask, childPlaneMask, mLastRejectPlaneList[entry.nodeIndex]);
+        if (result == TestResult::Outside) {
+            continue;
+        }
+
+        const auto firstObject = std::begin(objectIndexList) + node.firstObject;
+        if (result == TestResult::Inside) {
+            visibleObjectList.insert(std::end(visibleObjectList), firstObject, firstObject + node.objectCount);
+        } else if (node.isLeaf()) {
+            for (uint32_t i = node.firstObject; i < node.firstObject + node.objectCount; ++ i) {
+                const uint32_t objectIndex = objectIndexList[i];
+                uint32_t objectPlaneMask = 0;
+                uint8_t& lastRejectPlane = mLastRejectPlaneList[nodeList.size() + i];
+                if (testBox(objectBoundsList[objectIndex], childPlaneMask, objectPlaneMask, lastRejectPlane) != TestResult::Outside) {
+                    visibleObjectList.push_back(objectIndex);
+                }
+            }
+        } else {
+            LUMIERE_ASSERT(stackSize + 2 <= 64);
+            traversalStack[stackSize++] = {node.secondChild, childPlaneMask};
+            traversalStack[stackSize++] = {entry.nodeIndex + 1, childPlaneMask};
+        }
+    }
+}
+
+
+void HierarchicalCuller::reset()
+{
+    mLastRejectPlaneList.clear();
+    mStatistics = Statistics();
+}
+
+
+const HierarchicalCuller::Statistics& HierarchicalCuller::getStatistics() const
+{
+    return mStatistics;
+}
+
+
+HierarchicalCuller::TestResult HierarchicalCuller::testBox(const AxisAlignedBox& box, uint32_t planeMask, uint32_t& childPlaneMask, uint8_t& lastRejectPlane)
+{
+    childPlaneMask = 0;
+    if (planeMask == 0) {
+        return TestResult::Inside;
+    }
+
+    const Point3f center = box.getCenter();
+    const Vector3f halfSize = box.getHalfSize();
+    const auto& planeList = *mPlaneList;
+    auto testPlane = [&](uint32_t planeIndex) {
+        const auto& plane = planeList[planeIndex];
+        const Normal3f normal = plane.getNormal();
+        const Float distance = plane.distanceToPoint(center);
+        const Float radius = std::abs(normal.x) * halfSize.x + std::abs(normal.y) * halfSize.y + std::abs(normal.z) * halfSize.z;
+        mStatistics.planeTestCount += 1;
+        if (distance + radius < 0.0) {
+            return TestResult::Outside;
+        }
+        if (distance - radius < 0.0) {
+            childPlaneMask |= 1u << planeIndex;
+        }
+        return TestResult::Intersecting;
+    };
+
+    // the plane that rejected this box last frame is the most likely one to reject it again
+    const uint32_t coherentPlane = lastRejectPlane;
+    const bool testCoherentPlane = (planeMask & (1u << coherentPlane)) != 0;
+    if (testCoherentPlane && testPlane(coherentPlane) == TestResult::Outside) {
+        mStatistics.coherentRejectCount += 1;
+        return TestResult::Outside;
+    }
+
+    for (uint32_t i = 0; i < FrustumPlane::_size(); ++ i) {
+        if ((planeMask & (1u << i)) == 0 || (testCoherentPlane && i == coherentPlane)) {
+            continue;
+        }
+        if (testPlane(i) == TestResult::Outside) {
+            lastRejectPlane = static_cast<uint8_t>(i);
+            return TestResult::Outside;
+        }
+    }
+    return childPlaneMask == 0 ? TestResult::Inside : TestResult::Intersecting;
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereAxisAlignedBox.h"
+#include "Math/LumiereFrustum.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+struct CullingNode {
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    CullingNode(const AxisAlignedBox& bounds, uint32_t firstObject, uint32_t objectCount)
+        : bounds(bounds), firstObject(firstObject), objectCount(objectCount), secondChild(InvalidIndex) {}
+    bool isLeaf() const { return secondChild == InvalidIndex; }
+
+    // nodes are stored in depth-first order: the first child directly follows its parent
+    // and [firstObject, firstObject + objectCount) covers every object of the subtree
+    AxisAlignedBox bounds;
+    uint32_t firstObject;
+    uint32_t objectCount;
+    uint32_t secondChild;
+};
+
+
+class CullingHierarchy {
+public:
+    using NodeList = std::vector<CullingNode>;
+    using ObjectIndexList = std::vector<uint32_t>;
+    using BoundsList = std::vector<AxisAlignedBox>;
+
+public:
+    CullingHierarchy() = default;
+    ~CullingHierarchy() = default;
+
+    void build(const AxisAlignedBox *objectBoundsList, size_t objectCount, uint32_t maxLeafSize = 4);
+    void refit(const AxisAlignedBox *objectBoundsList, size_t objectCount);
+    const NodeList& getNodeList() const;
+    const ObjectIndexList& getObjectIndexList() const;
+    const BoundsList& getObjectBoundsList() const;
+    bool empty() const;
+
+private:
+    uint32_t buildRecursive(uint32_t firstObject, uint32_t objectCount, uint32_t maxLeafSize);
+    AxisAlignedBox computeBounds(uint32_t firstObject, uint32_t objectCount) const;
+
+private:
+    NodeList mNodeList;
+    ObjectIndexList mObjectIndexList;
+    BoundsList mObjectBoundsList;
+};
+
+
+class HierarchicalCuller {
+public:
+    struct Statistics {
+        size_t visitedNodeCount = 0;
+        size_t planeTestCount = 0;
+        size_t coherentRejectCount = 0;
+    };
+
+public:
+    explicit HierarchicalCuller(const CullingHierarchy& hierarchy);
+    ~HierarchicalCuller() = default;
+
+    void cull(Frustum& frustum, std::vector<uint32_t>& visibleObjectList);
+    void reset();
+    const Statistics& getStatistics() const;
+
+private:
+    enum class TestResult { Outside, Intersecting, Inside };
+    TestResult testBox(const AxisAlignedBox& box, uint32_t planeMask, uint32_t& childPlaneMask, uint8_t& lastRejectPlane);
+
+private:
+    const CullingHierarchy& mHierarchy;
+    const Frustum::FrustumPlaneList *mPlaneList;
+    std::vector<uint8_t> mLastRejectPlaneList;
+    Statistics mStatistics;
+};
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,237 @@
+#include "LumiereLinearBVH.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include "Common/LumiereAssert.h"
+#include "Spatial/LumiereMortonCode.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr size_t BuildGrainSize = 16 * 1024;
+constexpr uint32_t InvalidNode = UINT32_MAX;
+constexpr size_t MaxTraversalDepth = 128;
+
+} // namespace
+
+
+void LinearBVH::build(const Bounds3f *primitiveBoundsList, size_t primitiveCount, ThreadPool *threadPool, uint16_t maxLeafSize)
+{
+    LUMIERE_EXPECT(primitiveBoundsList || primitiveCount == 0);
+    LUMIERE_EXPECT(primitiveCount < InvalidNode / 2);
+    LUMIERE_EXPECT(maxLeafSize > 0);
+
+    mNodeList.clear();
+    mPrimitiveIndexList.resize(primitiveCount);
+    std::iota(std::begin(mPrimitiveIndexList), std::end(mPrimitiveIndexList), 0u);
+    mPrimitiveBoundsList.resize(primitiveCount);
+    if (primitiveCount == 0) {
+        return;
+    }
+
+    std::vector<Point3f> centroidList(primitiveCount);
+    Bounds3f centroidBounds;
+    std::mutex centroidBoundsMutex;
+    ParallelFor(threadPool, primitiveCount, BuildGrainSize, [&](size_t begin, size_t end) {
+        Bounds3f localBounds;
+        for (size_t i = begin; i < end; ++ i) {
+            const Bounds3f& bounds = primitiveBoundsList[i];
+            centroidList[i] = Point3f((bounds.pMin.x + bounds.pMax.x) / 2, (bounds.pMin.y + bounds.pMax.y) / 2, (bounds.pMin.z + bounds.pMax.z) / 2);
+            localBounds = Union(localBounds, centroidList[i]);
+        }
+        std::lock_guard<std::mutex> lock(centroidBoundsMutex);
+        centroidBounds = Union(centroidBounds, localBounds);
+    });
+
+    std::vector<uint64_t> codeList(primitiveCount);
+    ComputeMortonCodes(centroidList.data(), primitiveCount, centroidBounds, codeList.data(), threadPool);
+    SortMortonCodes(codeList.data(), mPrimitiveIndexList.data(), primitiveCount, threadPool);
+
+    // interior nodes are [0, n - 1) with 0 as root, leaf i is node n - 1 + i
+    const auto n = static_cast<int64_t>(primitiveCount);
+    const auto interiorCount = static_cast<size_t>(n - 1);
+    std::vector<uint32_t> childList(2 * interiorCount);
+    std::vector<uint32_t> parentList(2 * primitiveCount - 1, InvalidNode);
+    std::vector<uint32_t> rangeList(2 * interiorCount);
+    std::vector<uint8_t> axisList(interiorCount);
+    std::vector<Bounds3f> nodeBoundsList(2 * primitiveCount - 1);
+
+    // length of the common prefix of two sorted codes, equal codes fall back to their indices
+    auto delta = [&codeList, n](int64_t i, int64_t j) -> int {
+        if (j < 0 || j >= n) {
+            return -1;
+        }
+        const uint64_t difference = codeList[i] ^ codeList[j];
+        if (difference == 0) {
+            return 64 + CountLeadingZeros(static_cast<uint64_t>(i ^ j));
+        }
+        return CountLeadingZeros(difference);
+    };
+
+    ParallelFor(threadPool, interiorCount, BuildGrainSize, [&](size_t begin, size_t end) {
+        for (size_t node = begin; node < end; ++ node) {
+            const auto i = static_cast<int64_t>(node);
+            const int64_t direction = delta(i, i + 1) - delta(i, i - 1) >= 0 ? 1 : -1;
+            const int deltaMin = delta(i, i - direction);
+
+            int64_t lengthMax = 2;
+            while (delta(i, i + lengthMax * direction) > deltaMin) {
+                lengthMax *= 2;
+            }
+            int64_t length = 0;
+            for (int64_t step = lengthMax / 2; step >= 1; step /= 2) {
+                if (delta(i, i + (length + step) * direction) > deltaMin) {
+                    length += step;
+                }
+            }
+            const int64_t j = i + length * direction;
+
+            const int deltaNode = delta(i, j);
+            int64_t split = 0;
+            int64_t step = length;
+            do {
+                step = (step + 1) / 2;
+                if (delta(i, i + (split + step) * direction) > deltaNode) {
+                    split += step;
+                }
+            } while (step > 1);
+            const int64_t gamma = i + split * direction + std::min<int64_t>(direction, 0);
+
+            const int64_t first = std::min(i, j);
+            const int64_t last = std::max(i, j);
+            const auto left = static_cast<uint32_t>(first == gamma ? interiorCount + gamma : gamma);
+            const auto right = static_cast<uint32_t>(last == gamma + 1 ? interiorCount + gamma + 1 : gamma + 1);
+            childList[2 * node] = left;
+            childList[2 * node + 1] = right;
+            parentList[left] = static_cast<uint32_t>(node);
+            parentList[right] = static_cast<uint32_t>(node);
+            rangeList[2 * node] = static_cast<uint32_t>(first);
+            rangeList[2 * node + 1] = static_cast<uint32_t>(last);
+
+            // x, y and z occupy bits 0, 1 and 2 of every triple of the code
+            const int splitPrefix = delta(gamma, gamma + 1);
+            axisList[node] = static_cast<uint8_t>(splitPrefix < 64 ? (63 - splitPrefix) % 3 : 0);
+        }
+    });
+
+    // bounds are merged bottom-up: of the two children reaching a parent, the second one merges
+    std::vector<std::atomic<uint32_t>> visitCountList(interiorCount);
+    ParallelFor(threadPool, primitiveCount, BuildGrainSize, [&](size_t begin, size_t end) {
+        for (size_t leaf = begin; leaf < end; ++ leaf) {
+            const size_t node = interiorCount + leaf;
+            mPrimitiveBoundsList[leaf] = primitiveBoundsList[mPrimitiveIndexList[leaf]];
+            nodeBoundsList[node] = mPrimitiveBoundsList[leaf];
+            uint32_t parent = parentList[node];
+            while (parent != InvalidNode) {
+                if (visitCountList[parent].fetch_add(1, std::memory_order_acq_rel) == 0) {
+                    break;
+                }
+                nodeBoundsList[parent] = Union(nodeBoundsList[childList[2 * parent]], nodeBoundsList[childList[2 * parent + 1]]);
+                parent = parentList[parent];
+            }
+        }
+    });
+
+    // depth-first write-out, subtrees with at most maxLeafSize primitives become one leaf
+    mNodeList.reserve(2 * primitiveCount);
+    struct WriteEntry {
+        uint32_t node;
+        uint32_t parentSlot;
+    };
+    std::vector<WriteEntry> writeStack;
+    writeStack.push_back({0, InvalidNode});
+    if (primitiveCount == 1) {
+        writeStack.back().node = static_cast<uint32_t>(interiorCount);
+    }
+    while (!writeStack.empty()) {
+        const WriteEntry entry = writeStack.back();
+        writeStack.pop_back();
+        const auto slot = static_cast<uint32_t>(mNodeList.size());
+        if (entry.parentSlot != InvalidNode) {
+            mNodeList[entry.parentSlot].offset = slot;
+        }
+
+        const bool isKarrasLeaf = entry.node >= interiorCount;
+        const uint32_t first = isKarrasLeaf ? entry.node - static_cast<uint32_t>(interiorCount) : rangeList[2 * entry.node];
+        const uint32_t last = isKarrasLeaf ? first : rangeList[2 * entry.node + 1];
+        LinearBVHNode node;
+        node.bounds = nodeBoundsList[entry.node];
+        if (last - first + 1 <= maxLeafSize) {
+            node.offset = first;
+            node.primitiveCount = static_cast<uint16_t>(last - first + 1);
+            node.axis = 0;
+            mNodeList.push_back(node);
+            continue;
+        }
+
+        node.offset = InvalidNode;
+        node.primitiveCount = 0;
+        node.axis = axisList[entry.node];
+        mNodeList.push_back(node);
+        writeStack.push_back({childList[2 * entry.node + 1], slot});
+        writeStack.push_back({childList[2 * entry.node], InvalidNode});
+    }
+    LUMIERE_ENSURE(!mNodeList.empty());
+}
+
+
+void LinearBVH::intersect(const Bounds3f& bounds, std::vector<uint32_t>& primitiveList) const
+{
+    primitiveList.clear();
+    if (mNodeList.empty()) {
+        return;
+    }
+
+    uint32_t traversalStack[MaxTraversalDepth];
+    size_t stackSize = 0;
+    uint32_t nodeIndex = 0;
+    while (true) {
+        const LinearBVHNode& node = mNodeList[nodeIndex];
+        if (Overlaps(node.bounds, bounds)) {
+            if (node.isLeaf()) {
+                for (uint32_t i = node.offset; i < node.offset + node.primitiveCount; ++ i) {
+                    if (Overlaps(mPrimitiveBoundsList[i], bounds)) {
+                        primitiveList.push_back(mPrimitiveIndexList[i]);
+                    }
+                }
+            } else {
+                LUMIERE_ASSERT(stackSize < MaxTraversalDepth);
+                traversalStack[stackSize++] = node.offset;
+                nodeIndex += 1;
+                continue;
+            }
+        }
+        if (stackSize == 0) {
+            break;
+        }
+        nodeIndex = traversalStack[--stackSize];
+    }
+}
+
+
+const LinearBVH::NodeList& LinearBVH::getNodeList() const
+{
+    return mNodeList;
+}
+
+
+const LinearBVH::PrimitiveIndexList& LinearBVH::getPrimitiveIndexList() const
+{
+    return mPrimitiveIndexList;
+}
+
+
+const LinearBVH::BoundsList& LinearBVH::getPrimitiveBoundsList() const
+{
+    return mPrimitiveBoundsList;
+}
+
+
+bool LinearBVH::empty() const
+{
+    return mNodeList.empty();
+}
+
+END_LUMIERE_NAMESPACE
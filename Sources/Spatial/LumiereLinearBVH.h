@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereVector.h"
+#include "Thread/LumiereThreadPool.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+struct LinearBVHNode {
+    bool isLeaf() const { return primitiveCount > 0; }
+
+    // nodes are stored in depth-first order: the first child directly follows an interior node,
+    // offset is the second child of an interior node or the first primitive slot of a leaf,
+    // primitive bounds are kept in the same sorted order so a leaf reads one contiguous range
+    Bounds3f bounds;
+    uint32_t offset;
+    uint16_t primitiveCount;
+    uint8_t axis;
+};
+
+
+// Karras-style builder: primitives are sorted by the Morton code of their centroids and every
+// interior node of the resulting radix tree is found independently, so the build runs in
+// parallel and in linear time; the tree is then written out depth first for traversal
+class LinearBVH {
+public:
+    using NodeList = std::vector<LinearBVHNode>;
+    using PrimitiveIndexList = std::vector<uint32_t>;
+    using BoundsList = std::vector<Bounds3f>;
+
+public:
+    LinearBVH() = default;
+    ~LinearBVH() = default;
+
+    void build(const Bounds3f *primitiveBoundsList, size_t primitiveCount, ThreadPool *threadPool = nullptr, uint16_t maxLeafSize = 4);
+    void intersect(const Bounds3f& bounds, std::vector<uint32_t>& primitiveList) const;
+    const NodeList& getNodeList() const;
+    const PrimitiveIndexList& getPrimitiveIndexList() const;
+    const BoundsList& getPrimitiveBoundsList() const;
+    bool empty() const;
+
+private:
+    NodeList mNodeList;
+    PrimitiveIndexList mPrimitiveIndexList;
+    BoundsList mPrimitiveBoundsList;
+};
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,210 @@
+#include "LumiereMortonCode.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr size_t CodeGrainSize = 16 * 1024;
+constexpr size_t SortBlockSize = 64 * 1024;
+
+
+// Skilling's in-place transform from axes to the transposed Hilbert index: afterwards the
+// index bits are read most significant first as axis[0], axis[1], axis[2] of every level
+void TransposeHilbertAxes(uint32_t axis[3], int bitsPerAxis)
+{
+    const uint32_t highestBit = 1u << (bitsPerAxis - 1);
+    for (uint32_t q = highestBit; q > 1; q >>= 1) {
+        const uint32_t p = q - 1;
+        for (int i = 0; i < 3; ++ i) {
+            if (axis[i] & q) {
+                axis[0] ^= p;
+            } else {
+                const uint32_t t = (axis[0] ^ axis[i]) & p;
+                axis[0] ^= t;
+                axis[i] ^= t;
+            }
+        }
+    }
+
+    axis[1] ^= axis[0];
+    axis[2] ^= axis[1];
+    uint32_t t = 0;
+    for (uint32_t q = highestBit; q > 1; q >>= 1) {
+        if (axis[2] & q) {
+            t ^= q - 1;
+        }
+    }
+    for (int i = 0; i < 3; ++ i) {
+        axis[i] ^= t;
+    }
+}
+
+
+template <typename Code, typename Encode>
+void ComputeCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, Code *codeList, ThreadPool *threadPool, int bitsPerAxis, Encode encode)
+{
+    LUMIERE_EXPECT((pointList && codeList) || count == 0);
+    const Float cellCount = static_cast<Float>(1u << bitsPerAxis);
+    const Vector3f diagonal = bounds.Diagonal();
+    Float scale[3];
+    for (int axis = 0; axis < 3; ++ axis) {
+        scale[axis] = diagonal[axis] > 0 ? cellCount / diagonal[axis] : 0;
+    }
+
+    auto computeRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++ i) {
+            uint32_t cell[3];
+            for (int axis = 0; axis < 3; ++ axis) {
+                const Float offset = (pointList[i][axis] - bounds.pMin[axis]) * scale[axis];
+                cell[axis] = static_cast<uint32_t>(std::clamp<Float>(offset, 0, cellCount - 1));
+            }
+            codeList[i] = encode(cell[0], cell[1], cell[2]);
+        }
+    };
+    ParallelFor(threadPool, count, CodeGrainSize, computeRange);
+}
+
+
+template <typename Code>
+void RadixSort(Code *codeList, uint32_t *indexList, size_t count, ThreadPool *threadPool)
+{
+    LUMIERE_EXPECT((codeList && indexList) || count == 0);
+    constexpr int DigitBits = 8;
+    constexpr size_t BucketCount = size_t(1) << DigitBits;
+    constexpr int PassCount = sizeof(Code) * 8 / DigitBits;
+    using Histogram = std::array<size_t, BucketCount>;
+    if (count < 2) {
+        return;
+    }
+
+    // every block keeps its own histogram and scatter offsets, which keeps each pass stable
+    size_t blockCount = 1;
+    if (threadPool && threadPool->getWorkerCount() > 0) {
+        blockCount = std::clamp<size_t>(count / SortBlockSize, 1, 4 * (threadPool->getWorkerCount() + 1));
+    }
+    const size_t blockSize = (count + blockCount - 1) / blockCount;
+    auto forEachBlock = [&](const auto& function) {
+        if (blockCount == 1) {
+            function(0);
+            return;
+        }
+        threadPool->parallelFor(blockCount, 1, [&function](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++ block) {
+                function(block);
+            }
+        });
+    };
+
+    std::vector<Code> codeBuffer(count);
+    std::vector<uint32_t> indexBuffer(count);
+    std::vector<Histogram> histogramList(blockCount);
+    Code *sourceCode = codeList;
+    uint32_t *sourceIndex = indexList;
+    Code *destinationCode = codeBuffer.data();
+    uint32_t *destinationIndex = indexBuffer.data();
+
+    for (int pass = 0; pass < PassCount; ++ pass) {
+        const int shift = pass * DigitBits;
+        forEachBlock([&](size_t block) {
+            Histogram& histogram = histogramList[block];
+            histogram.fill(0);
+            const size_t end = std::min(count, (block + 1) * blockSize);
+            for (size_t i = block * blockSize; i < end; ++ i) {
+                histogram[(sourceCode[i] >> shift) & (BucketCount - 1)] += 1;
+            }
+        });
+
+        bool isSingleBucket = false;
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < BucketCount; ++ bucket) {
+            size_t bucketSize = 0;
+            for (auto& histogram : histogramList) {
+                const size_t blockBucketSize = histogram[bucket];
+                histogram[bucket] = offset + bucketSize;
+                bucketSize += blockBucketSize;
+            }
+            isSingleBucket = isSingleBucket || bucketSize == count;
+            offset += bucketSize;
+        }
+        if (isSingleBucket) {
+            continue;
+        }
+
+        forEachBlock([&](size_t block) {
+            Histogram& position = histogramList[block];
+            const size_t end = std::min(count, (block + 1) * blockSize);
+            for (size_t i = block * blockSize; i < end; ++ i) {
+                const size_t target = position[(sourceCode[i] >> shift) & (BucketCount - 1)]++;
+                destinationCode[target] = sourceCode[i];
+                destinationIndex[target] = sourceIndex[i];
+            }
+        });
+        std::swap(sourceCode, destinationCode);
+        std::swap(sourceIndex, destinationIndex);
+    }
+
+    if (sourceCode != codeList) {
+        std::copy(sourceCode, sourceCode + count, codeList);
+        std::copy(sourceIndex, sourceIndex + count, indexList);
+    }
+}
+
+} // namespace
+
+
+uint32_t EncodeHilbert3x10(uint32_t x, uint32_t y, uint32_t z)
+{
+    uint32_t axis[3] = {x, y, z};
+    TransposeHilbertAxes(axis, MortonBitsPerAxis32);
+    return EncodeMorton3x10(axis[2], axis[1], axis[0]);
+}
+
+
+uint64_t EncodeHilbert3x21(uint32_t x, uint32_t y, uint32_t z)
+{
+    uint32_t axis[3] = {x, y, z};
+    TransposeHilbertAxes(axis, MortonBitsPerAxis64);
+    return EncodeMorton3x21(axis[2], axis[1], axis[0]);
+}
+
+
+void ComputeMortonCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, uint32_t *codeList, ThreadPool *threadPool)
+{
+    ComputeCodes(pointList, count, bounds, codeList, threadPool, MortonBitsPerAxis32, EncodeMorton3x10);
+}
+
+
+void ComputeMortonCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, uint64_t *codeList, ThreadPool *threadPool)
+{
+    ComputeCodes(pointList, count, bounds, codeList, threadPool, MortonBitsPerAxis64, EncodeMorton3x21);
+}
+
+
+void ComputeHilbertCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, uint32_t *codeList, ThreadPool *threadPool)
+{
+    ComputeCodes(pointList, count, bounds, codeList, threadPool, MortonBitsPerAxis32, EncodeHilbert3x10);
+}
+
+
+void ComputeHilbertCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, uint64_t *codeList, ThreadPool *threadPool)
+{
+    ComputeCodes(pointList, count, bounds, codeList, threadPool, MortonBitsPerAxis64, EncodeHilbert3x21);
+}
+
+
+void SortMortonCodes(uint32_t *codeList, uint32_t *indexList, size_t count, ThreadPool *threadPool)
+{
+    RadixSort(codeList, indexList, count, threadPool);
+}
+
+
+void SortMortonCodes(uint64_t *codeList, uint32_t *indexList, size_t count, ThreadPool *threadPool)
+{
+    RadixSort(codeList, indexList, count, threadPool);
+}
+
+END_LUMIERE_NAMESPACE
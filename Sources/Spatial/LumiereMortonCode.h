@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "Common/LumiereMacro.h"
+#include "Common/LumiereSIMD.h"
+#include "Math/LumiereVector.h"
+#include "Thread/LumiereThreadPool.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// codes interleave x into bit 0, y into bit 1 and z into bit 2 of every triple
+constexpr int MortonBitsPerAxis32 = 10;
+constexpr int MortonBitsPerAxis64 = 21;
+
+inline uint32_t SpreadBits3x10(uint32_t value)
+{
+#if defined(LUMIERE_ENABLE_BMI2)
+    return _pdep_u32(value, 0x09249249u);
+#else
+    value &= 0x000003ffu;
+    value = (value | (value << 16)) & 0x030000ffu;
+    value = (value | (value << 8)) & 0x0300f00fu;
+    value = (value | (value << 4)) & 0x030c30c3u;
+    value = (value | (value << 2)) & 0x09249249u;
+    return value;
+#endif
+}
+
+
+inline uint64_t SpreadBits3x21(uint64_t value)
+{
+#if defined(LUMIERE_ENABLE_BMI2)
+    return _pdep_u64(value, 0x1249249249249249ull);
+#else
+    value &= 0x00000000001fffffull;
+    value = (value | (value << 32)) & 0x001f00000000ffffull;
+    value = (value | (value << 16)) & 0x001f0000ff0000ffull;
+    value = (value | (value << 8)) & 0x100f00f00f00f00full;
+    value = (value | (value << 4)) & 0x10c30c30c30c30c3ull;
+    value = (value | (value << 2)) & 0x1249249249249249ull;
+    return value;
+#endif
+}
+
+
+inline uint32_t EncodeMorton3x10(uint32_t x, uint32_t y, uint32_t z)
+{
+    return SpreadBits3x10(x) | (SpreadBits3x10(y) << 1) | (SpreadBits3x10(z) << 2);
+}
+
+
+inline uint64_t EncodeMorton3x21(uint32_t x, uint32_t y, uint32_t z)
+{
+    return SpreadBits3x21(x) | (SpreadBits3x21(y) << 1) | (SpreadBits3x21(z) << 2);
+}
+
+
+inline int CountLeadingZeros(uint64_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    return _BitScanReverse64(&index, value) ? 63 - static_cast<int>(index) : 64;
+#else
+    return value == 0 ? 64 : __builtin_clzll(value);
+#endif
+}
+
+
+uint32_t EncodeHilbert3x10(uint32_t x, uint32_t y, uint32_t z);
+uint64_t EncodeHilbert3x21(uint32_t x, uint32_t y, uint32_t z);
+
+// points are quantized on a 2^bits grid spanning bounds, points outside are clamped to it
+void ComputeMortonCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, uint32_t *codeList, ThreadPool *threadPool = nullptr);
+void ComputeMortonCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, uint64_t *codeList, ThreadPool *threadPool = nullptr);
+void ComputeHilbertCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, uint32_t *codeList, ThreadPool *threadPool = nullptr);
+void ComputeHilbertCodes(const Point3f *pointList, size_t count, const Bounds3f& bounds, uint64_t *codeList, ThreadPool *threadPool = nullptr);
+
+// stable LSD radix sort of the codes that carries indexList along, 8 bits per pass;
+// passes in which every code shares the same digit are skipped
+void SortMortonCodes(uint32_t *codeList, uint32_t *indexList, size_t count, ThreadPool *threadPool = nullptr);
+void SortMortonCodes(uint64_t *codeList, uint32_t *indexList, size_t count, ThreadPool *threadPool = nullptr);
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,128 @@
+#include "LumiereMultiViewCuller.h"
+#include <algorithm>
+#include <bitset>
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+VisibilityBitset::VisibilityBitset(size_t size) : mWordList(), mSize(0)
+{
+    resize(size);
+    LUMIERE_ENSURE(mSize == size);
+}
+
+
+void VisibilityBitset::resize(size_t size)
+{
+    mSize = size;
+    mWordList.assign((size + BitsPerWord - 1) / BitsPerWord, 0);
+}
+
+
+bool VisibilityBitset::test(size_t index) const
+{
+    LUMIERE_EXPECT(index < mSize);
+    return (mWordList[index / BitsPerWord] >> (index % BitsPerWord)) & 1u;
+}
+
+
+size_t VisibilityBitset::size() const
+{
+    return mSize;
+}
+
+
+size_t VisibilityBitset::count() const
+{
+    size_t visibleCount = 0;
+    for (Word word : mWordList) {
+        visibleCount += std::bitset<BitsPerWord>(word).count();
+    }
+    return visibleCount;
+}
+
+
+size_t VisibilityBitset::getWordCount() const
+{
+    return mWordList.size();
+}
+
+
+VisibilityBitset::Word* VisibilityBitset::getWordList()
+{
+    return mWordList.data();
+}
+
+
+const VisibilityBitset::Word* VisibilityBitset::getWordList() const
+{
+    return mWordList.data();
+}
+
+
+
+
+MultiViewCuller::MultiViewCuller(ThreadPool *threadPool, size_t grainSize)
+    : mThreadPool(threadPool)
+    , mGrainSize(grainSize)
+    , mPlaneSetList()
+{
+    static_assert(VisibilityBitset::BitsPerWord % AxisAlignedBoxBlock::Size == 0, "a box block must not straddle two bitset words");
+    LUMIERE_ENSURE(mGrainSize > 0);
+
+    // grains are whole bitset words so that no two threads write the same word
+    mGrainSize = (mGrainSize + VisibilityBitset::BitsPerWord - 1) / VisibilityBitset::BitsPerWord * VisibilityBitset::BitsPerWord;
+}
+
+
+void MultiViewCuller::cull(const std::vector<Frustum*>& frustumList,
+                           const AxisAlignedBox *axisAlignedBoxList,
+                           size_t boxCount,
+                           std::vector<VisibilityBitset>& visibilityList)
+{
+    LUMIERE_EXPECT(axisAlignedBoxList || boxCount == 0);
+
+    // frustums update lazily, so take a snapshot of every plane set before going wide
+    mPlaneSetList.clear();
+    for (Frustum *frustum : frustumList) {
+        LUMIERE_EXPECT(frustum);
+        mPlaneSetList.push_back(frustum->getCullingPlaneSet());
+    }
+
+    visibilityList.resize(frustumList.size());
+    for (auto& visibility : visibilityList) {
+        visibility.resize(boxCount);
+    }
+    if (boxCount == 0 || frustumList.empty()) {
+        return;
+    }
+
+    auto cullFunction = [this, axisAlignedBoxList, &visibilityList](size_t begin, size_t end) {
+        cullRange(axisAlignedBoxList, begin, end, visibilityList);
+    };
+    ParallelFor(mThreadPool, boxCount, mGrainSize, cullFunction);
+}
+
+
+void MultiViewCuller::cullRange(const AxisAlignedBox *axisAlignedBoxList, size_t begin, size_t end, std::vector<VisibilityBitset>& visibilityList) const
+{
+    LUMIERE_EXPECT(begin % VisibilityBitset::BitsPerWord == 0);
+
+    // every box block is loaded once and tested against all views while it is hot in cache
+    AxisAlignedBoxBlock block;
+    for (size_t first = begin; first < end; first += AxisAlignedBoxBlock::Size) {
+        const size_t blockSize = std::min(AxisAlignedBoxBlock::Size, end - first);
+        block.load(axisAlignedBoxList + first, blockSize);
+
+        const size_t wordIndex = first / VisibilityBitset::BitsPerWord;
+        const size_t bitOffset = first % VisibilityBitset::BitsPerWord;
+        const uint32_t validMask = (1u << blockSize) - 1u;
+        for (size_t view = 0; view < mPlaneSetList.size(); ++ view) {
+            const uint32_t visibleMask = CullAxisAlignedBoxBlock(mPlaneSetList[view], block) & validMask;
+            VisibilityBitset::Word& word = visibilityList[view].getWordList()[wordIndex];
+            word = (bitOffset == 0 ? 0 : word) | (static_cast<VisibilityBitset::Word>(visibleMask) << bitOffset);
+        }
+    }
+}
+
+END_LUMIERE_NAMESPACE
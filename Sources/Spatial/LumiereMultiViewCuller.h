@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereAxisAlignedBox.h"
+#include "Math/LumiereCullingKernel.h"
+#include "Math/LumiereFrustum.h"
+#include "Thread/LumiereThreadPool.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+class VisibilityBitset {
+public:
+    using Word = uint64_t;
+    static constexpr size_t BitsPerWord = 64;
+
+public:
+    explicit VisibilityBitset(size_t size = 0);
+    ~VisibilityBitset() = default;
+
+    void resize(size_t size);
+    bool test(size_t index) const;
+    size_t size() const;
+    size_t count() const;
+    size_t getWordCount() const;
+    Word* getWordList();
+    const Word* getWordList() const;
+
+private:
+    std::vector<Word> mWordList;
+    size_t mSize;
+};
+
+
+class MultiViewCuller {
+public:
+    explicit MultiViewCuller(ThreadPool *threadPool = nullptr, size_t grainSize = 4096);
+    ~MultiViewCuller() = default;
+
+    void cull(const std::vector<Frustum*>& frustumList,
+              const AxisAlignedBox *axisAlignedBoxList,
+              size_t boxCount,
+              std::vector<VisibilityBitset>& visibilityList);
+
+private:
+    void cullRange(const AxisAlignedBox *axisAlignedBoxList, size_t begin, size_t end, std::vector<VisibilityBitset>& visibilityList) const;
+
+private:
+    ThreadPool *mThreadPool;
+    size_t mGrainSize;
+    std::vector<CullingPlaneSet> mPlaneSetList;
+};
+
+END_LUMIERE_NAMESPACE
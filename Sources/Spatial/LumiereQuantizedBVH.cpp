@@ -0,0 +1,115 @@
+#include "LumiereQuantizedBVH.h"
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr size_t MaxTraversalDepth = 128;
+constexpr uint32_t InvalidNode = UINT32_MAX;
+
+} // namespace
+
+
+template <typename Q>
+void QuantizedBVH<Q>::build(const LinearBVH& bvh)
+{
+    const auto& sourceNodeList = bvh.getNodeList();
+    mNodeList.clear();
+    mRootBounds = sourceNodeList.empty() ? Bounds3f() : sourceNodeList[0].bounds;
+    mPrimitiveIndexList = bvh.getPrimitiveIndexList();
+    mPrimitiveBoundsList = bvh.getPrimitiveBoundsList();
+    if (sourceNodeList.empty()) {
+        return;
+    }
+
+    // parents precede their children, so one forward pass sees every parent decoded first
+    const size_t nodeCount = sourceNodeList.size();
+    std::vector<uint32_t> parentList(nodeCount, InvalidNode);
+    std::vector<Bounds3f> decodedBoundsList(nodeCount);
+    mNodeList.resize(nodeCount);
+    for (size_t i = 0; i < nodeCount; ++ i) {
+        const LinearBVHNode& sourceNode = sourceNodeList[i];
+        const Bounds3f& parentBounds = parentList[i] == InvalidNode ? mRootBounds : decodedBoundsList[parentList[i]];
+        const QuantizationFrame frame = MakeQuantizationFrame<Q>(parentBounds);
+
+        Node& node = mNodeList[i];
+        node.bounds = Quantize<Q>(frame, sourceNode.bounds);
+        node.primitiveCount = sourceNode.primitiveCount;
+        node.axis = sourceNode.axis;
+        node.offset = sourceNode.offset;
+        decodedBoundsList[i] = Dequantize(frame, node.bounds);
+        if (!sourceNode.isLeaf()) {
+            parentList[i + 1] = static_cast<uint32_t>(i);
+            parentList[sourceNode.offset] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+
+template <typename Q>
+void QuantizedBVH<Q>::intersect(const Bounds3f& bounds, std::vector<uint32_t>& primitiveList) const
+{
+    primitiveList.clear();
+    if (mNodeList.empty()) {
+        return;
+    }
+
+    // the frame a node was quantized in travels with it on the stack
+    struct TraversalEntry {
+        uint32_t nodeIndex;
+        QuantizationFrame frame;
+    };
+    TraversalEntry traversalStack[MaxTraversalDepth];
+    size_t stackSize = 0;
+    TraversalEntry entry{0, MakeQuantizationFrame<Q>(mRootBounds)};
+    while (true) {
+        const Node& node = mNodeList[entry.nodeIndex];
+        if (Overlaps(entry.frame, node.bounds, bounds)) {
+            if (node.isLeaf()) {
+                for (uint32_t i = node.offset; i < node.offset + node.primitiveCount; ++ i) {
+                    if (Overlaps(mPrimitiveBoundsList[i], bounds)) {
+                        primitiveList.push_back(mPrimitiveIndexList[i]);
+                    }
+                }
+            } else {
+                LUMIERE_ASSERT(stackSize < MaxTraversalDepth);
+                const QuantizationFrame childFrame = MakeQuantizationFrame<Q>(Dequantize(entry.frame, node.bounds));
+                traversalStack[stackSize++] = {node.offset, childFrame};
+                entry = {entry.nodeIndex + 1, childFrame};
+                continue;
+            }
+        }
+        if (stackSize == 0) {
+            break;
+        }
+        entry = traversalStack[--stackSize];
+    }
+}
+
+
+template <typename Q>
+const typename QuantizedBVH<Q>::NodeList& QuantizedBVH<Q>::getNodeList() const
+{
+    return mNodeList;
+}
+
+
+template <typename Q>
+const Bounds3f& QuantizedBVH<Q>::getRootBounds() const
+{
+    return mRootBounds;
+}
+
+
+template <typename Q>
+bool QuantizedBVH<Q>::empty() const
+{
+    return mNodeList.empty();
+}
+
+
+template class QuantizedBVH<uint8_t>;
+template class QuantizedBVH<uint16_t>;
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereQuantizedBounds.h"
+#include "Spatial/LumiereLinearBVH.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+template <typename Q>
+struct QuantizedBVHNode {
+    bool isLeaf() const { return primitiveCount > 0; }
+
+    // same depth-first layout as LinearBVHNode; bounds are quantized against the decoded
+    // bounds of the parent, the root against the full precision bounds of the tree
+    QuantizedBounds3<Q> bounds;
+    uint16_t primitiveCount;
+    uint8_t axis;
+    uint32_t offset;
+};
+
+
+// compressed copy of a LinearBVH: with 8 bit offsets a node takes 16 bytes instead of the 32 or
+// 56 of LinearBVHNode, and child bounds are decoded on the fly during traversal
+template <typename Q>
+class QuantizedBVH {
+public:
+    using Node = QuantizedBVHNode<Q>;
+    using NodeList = std::vector<Node>;
+
+public:
+    QuantizedBVH() = default;
+    ~QuantizedBVH() = default;
+
+    void build(const LinearBVH& bvh);
+    void intersect(const Bounds3f& bounds, std::vector<uint32_t>& primitiveList) const;
+    const NodeList& getNodeList() const;
+    const Bounds3f& getRootBounds() const;
+    bool empty() const;
+
+private:
+    NodeList mNodeList;
+    Bounds3f mRootBounds;
+    LinearBVH::PrimitiveIndexList mPrimitiveIndexList;
+    LinearBVH::BoundsList mPrimitiveBoundsList;
+};
+
+extern template class QuantizedBVH<uint8_t>;
+extern template class QuantizedBVH<uint16_t>;
+
+END_LUMIERE_NAMESPACE
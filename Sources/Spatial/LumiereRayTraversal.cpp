@@ -0,0 +1,92 @@
+#include "LumiereRayTraversal.h"
+#include <numeric>
+#include "Spatial/LumiereMortonCode.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+void RayStream::addRay(const Ray& ray)
+{
+    LUMIERE_EXPECT(mRayList.size() < UINT32_MAX);
+    mSourceIndexList.push_back(static_cast<uint32_t>(mRayList.size()));
+    mRayList.push_back(ray);
+}
+
+
+void RayStream::clear()
+{
+    mRayList.clear();
+    mSourceIndexList.clear();
+}
+
+
+void RayStream::sort(ThreadPool *threadPool)
+{
+    const size_t rayCount = mRayList.size();
+    if (rayCount < 2) {
+        return;
+    }
+
+    std::vector<Point3f> originList(rayCount);
+    Bounds3f originBounds;
+    for (size_t i = 0; i < rayCount; ++ i) {
+        originList[i] = mRayList[i].o;
+        originBounds = Union(originBounds, originList[i]);
+    }
+
+    // the octant takes the top three bits above a 27 bit Morton code of the origin
+    std::vector<uint32_t> keyList(rayCount);
+    ComputeMortonCodes(originList.data(), rayCount, originBounds, keyList.data(), threadPool);
+    for (size_t i = 0; i < rayCount; ++ i) {
+        const Ray& ray = mRayList[i];
+        const auto octant = static_cast<uint32_t>(ray.dirIsNeg[0] | (ray.dirIsNeg[1] << 1) | (ray.dirIsNeg[2] << 2));
+        keyList[i] = (octant << 27) | (keyList[i] >> 3);
+    }
+
+    std::vector<uint32_t> orderList(rayCount);
+    std::iota(std::begin(orderList), std::end(orderList), 0u);
+    SortMortonCodes(keyList.data(), orderList.data(), rayCount, threadPool);
+
+    RayList sortedRayList(rayCount);
+    IndexList sortedSourceIndexList(rayCount);
+    for (size_t i = 0; i < rayCount; ++ i) {
+        sortedRayList[i] = mRayList[orderList[i]];
+        sortedSourceIndexList[i] = mSourceIndexList[orderList[i]];
+    }
+    mRayList.swap(sortedRayList);
+    mSourceIndexList.swap(sortedSourceIndexList);
+}
+
+
+Ray& RayStream::operator[](size_t index)
+{
+    LUMIERE_EXPECT(index < mRayList.size());
+    return mRayList[index];
+}
+
+
+const Ray& RayStream::operator[](size_t index) const
+{
+    LUMIERE_EXPECT(index < mRayList.size());
+    return mRayList[index];
+}
+
+
+uint32_t RayStream::getSourceIndex(size_t index) const
+{
+    LUMIERE_EXPECT(index < mSourceIndexList.size());
+    return mSourceIndexList[index];
+}
+
+
+size_t RayStream::size() const
+{
+    return mRayList.size();
+}
+
+
+bool RayStream::empty() const
+{
+    return mRayList.empty();
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,189 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Common/LumiereAssert.h"
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereRay.h"
+#include "Spatial/LumiereLinearBVH.h"
+#include "Thread/LumiereThreadPool.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+class RayStream {
+public:
+    using RayList = std::vector<Ray>;
+    using IndexList = std::vector<uint32_t>;
+
+public:
+    RayStream() = default;
+    ~RayStream() = default;
+
+    void addRay(const Ray& ray);
+    void clear();
+    // groups rays by direction octant and then by the Morton code of their origin, so that
+    // consecutive rays form coherent packets; getSourceIndex() maps back to insertion order
+    void sort(ThreadPool *threadPool = nullptr);
+    Ray& operator[](size_t index);
+    const Ray& operator[](size_t index) const;
+    uint32_t getSourceIndex(size_t index) const;
+    size_t size() const;
+    bool empty() const;
+
+private:
+    RayList mRayList;
+    IndexList mSourceIndexList;
+};
+
+
+// Intersectors are called for every primitive whose bounds the ray reaches and shorten tMax on
+// a hit; setting tMax to zero ends the traversal of that ray, e.g. for shadow rays.
+//   single ray and stream: void(uint32_t primitiveIndex, Ray& ray)
+//   packet:                void(uint32_t primitiveIndex, RayPacket& packet, uint32_t laneMask)
+
+namespace RayTraversalDetail {
+
+constexpr size_t MaxTraversalDepth = 128;
+constexpr size_t StreamPacketGrainSize = 64;
+
+
+inline uint32_t GetFinishedLaneMask(const RayPacket& packet)
+{
+    return static_cast<uint32_t>(MoveMask(RayPacket::Lanes::Load(packet.tMax) <= RayPacket::Lanes(Float(0))));
+}
+
+} // namespace RayTraversalDetail
+
+
+template <typename Intersector>
+void TraverseRay(const LinearBVH& bvh, Ray& ray, Intersector&& intersector)
+{
+    const auto& nodeList = bvh.getNodeList();
+    const auto& primitiveIndexList = bvh.getPrimitiveIndexList();
+    const auto& primitiveBoundsList = bvh.getPrimitiveBoundsList();
+    if (nodeList.empty()) {
+        return;
+    }
+
+    uint32_t traversalStack[RayTraversalDetail::MaxTraversalDepth];
+    size_t stackSize = 0;
+    uint32_t nodeIndex = 0;
+    while (ray.tMax > 0) {
+        const LinearBVHNode& node = nodeList[nodeIndex];
+        if (ray.intersectP(node.bounds)) {
+            if (node.isLeaf()) {
+                for (uint32_t i = node.offset; i < node.offset + node.primitiveCount && ray.tMax > 0; ++ i) {
+                    if (ray.intersectP(primitiveBoundsList[i])) {
+                        intersector(primitiveIndexList[i], ray);
+                    }
+                }
+            } else {
+                // the first child holds the lower half along the split axis, visit the near one first
+                LUMIERE_ASSERT(stackSize < RayTraversalDetail::MaxTraversalDepth);
+                if (ray.dirIsNeg[node.axis]) {
+                    traversalStack[stackSize++] = nodeIndex + 1;
+                    nodeIndex = node.offset;
+                } else {
+                    traversalStack[stackSize++] = node.offset;
+                    nodeIndex = nodeIndex + 1;
+                }
+                continue;
+            }
+        }
+        if (stackSize == 0) {
+            break;
+        }
+        nodeIndex = traversalStack[--stackSize];
+    }
+}
+
+
+template <typename Intersector>
+void TraverseRayPacket(const LinearBVH& bvh, RayPacket& packet, Intersector&& intersector)
+{
+    const auto& nodeList = bvh.getNodeList();
+    const auto& primitiveIndexList = bvh.getPrimitiveIndexList();
+    const auto& primitiveBoundsList = bvh.getPrimitiveBoundsList();
+    if (nodeList.empty()) {
+        return;
+    }
+
+    // nodes are fetched once for the whole packet and skipped as soon as no lane reaches them
+    uint32_t traversalStack[RayTraversalDetail::MaxTraversalDepth];
+    size_t stackSize = 0;
+    uint32_t nodeIndex = 0;
+    packet.activeMask &= ~RayTraversalDetail::GetFinishedLaneMask(packet);
+    while (packet.activeMask != 0) {
+        const LinearBVHNode& node = nodeList[nodeIndex];
+        const uint32_t hitMask = packet.intersectP(node.bounds);
+        if (hitMask != 0) {
+            if (node.isLeaf()) {
+                for (uint32_t i = node.offset; i < node.offset + node.primitiveCount && packet.activeMask != 0; ++ i) {
+                    const uint32_t primitiveMask = packet.intersectP(primitiveBoundsList[i]);
+                    if (primitiveMask != 0) {
+                        intersector(primitiveIndexList[i], packet, primitiveMask);
+                        packet.activeMask &= ~RayTraversalDetail::GetFinishedLaneMask(packet);
+                    }
+                }
+            } else {
+                // coherent packets share their direction signs, the first hit lane decides the order
+                int firstLane = 0;
+                while ((hitMask & (1u << firstLane)) == 0) {
+                    ++ firstLane;
+                }
+                LUMIERE_ASSERT(stackSize < RayTraversalDetail::MaxTraversalDepth);
+                if (packet.invDir[node.axis][firstLane] < 0) {
+                    traversalStack[stackSize++] = nodeIndex + 1;
+                    nodeIndex = node.offset;
+                } else {
+                    traversalStack[stackSize++] = node.offset;
+                    nodeIndex = nodeIndex + 1;
+                }
+                continue;
+            }
+        }
+        if (stackSize == 0) {
+            break;
+        }
+        nodeIndex = traversalStack[--stackSize];
+    }
+}
+
+
+// consecutive rays of the stream are traversed together as packets, call sort() first for
+// incoherent input; with a thread pool the intersector is called concurrently for different rays
+template <typename Intersector>
+void TraverseRayStream(const LinearBVH& bvh, RayStream& stream, Intersector&& intersector, ThreadPool *threadPool = nullptr)
+{
+    const size_t packetCount = (stream.size() + RayPacket::Size - 1) / RayPacket::Size;
+    auto traversePackets = [&](size_t beginPacket, size_t endPacket) {
+        for (size_t packetIndex = beginPacket; packetIndex < endPacket; ++ packetIndex) {
+            const size_t firstRay = packetIndex * RayPacket::Size;
+            const size_t rayCount = std::min<size_t>(RayPacket::Size, stream.size() - firstRay);
+            RayPacket packet;
+            for (size_t lane = 0; lane < rayCount; ++ lane) {
+                packet.setRay(static_cast<int>(lane), stream[firstRay + lane]);
+            }
+            // unused lanes are filled with a copy of the first ray and stay inactive
+            for (size_t lane = rayCount; lane < RayPacket::Size; ++ lane) {
+                packet.setRay(static_cast<int>(lane), stream[firstRay]);
+                packet.activeMask &= ~(1u << lane);
+            }
+
+            TraverseRayPacket(bvh, packet, [&](uint32_t primitiveIndex, RayPacket& rayPacket, uint32_t laneMask) {
+                for (uint32_t lane = 0; lane < RayPacket::Size; ++ lane) {
+                    if ((laneMask & (1u << lane)) == 0) {
+                        continue;
+                    }
+                    Ray& ray = stream[firstRay + lane];
+                    intersector(primitiveIndex, ray);
+                    rayPacket.tMax[lane] = ray.tMax;
+                }
+            });
+        }
+    };
+
+    ParallelFor(threadPool, packetCount, RayTraversalDetail::StreamPacketGrainSize, traversePackets);
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,452 @@
+#include "LumiereSpatialHashGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+#include "Common/LumiereAssert.h"
+#include "Exception/LumiereException.h"
+#include "Spatial/LumiereMortonCode.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+constexpr size_t BuildGrainSize = 16 * 1024;
+constexpr size_t PairGrainSize = 1024;
+constexpr uint32_t EmptyBucket = UINT32_MAX;
+constexpr Float MaxCellCoordinate = 1 << 30;
+// keeps the bucket count and every entry index within uint32_t
+constexpr size_t MaxEntryCount = UINT32_MAX / 2;
+
+
+size_t GetCellCount(const Bounds3i& cellBounds)
+{
+    // saturates instead of overflowing for huge query ranges
+    size_t cellCount = 1;
+    for (int axis = 0; axis < 3; ++ axis) {
+        const auto extent = static_cast<size_t>(static_cast<int64_t>(cellBounds.pMax[axis]) - cellBounds.pMin[axis] + 1);
+        cellCount = extent > SIZE_MAX / cellCount ? SIZE_MAX : cellCount * extent;
+    }
+    return cellCount;
+}
+
+} // namespace
+
+
+SpatialHashGrid::SpatialHashGrid(Float cellSize, size_t maxObjectCellCount)
+    : mCellSize(cellSize)
+    , mInverseCellSize(1 / cellSize)
+    , mMaxObjectCellCount(maxObjectCellCount)
+    , mBucketMask(0)
+    , mOccupiedCellBounds()
+    , mBoundsList()
+    , mBucketStartList()
+    , mEntryObjectList()
+    , mEntryCellList()
+    , mOverflowObjectList()
+{
+    LUMIERE_EXPECT(cellSize > 0);
+    LUMIERE_EXPECT(maxObjectCellCount > 0);
+}
+
+
+void SpatialHashGrid::build(const Point3f *pointList, size_t count, ThreadPool *threadPool)
+{
+    LUMIERE_EXPECT(pointList || count == 0);
+    mBoundsList.resize(count);
+    ParallelFor(threadPool, count, BuildGrainSize, [this, pointList](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++ i) {
+            mBoundsList[i] = Bounds3f(pointList[i]);
+        }
+    });
+    buildEntries(threadPool);
+}
+
+
+void SpatialHashGrid::build(const Bounds3f *boundsList, size_t count, ThreadPool *threadPool)
+{
+    LUMIERE_EXPECT(boundsList || count == 0);
+    mBoundsList.assign(boundsList, boundsList + count);
+    buildEntries(threadPool);
+}
+
+
+void SpatialHashGrid::clear()
+{
+    mBucketMask = 0;
+    mOccupiedCellBounds = Bounds3i();
+    mBoundsList.clear();
+    mBucketStartList.clear();
+    mEntryObjectList.clear();
+    mEntryCellList.clear();
+    mOverflowObjectList.clear();
+}
+
+
+void SpatialHashGrid::queryRadius(const Point3f& center, Float radius, IndexList& resultList) const
+{
+    LUMIERE_EXPECT(radius >= 0);
+    resultList.clear();
+    const Float radiusSquared = radius * radius;
+    const Vector3f extent(radius, radius, radius);
+    visitObjects(getCellBounds(Bounds3f(center - extent, center + extent)), [&](uint32_t objectIndex) {
+        if (DistanceSquared(center, mBoundsList[objectIndex]) <= radiusSquared) {
+            resultList.push_back(objectIndex);
+        }
+    });
+}
+
+
+void SpatialHashGrid::queryBounds(const Bounds3f& bounds, IndexList& resultList) const
+{
+    resultList.clear();
+    visitObjects(getCellBounds(bounds), [&](uint32_t objectIndex) {
+        if (Overlaps(mBoundsList[objectIndex], bounds)) {
+            resultList.push_back(objectIndex);
+        }
+    });
+}
+
+
+void SpatialHashGrid::queryNearest(const Point3f& point, size_t neighborCount, IndexList& resultList) const
+{
+    resultList.clear();
+    if (neighborCount == 0 || empty()) {
+        return;
+    }
+
+    // max-heap on distance holding the best candidates found so far
+    using Candidate = std::pair<Float, uint32_t>;
+    std::vector<Candidate> candidateHeap;
+    candidateHeap.reserve(neighborCount + 1);
+    auto offerCandidate = [&](uint32_t objectIndex) {
+        const Candidate candidate(DistanceSquared(point, mBoundsList[objectIndex]), objectIndex);
+        if (candidateHeap.size() == neighborCount && !(candidate < candidateHeap.front())) {
+            return;
+        }
+        // objects spanning several cells are met once per cell
+        for (const auto& existing : candidateHeap) {
+            if (existing.second == objectIndex) {
+                return;
+            }
+        }
+        candidateHeap.push_back(candidate);
+        std::push_heap(std::begin(candidateHeap), std::end(candidateHeap));
+        if (candidateHeap.size() > neighborCount) {
+            std::pop_heap(std::begin(candidateHeap), std::end(candidateHeap));
+            candidateHeap.pop_back();
+        }
+    };
+
+    for (uint32_t objectIndex : mOverflowObjectList) {
+        offerCandidate(objectIndex);
+    }
+
+    if (!mEntryObjectList.empty()) {
+        // rings of cells at growing Chebyshev distance; after ring r everything unvisited lies
+        // outside the cube [center - r, center + r + 1] in cell units
+        const Point3i centerCell = getCell(point);
+        int firstRing = 0;
+        for (int axis = 0; axis < 3; ++ axis) {
+            firstRing = std::max({firstRing, mOccupiedCellBounds.pMin[axis] - centerCell[axis], centerCell[axis] - mOccupiedCellBounds.pMax[axis]});
+        }
+        for (int ring = firstRing;; ++ ring) {
+            const Bounds3i ringBounds(centerCell - Vector3i(ring, ring, ring), centerCell + Vector3i(ring, ring, ring));
+            if (static_cast<size_t>(ring) * ring > mEntryObjectList.size() / 24) {
+                // the shell holds more cells than there are entries, a linear scan is cheaper
+                for (uint32_t objectIndex = 0; objectIndex < mBoundsList.size(); ++ objectIndex) {
+                    offerCandidate(objectIndex);
+                }
+                break;
+            }
+            for (int x = ringBounds.pMin.x; x <= ringBounds.pMax.x; ++ x) {
+                for (int y = ringBounds.pMin.y; y <= ringBounds.pMax.y; ++ y) {
+                    const bool isOnShell = x == ringBounds.pMin.x || x == ringBounds.pMax.x || y == ringBounds.pMin.y || y == ringBounds.pMax.y;
+                    const int zStep = isOnShell ? 1 : std::max(2 * ring, 1);
+                    for (int z = ringBounds.pMin.z; z <= ringBounds.pMax.z; z += zStep) {
+                        const Point3i cell(x, y, z);
+                        const uint32_t bucket = getBucket(cell);
+                        for (uint32_t entry = mBucketStartList[bucket]; entry < mBucketStartList[bucket + 1]; ++ entry) {
+                            if (mEntryCellList[entry] == cell) {
+                                offerCandidate(mEntryObjectList[entry]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (Inside(mOccupiedCellBounds.pMin, ringBounds) && Inside(mOccupiedCellBounds.pMax, ringBounds)) {
+                break;
+            }
+            if (candidateHeap.size() == neighborCount) {
+                Float margin = Infinity;
+                for (int axis = 0; axis < 3; ++ axis) {
+                    const Float lower = point[axis] - ringBounds.pMin[axis] * mCellSize;
+                    const Float upper = (ringBounds.pMax[axis] + 1) * mCellSize - point[axis];
+                    margin = std::min({margin, lower, upper});
+                }
+                if (candidateHeap.front().first <= margin * margin) {
+                    break;
+                }
+            }
+        }
+    }
+
+    std::sort_heap(std::begin(candidateHeap), std::end(candidateHeap));
+    resultList.reserve(candidateHeap.size());
+    for (const auto& candidate : candidateHeap) {
+        resultList.push_back(candidate.second);
+    }
+}
+
+
+void SpatialHashGrid::computeOverlapPairs(OverlapPairList& pairList, ThreadPool *threadPool) const
+{
+    pairList.clear();
+    std::mutex pairListMutex;
+    const size_t bucketCount = mBucketStartList.empty() ? 0 : mBucketStartList.size() - 1;
+    ParallelFor(threadPool, bucketCount, PairGrainSize, [&](size_t begin, size_t end) {
+        OverlapPairList localPairList;
+        for (size_t bucket = begin; bucket < end; ++ bucket) {
+            const uint32_t entryBegin = mBucketStartList[bucket];
+            const uint32_t entryEnd = mBucketStartList[bucket + 1];
+            for (uint32_t i = entryBegin; i < entryEnd; ++ i) {
+                const uint32_t first = mEntryObjectList[i];
+                const Bounds3f& firstBounds = mBoundsList[first];
+                for (uint32_t j = i + 1; j < entryEnd; ++ j) {
+                    const uint32_t second = mEntryObjectList[j];
+                    const Bounds3f& secondBounds = mBoundsList[second];
+                    if (mEntryCellList[i] != mEntryCellList[j] || !Overlaps(firstBounds, secondBounds)) {
+                        continue;
+                    }
+                    // a pair sharing several cells is reported only by the cell holding the lower
+                    // corner of the overlap
+                    const Point3i referenceCell = getCell(Max(firstBounds.pMin, secondBounds.pMin));
+                    if (referenceCell == mEntryCellList[i]) {
+                        localPairList.emplace_back(std::min(first, second), std::max(first, second));
+                    }
+                }
+            }
+        }
+        if (!localPairList.empty()) {
+            std::lock_guard<std::mutex> lock(pairListMutex);
+            pairList.insert(std::end(pairList), std::begin(localPairList), std::end(localPairList));
+        }
+    });
+
+    // overflow objects are tested against every object, pairs of two overflow objects are
+    // reported by the lower one
+    ParallelFor(threadPool, mOverflowObjectList.size(), 1, [&](size_t begin, size_t end) {
+        OverlapPairList localPairList;
+        for (size_t i = begin; i < end; ++ i) {
+            const uint32_t first = mOverflowObjectList[i];
+            const Bounds3f& firstBounds = mBoundsList[first];
+            for (size_t j = i + 1; j < mOverflowObjectList.size(); ++ j) {
+                const uint32_t second = mOverflowObjectList[j];
+                if (Overlaps(firstBounds, mBoundsList[second])) {
+                    localPairList.emplace_back(first, second);
+                }
+            }
+            visitCells(getCellBounds(firstBounds), [&](uint32_t second) {
+                if (Overlaps(firstBounds, mBoundsList[second])) {
+                    localPairList.emplace_back(std::min(first, second), std::max(first, second));
+                }
+            });
+        }
+        if (!localPairList.empty()) {
+            std::lock_guard<std::mutex> lock(pairListMutex);
+            pairList.insert(std::end(pairList), std::begin(localPairList), std::end(localPairList));
+        }
+    });
+    std::sort(std::begin(pairList), std::end(pairList));
+}
+
+
+Point3i SpatialHashGrid::getCell(const Point3f& point) const
+{
+    auto toCell = [this](Float value) {
+        const Float cell = std::floor(value * mInverseCellSize);
+        return static_cast<int>(std::clamp(cell, -MaxCellCoordinate, MaxCellCoordinate));
+    };
+    return {toCell(point.x), toCell(point.y), toCell(point.z)};
+}
+
+
+Float SpatialHashGrid::getCellSize() const
+{
+    return mCellSize;
+}
+
+
+size_t SpatialHashGrid::getObjectCount() const
+{
+    return mBoundsList.size();
+}
+
+
+bool SpatialHashGrid::empty() const
+{
+    return mBoundsList.empty();
+}
+
+
+void SpatialHashGrid::buildEntries(ThreadPool *threadPool)
+{
+    const size_t objectCount = mBoundsList.size();
+    if (objectCount >= UINT32_MAX) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::InvalidParams, "{} objects exceed the uint32_t object index range", objectCount);
+    }
+
+    // objects covering too many cells get no entries and go to the overflow list instead, which
+    // also bounds the entry count by objectCount * mMaxObjectCellCount
+    std::vector<size_t> entryOffsetList(objectCount + 1, 0);
+    std::mutex cellBoundsMutex;
+    mOccupiedCellBounds = Bounds3i();
+    mOverflowObjectList.clear();
+    ParallelFor(threadPool, objectCount, BuildGrainSize, [&](size_t begin, size_t end) {
+        Bounds3i localCellBounds;
+        IndexList localOverflowObjectList;
+        for (size_t i = begin; i < end; ++ i) {
+            const Bounds3i cellBounds = getCellBounds(mBoundsList[i]);
+            const size_t cellCount = GetCellCount(cellBounds);
+            if (cellCount > mMaxObjectCellCount) {
+                localOverflowObjectList.push_back(static_cast<uint32_t>(i));
+                continue;
+            }
+            entryOffsetList[i + 1] = cellCount;
+            localCellBounds = Union(localCellBounds, cellBounds);
+        }
+        std::lock_guard<std::mutex> lock(cellBoundsMutex);
+        mOccupiedCellBounds = Union(mOccupiedCellBounds, localCellBounds);
+        mOverflowObjectList.insert(std::end(mOverflowObjectList), std::begin(localOverflowObjectList), std::end(localOverflowObjectList));
+    });
+    std::sort(std::begin(mOverflowObjectList), std::end(mOverflowObjectList));
+    std::partial_sum(std::begin(entryOffsetList), std::end(entryOffsetList), std::begin(entryOffsetList));
+    const size_t entryCount = entryOffsetList.back();
+    if (entryCount > MaxEntryCount) {
+        LUMIERE_THROW_EXCEPTION_FMT(ExceptionCode::InvalidParams, "{} grid entries exceed the limit of {}, the cell size is too small",
+                                    entryCount, MaxEntryCount);
+    }
+
+    size_t bucketCount = 1;
+    while (bucketCount < 2 * entryCount) {
+        bucketCount *= 2;
+    }
+    mBucketMask = static_cast<uint32_t>(bucketCount - 1);
+
+    std::vector<uint32_t> bucketList(entryCount);
+    std::vector<uint32_t> entryIndexList(entryCount);
+    std::vector<uint32_t> unsortedObjectList(entryCount);
+    std::vector<Point3i> unsortedCellList(entryCount);
+    ParallelFor(threadPool, objectCount, BuildGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++ i) {
+            if (entryOffsetList[i] == entryOffsetList[i + 1]) {
+                continue;
+            }
+            const Bounds3i cellBounds = getCellBounds(mBoundsList[i]);
+            size_t entry = entryOffsetList[i];
+            for (int z = cellBounds.pMin.z; z <= cellBounds.pMax.z; ++ z) {
+                for (int y = cellBounds.pMin.y; y <= cellBounds.pMax.y; ++ y) {
+                    for (int x = cellBounds.pMin.x; x <= cellBounds.pMax.x; ++ x) {
+                        const Point3i cell(x, y, z);
+                        bucketList[entry] = getBucket(cell);
+                        entryIndexList[entry] = static_cast<uint32_t>(entry);
+                        unsortedObjectList[entry] = static_cast<uint32_t>(i);
+                        unsortedCellList[entry] = cell;
+                        ++ entry;
+                    }
+                }
+            }
+        }
+    });
+
+    // the sort is stable, so every bucket lists its objects in ascending order
+    SortMortonCodes(bucketList.data(), entryIndexList.data(), entryCount, threadPool);
+
+    mEntryObjectList.resize(entryCount);
+    mEntryCellList.resize(entryCount);
+    mBucketStartList.assign(bucketCount + 1, EmptyBucket);
+    ParallelFor(threadPool, entryCount, BuildGrainSize, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++ i) {
+            mEntryObjectList[i] = unsortedObjectList[entryIndexList[i]];
+            mEntryCellList[i] = unsortedCellList[entryIndexList[i]];
+            if (i == 0 || bucketList[i] != bucketList[i - 1]) {
+                mBucketStartList[bucketList[i]] = static_cast<uint32_t>(i);
+            }
+        }
+    });
+    mBucketStartList[bucketCount] = static_cast<uint32_t>(entryCount);
+    for (size_t bucket = bucketCount; bucket-- > 0;) {
+        if (mBucketStartList[bucket] == EmptyBucket) {
+            mBucketStartList[bucket] = mBucketStartList[bucket + 1];
+        }
+    }
+}
+
+
+Bounds3i SpatialHashGrid::getCellBounds(const Bounds3f& bounds) const
+{
+    return {getCell(bounds.pMin), getCell(bounds.pMax)};
+}
+
+
+uint32_t SpatialHashGrid::getBucket(const Point3i& cell) const
+{
+    const uint32_t hash = (static_cast<uint32_t>(cell.x) * 73856093u) ^
+                          (static_cast<uint32_t>(cell.y) * 19349663u) ^
+                          (static_cast<uint32_t>(cell.z) * 83492791u);
+    return hash & mBucketMask;
+}
+
+
+template <typename Visitor>
+void SpatialHashGrid::visitCells(const Bounds3i& cellBounds, Visitor&& visitor) const
+{
+    if (mEntryObjectList.empty()) {
+        return;
+    }
+
+    // an object is visited from the first of its cells inside the query range only
+    auto visitEntry = [&](uint32_t entry) {
+        const uint32_t objectIndex = mEntryObjectList[entry];
+        const Point3i firstCell = Max(getCell(mBoundsList[objectIndex].pMin), cellBounds.pMin);
+        if (mEntryCellList[entry] == firstCell) {
+            visitor(objectIndex);
+        }
+    };
+
+    if (GetCellCount(cellBounds) > mEntryObjectList.size()) {
+        for (uint32_t entry = 0; entry < mEntryObjectList.size(); ++ entry) {
+            if (Inside(mEntryCellList[entry], cellBounds)) {
+                visitEntry(entry);
+            }
+        }
+        return;
+    }
+
+    for (int z = cellBounds.pMin.z; z <= cellBounds.pMax.z; ++ z) {
+        for (int y = cellBounds.pMin.y; y <= cellBounds.pMax.y; ++ y) {
+            for (int x = cellBounds.pMin.x; x <= cellBounds.pMax.x; ++ x) {
+                const Point3i cell(x, y, z);
+                const uint32_t bucket = getBucket(cell);
+                for (uint32_t entry = mBucketStartList[bucket]; entry < mBucketStartList[bucket + 1]; ++ entry) {
+                    if (mEntryCellList[entry] == cell) {
+                        visitEntry(entry);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+template <typename Visitor>
+void SpatialHashGrid::visitObjects(const Bounds3i& cellBounds, Visitor&& visitor) const
+{
+    for (uint32_t objectIndex : mOverflowObjectList) {
+        visitor(objectIndex);
+    }
+    visitCells(cellBounds, visitor);
+}
+
+END_LUMIERE_NAMESPACE
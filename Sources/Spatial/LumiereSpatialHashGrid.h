@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereVector.h"
+#include "Thread/LumiereThreadPool.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// uniform grid stored as a hash table over cell coordinates: entries are sorted by bucket so
+// every bucket is one contiguous range, and every entry keeps its cell so that colliding cells
+// never produce duplicates; points are stored as degenerate bounds. objects covering more than
+// maxObjectCellCount cells are kept in an overflow list that every query scans instead
+class SpatialHashGrid {
+public:
+    using IndexList = std::vector<uint32_t>;
+    using OverlapPair = std::pair<uint32_t, uint32_t>;
+    using OverlapPairList = std::vector<OverlapPair>;
+    static constexpr size_t DefaultMaxObjectCellCount = 64;
+
+public:
+    explicit SpatialHashGrid(Float cellSize, size_t maxObjectCellCount = DefaultMaxObjectCellCount);
+    ~SpatialHashGrid() = default;
+
+    void build(const Point3f *pointList, size_t count, ThreadPool *threadPool = nullptr) noexcept(false);
+    void build(const Bounds3f *boundsList, size_t count, ThreadPool *threadPool = nullptr) noexcept(false);
+    void clear();
+    void queryRadius(const Point3f& center, Float radius, IndexList& resultList) const;
+    void queryBounds(const Bounds3f& bounds, IndexList& resultList) const;
+    void queryNearest(const Point3f& point, size_t neighborCount, IndexList& resultList) const;
+    void computeOverlapPairs(OverlapPairList& pairList, ThreadPool *threadPool = nullptr) const;
+    Point3i getCell(const Point3f& point) const;
+    Float getCellSize() const;
+    size_t getObjectCount() const;
+    bool empty() const;
+
+private:
+    void buildEntries(ThreadPool *threadPool) noexcept(false);
+    Bounds3i getCellBounds(const Bounds3f& bounds) const;
+    uint32_t getBucket(const Point3i& cell) const;
+    // grid entries only
+    template <typename Visitor> void visitCells(const Bounds3i& cellBounds, Visitor&& visitor) const;
+    // overflow objects followed by the grid entries
+    template <typename Visitor> void visitObjects(const Bounds3i& cellBounds, Visitor&& visitor) const;
+
+private:
+    Float mCellSize;
+    Float mInverseCellSize;
+    size_t mMaxObjectCellCount;
+    uint32_t mBucketMask;
+    Bounds3i mOccupiedCellBounds;
+    std::vector<Bounds3f> mBoundsList;
+    std::vector<uint32_t> mBucketStartList;
+    std::vector<uint32_t> mEntryObjectList;
+    std::vector<Point3i> mEntryCellList;
+    std::vector<uint32_t> mOverflowObjectList;
+};
+
+END_LUMIERE_NAMESPACE
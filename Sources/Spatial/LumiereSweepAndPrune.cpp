@@ -0,0 +1,260 @@
+#include "LumiereSweepAndPrune.h"
+#include <algorithm>
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+namespace {
+
+enum ObjectState : uint8_t {
+    Free,
+    Alive,
+    PendingRemoval
+};
+
+} // namespace
+
+
+SweepAndPrune::SweepAndPrune()
+    : mBoundsList()
+    , mStateList()
+    , mFreeIdList()
+    , mPendingRemovalList()
+    , mObjectCount(0)
+    , mPendingInsertionCount(0)
+    , mEndpointList()
+    , mPairSet()
+    , mAddedPairList()
+    , mRemovedPairList()
+{
+
+}
+
+
+SweepAndPrune::ObjectId SweepAndPrune::insert(const Bounds3f& bounds)
+{
+    ObjectId id = 0;
+    if (mFreeIdList.empty()) {
+        LUMIERE_EXPECT(mBoundsList.size() < UINT32_MAX / 2);
+        id = static_cast<ObjectId>(mBoundsList.size());
+        mBoundsList.push_back(bounds);
+        mStateList.push_back(Alive);
+    } else {
+        id = mFreeIdList.back();
+        mFreeIdList.pop_back();
+        mBoundsList[id] = bounds;
+        mStateList[id] = Alive;
+    }
+
+    // new endpoints start at the end and are moved into place by the next update
+    for (int axis = 0; axis < 3; ++ axis) {
+        mEndpointList[axis].push_back({bounds.pMin[axis], id << 1});
+        mEndpointList[axis].push_back({bounds.pMax[axis], (id << 1) | 1});
+    }
+    mObjectCount += 1;
+    mPendingInsertionCount += 1;
+    return id;
+}
+
+
+void SweepAndPrune::remove(ObjectId id)
+{
+    LUMIERE_EXPECT(isAlive(id));
+    mStateList[id] = PendingRemoval;
+    mPendingRemovalList.push_back(id);
+    mObjectCount -= 1;
+}
+
+
+void SweepAndPrune::setBounds(ObjectId id, const Bounds3f& bounds)
+{
+    LUMIERE_EXPECT(isAlive(id));
+    mBoundsList[id] = bounds;
+}
+
+
+const Bounds3f& SweepAndPrune::getBounds(ObjectId id) const
+{
+    LUMIERE_EXPECT(isAlive(id));
+    return mBoundsList[id];
+}
+
+
+void SweepAndPrune::update()
+{
+    mAddedPairList.clear();
+    mRemovedPairList.clear();
+    removePendingObjects();
+    refreshEndpoints();
+
+    // a large batch of insertions is cheaper to place with one full sort and sweep
+    std::vector<uint64_t> touchedPairList;
+    if (mPendingInsertionCount * 4 > mObjectCount) {
+        sortFully(touchedPairList);
+    } else {
+        sortIncrementally(touchedPairList);
+    }
+    mPendingInsertionCount = 0;
+
+    // a pair may be touched on several axes or swap back and forth, only the final state counts
+    std::sort(std::begin(touchedPairList), std::end(touchedPairList));
+    touchedPairList.erase(std::unique(std::begin(touchedPairList), std::end(touchedPairList)), std::end(touchedPairList));
+    for (uint64_t key : touchedPairList) {
+        const auto first = static_cast<ObjectId>(key >> 32);
+        const auto second = static_cast<ObjectId>(key & UINT32_MAX);
+        const bool wasOverlapping = mPairSet.count(key) != 0;
+        const bool isOverlapping = Overlaps(mBoundsList[first], mBoundsList[second]);
+        if (isOverlapping && !wasOverlapping) {
+            mPairSet.insert(key);
+            mAddedPairList.emplace_back(first, second);
+        } else if (!isOverlapping && wasOverlapping) {
+            mPairSet.erase(key);
+            mRemovedPairList.emplace_back(first, second);
+        }
+    }
+    std::sort(std::begin(mRemovedPairList), std::end(mRemovedPairList));
+}
+
+
+void SweepAndPrune::getOverlapPairList(OverlapPairList& pairList) const
+{
+    pairList.clear();
+    pairList.reserve(mPairSet.size());
+    for (uint64_t key : mPairSet) {
+        pairList.emplace_back(static_cast<ObjectId>(key >> 32), static_cast<ObjectId>(key & UINT32_MAX));
+    }
+    std::sort(std::begin(pairList), std::end(pairList));
+}
+
+
+const SweepAndPrune::OverlapPairList& SweepAndPrune::getAddedPairList() const
+{
+    return mAddedPairList;
+}
+
+
+const SweepAndPrune::OverlapPairList& SweepAndPrune::getRemovedPairList() const
+{
+    return mRemovedPairList;
+}
+
+
+size_t SweepAndPrune::getObjectCount() const
+{
+    return mObjectCount;
+}
+
+
+uint64_t SweepAndPrune::MakePairKey(ObjectId first, ObjectId second)
+{
+    if (first > second) {
+        std::swap(first, second);
+    }
+    return (static_cast<uint64_t>(first) << 32) | second;
+}
+
+
+bool SweepAndPrune::IsLess(const Endpoint& lhs, const Endpoint& rhs)
+{
+    // lower endpoints go first on ties so that touching bounds count as overlapping like Overlaps()
+    return lhs.value < rhs.value || (lhs.value == rhs.value && (lhs.data & 1) < (rhs.data & 1));
+}
+
+
+void SweepAndPrune::removePendingObjects()
+{
+    if (mPendingRemovalList.empty()) {
+        return;
+    }
+
+    for (auto& endpointList : mEndpointList) {
+        endpointList.erase(std::remove_if(std::begin(endpointList), std::end(endpointList), [this](const Endpoint& endpoint) {
+            return mStateList[endpoint.data >> 1] == PendingRemoval;
+        }), std::end(endpointList));
+    }
+    for (auto iter = std::begin(mPairSet); iter != std::end(mPairSet);) {
+        const auto first = static_cast<ObjectId>(*iter >> 32);
+        const auto second = static_cast<ObjectId>(*iter & UINT32_MAX);
+        if (mStateList[first] == PendingRemoval || mStateList[second] == PendingRemoval) {
+            mRemovedPairList.emplace_back(first, second);
+            iter = mPairSet.erase(iter);
+        } else {
+            ++ iter;
+        }
+    }
+    for (ObjectId id : mPendingRemovalList) {
+        mStateList[id] = Free;
+        mFreeIdList.push_back(id);
+    }
+    mPendingRemovalList.clear();
+}
+
+
+void SweepAndPrune::refreshEndpoints()
+{
+    for (int axis = 0; axis < 3; ++ axis) {
+        for (auto& endpoint : mEndpointList[axis]) {
+            const Bounds3f& bounds = mBoundsList[endpoint.data >> 1];
+            endpoint.value = (endpoint.data & 1) ? bounds.pMax[axis] : bounds.pMin[axis];
+        }
+    }
+}
+
+
+void SweepAndPrune::sortIncrementally(std::vector<uint64_t>& touchedPairList)
+{
+    for (auto& endpointList : mEndpointList) {
+        for (size_t i = 1; i < endpointList.size(); ++ i) {
+            const Endpoint endpoint = endpointList[i];
+            size_t j = i;
+            for (; j > 0 && IsLess(endpoint, endpointList[j - 1]); -- j) {
+                const Endpoint& other = endpointList[j - 1];
+                if (((endpoint.data ^ other.data) & 1) != 0 && (endpoint.data >> 1) != (other.data >> 1)) {
+                    touchedPairList.push_back(MakePairKey(endpoint.data >> 1, other.data >> 1));
+                }
+                endpointList[j] = other;
+            }
+            endpointList[j] = endpoint;
+        }
+    }
+}
+
+
+void SweepAndPrune::sortFully(std::vector<uint64_t>& touchedPairList)
+{
+    for (auto& endpointList : mEndpointList) {
+        std::sort(std::begin(endpointList), std::end(endpointList), IsLess);
+    }
+
+    // every current pair is checked again, together with all pairs found by a sweep along x
+    touchedPairList.assign(std::begin(mPairSet), std::end(mPairSet));
+    std::vector<ObjectId> activeList;
+    std::vector<uint32_t> activeSlotList(mBoundsList.size());
+    for (const auto& endpoint : mEndpointList[0]) {
+        const ObjectId id = endpoint.data >> 1;
+        if ((endpoint.data & 1) == 0) {
+            for (ObjectId activeId : activeList) {
+                if (Overlaps(mBoundsList[id], mBoundsList[activeId])) {
+                    touchedPairList.push_back(MakePairKey(id, activeId));
+                }
+            }
+            activeSlotList[id] = static_cast<uint32_t>(activeList.size());
+            activeList.push_back(id);
+        } else {
+            const uint32_t slot = activeSlotList[id];
+            if (slot < activeList.size() && activeList[slot] == id) {
+                activeList[slot] = activeList.back();
+                activeSlotList[activeList[slot]] = slot;
+                activeList.pop_back();
+            }
+        }
+    }
+}
+
+
+bool SweepAndPrune::isAlive(ObjectId id) const
+{
+    return id < mStateList.size() && mStateList[id] == Alive;
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "Common/LumiereMacro.h"
+#include "Math/LumiereVector.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+// broadphase keeping the bounds endpoints of every object sorted along each axis; objects move
+// a little between frames, so insertion sort repairs the order in close to linear time and
+// every swap of a lower with an upper endpoint marks the only pairs whose overlap can change
+class SweepAndPrune {
+public:
+    using ObjectId = uint32_t;
+    using OverlapPair = std::pair<ObjectId, ObjectId>;
+    using OverlapPairList = std::vector<OverlapPair>;
+
+public:
+    SweepAndPrune();
+    ~SweepAndPrune() = default;
+
+    ObjectId insert(const Bounds3f& bounds);
+    void remove(ObjectId id);
+    void setBounds(ObjectId id, const Bounds3f& bounds);
+    const Bounds3f& getBounds(ObjectId id) const;
+    void update();
+    void getOverlapPairList(OverlapPairList& pairList) const;
+    const OverlapPairList& getAddedPairList() const;
+    const OverlapPairList& getRemovedPairList() const;
+    size_t getObjectCount() const;
+
+private:
+    struct Endpoint {
+        Float value;
+        // object id shifted left by one, the low bit is set for the upper endpoint
+        uint32_t data;
+    };
+    using EndpointList = std::vector<Endpoint>;
+
+    static uint64_t MakePairKey(ObjectId first, ObjectId second);
+    static bool IsLess(const Endpoint& lhs, const Endpoint& rhs);
+    void removePendingObjects();
+    void refreshEndpoints();
+    void sortIncrementally(std::vector<uint64_t>& touchedPairList);
+    void sortFully(std::vector<uint64_t>& touchedPairList);
+    bool isAlive(ObjectId id) const;
+
+private:
+    std::vector<Bounds3f> mBoundsList;
+    std::vector<uint8_t> mStateList;
+    std::vector<ObjectId> mFreeIdList;
+    std::vector<ObjectId> mPendingRemovalList;
+    size_t mObjectCount;
+    size_t mPendingInsertionCount;
+    EndpointList mEndpointList[3];
+    std::unordered_set<uint64_t> mPairSet;
+    OverlapPairList mAddedPairList;
+    OverlapPairList mRemovedPairList;
+};
+
+END_LUMIERE_NAMESPACE
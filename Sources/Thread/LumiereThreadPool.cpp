@@ -0,0 +1,154 @@
+#include "LumiereThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include "Common/LumiereAssert.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+size_t ThreadPool::getDefaultWorkerCount()
+{
+    // the thread calling parallelFor() takes part in the work as well
+    const size_t hardwareThreadCount = std::thread::hardware_concurrency();
+    return hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 0;
+}
+
+
+ThreadPool::ThreadPool(size_t workerCount)
+    : mWorkerList()
+    , mTaskQueue()
+    , mMutex()
+    , mCondition()
+    , mIsStopping(false)
+{
+    mWorkerList.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++ i) {
+        mWorkerList.emplace_back(&ThreadPool::workerLoop, this);
+    }
+    LUMIERE_ENSURE(mWorkerList.size() == workerCount);
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIsStopping = true;
+    }
+    mCondition.notify_all();
+    for (auto& worker : mWorkerList) {
+        worker.join();
+    }
+}
+
+
+size_t ThreadPool::getWorkerCount() const
+{
+    return mWorkerList.size();
+}
+
+
+void ThreadPool::enqueue(Task&& task)
+{
+    LUMIERE_EXPECT(task);
+    if (mWorkerList.empty()) {
+        task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        LUMIERE_EXPECT(!mIsStopping);
+        mTaskQueue.push_back(std::move(task));
+    }
+    mCondition.notify_one();
+}
+
+
+void ThreadPool::parallelFor(size_t count, size_t grainSize, const RangeFunction& function)
+{
+    LUMIERE_EXPECT(grainSize > 0);
+    if (count == 0) {
+        return;
+    }
+
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount == 1 || mWorkerList.empty()) {
+        function(0, count);
+        return;
+    }
+
+    // chunks are claimed through an atomic counter, so helpers that start late simply find
+    // nothing left to do and the calling thread never waits on a task that has not started
+    struct Job {
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> finishedChunkCount{0};
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::exception_ptr exception;
+    };
+    auto job = std::make_shared<Job>();
+
+    auto runChunks = [job, count, grainSize, chunkCount, &function]() {
+        size_t chunk = job->nextChunk.fetch_add(1);
+        while (chunk < chunkCount) {
+            const size_t begin = chunk * grainSize;
+            const size_t end = std::min(begin + grainSize, count);
+            try {
+                function(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                if (!job->exception) {
+                    job->exception = std::current_exception();
+                }
+            }
+            if (job->finishedChunkCount.fetch_add(1) + 1 == chunkCount) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->condition.notify_all();
+            }
+            chunk = job->nextChunk.fetch_add(1);
+        }
+    };
+
+    const size_t helperCount = std::min(mWorkerList.size(), chunkCount - 1);
+    for (size_t i = 0; i < helperCount; ++ i) {
+        enqueue(runChunks);
+    }
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->condition.wait(lock, [&job, chunkCount]() { return job->finishedChunkCount.load() == chunkCount; });
+    if (job->exception) {
+        std::rethrow_exception(job->exception);
+    }
+}
+
+
+void ParallelFor(ThreadPool *threadPool, size_t count, size_t grainSize, const ThreadPool::RangeFunction& function)
+{
+    if (threadPool) {
+        threadPool->parallelFor(count, grainSize, function);
+    } else if (count > 0) {
+        function(0, count);
+    }
+}
+
+
+void ThreadPool::workerLoop()
+{
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mIsStopping || !mTaskQueue.empty(); });
+            if (mTaskQueue.empty()) {
+                return;
+            }
+            task = std::move(mTaskQueue.front());
+            mTaskQueue.pop_front();
+        }
+        task();
+    }
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,58 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Common/LumiereMacro.h"
+
+BEGIN_LUMIERE_NAMESPACE
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+    static size_t getDefaultWorkerCount();
+
+public:
+    explicit ThreadPool(size_t workerCount = getDefaultWorkerCount());
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getWorkerCount() const;
+    void enqueue(Task&& task);
+    template <typename Function> auto submit(Function&& function) -> std::future<decltype(function())>;
+    void parallelFor(size_t count, size_t grainSize, const RangeFunction& function);
+
+private:
+    void workerLoop();
+
+private:
+    std::vector<std::thread> mWorkerList;
+    std::deque<Task> mTaskQueue;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mIsStopping;
+};
+
+
+// runs function over [0, count) on threadPool, or on the calling thread when there is none
+void ParallelFor(ThreadPool *threadPool, size_t count, size_t grainSize, const ThreadPool::RangeFunction& function);
+
+
+template <typename Function>
+auto ThreadPool::submit(Function&& function) -> std::future<decltype(function())>
+{
+    using Result = decltype(function());
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+    std::future<Result> future = task->get_future();
+    enqueue([task]() { (*task)(); });
+    return future;
+}
+
+END_LUMIERE_NAMESPACE
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "Exception/LumiereException.h"
+#include "Image/LumiereImageReader.h"
+
+using namespace Syrinx;
+
+namespace {
+
+class BufferStream : public DataStream {
+public:
+    explicit BufferStream(const std::vector<uint8_t>& buffer) : DataStream("buffer", buffer.size()), mBuffer(buffer), mPosition(0) {}
+
+    size_t read(void *buffer, size_t byteSize) override
+    {
+        byteSize = std::min(byteSize, mBuffer.size() - mPosition);
+        std::memcpy(buffer, mBuffer.data() + mPosition, byteSize);
+        mPosition += byteSize;
+        return byteSize;
+    }
+
+    size_t write(const void*, size_t) override { return 0; }
+    std::string getLine() override { return {}; }
+    bool getLine(std::string&) override { return false; }
+    std::string getAsString() override { return std::string(mBuffer.begin(), mBuffer.end()); }
+    std::vector<char> getAsByteArray() override { return std::vector<char>(mBuffer.begin(), mBuffer.end()); }
+    void skip(uint64_t byteSize) override { mPosition = std::min(mBuffer.size(), mPosition + static_cast<size_t>(byteSize)); }
+    size_t tell() const override { return mPosition; }
+    void seek(size_t pos) override { mPosition = std::min(pos, mBuffer.size()); }
+    bool eof() const override { return mPosition >= mBuffer.size(); }
+    bool isReadable() const override { return true; }
+    bool isWriteable() const override { return false; }
+
+private:
+    const std::vector<uint8_t>& mBuffer;
+    size_t mPosition;
+};
+
+
+// 2x1 RGB PNG holding a red and an azure pixel
+const std::vector<uint8_t> RGBImageFile = {
+    0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52, 0x00, 0x00,
+    0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x00, 0x00, 0x00, 0x7b, 0x40, 0xe8, 0xdd, 0x00, 0x00, 0x00,
+    0x0f, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0xf8, 0xcf, 0xc0, 0xc0, 0xd0, 0xf0, 0x1f, 0x00, 0x08, 0x00,
+    0x02, 0x7f, 0x25, 0x3e, 0xfc, 0x09, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
+};
+
+
+bool TestCorruptBuffer(const char *caseName, const std::vector<uint8_t>& buffer, ImageFormat format)
+{
+    bool isPassed = true;
+    try {
+        ImageReader().read(buffer.data(), buffer.size(), format);
+        std::printf("corrupt memory buffer was accepted: %s, %s\n", caseName, format._to_string());
+        isPassed = false;
+    } catch (const ImageLoadException&) {
+    }
+    try {
+        BufferStream stream(buffer);
+        ImageReader().read(stream, format);
+        std::printf("corrupt data stream was accepted: %s, %s\n", caseName, format._to_string());
+        isPassed = false;
+    } catch (const ImageLoadException&) {
+    }
+    return isPassed;
+}
+
+
+// stb expands the three source channels, so the file is readable as RGBA8 as well
+bool TestChannelExpansion()
+{
+    const Image image = ImageReader().read(RGBImageFile.data(), RGBImageFile.size(), ImageFormat::RGBA8);
+    const uint8_t expectedPixelList[] = {255, 0, 0, 255, 0, 128, 255, 255};
+    if (image.getWidth() != 2 || image.getHeight() != 1 || image.getFormat()._value != ImageFormat::RGBA8 ||
+        std::memcmp(image.getData(), expectedPixelList, sizeof(expectedPixelList)) != 0) {
+        std::printf("RGB file was not expanded to RGBA8\n");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+
+int main()
+{
+    std::vector<uint8_t> garbage(256);
+    for (size_t i = 0; i < garbage.size(); ++ i) {
+        garbage[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    // a valid signature and header cut off before any pixel data
+    const std::vector<uint8_t> truncated(RGBImageFile.begin(), RGBImageFile.begin() + 33);
+    // a damaged deflate stream behind valid chunk framing
+    std::vector<uint8_t> damaged = RGBImageFile;
+    std::fill(damaged.begin() + 43, damaged.begin() + 56, uint8_t(0xff));
+
+    bool isPassed = true;
+    for (ImageFormat format : {ImageFormat::RGBA8, ImageFormat::RGB8, ImageFormat::RGBAF}) {
+        isPassed &= TestCorruptBuffer("garbage", garbage, format);
+        isPassed &= TestCorruptBuffer("truncated", truncated, format);
+        isPassed &= TestCorruptBuffer("damaged", damaged, format);
+    }
+    isPassed &= TestChannelExpansion();
+    return isPassed ? 0 : 1;
+}
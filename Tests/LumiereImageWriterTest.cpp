@@ -0,0 +1,652 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "Image/LumiereImageReader.h"
+#include "Image/LumiereImageWriter.h"
+
+using namespace Syrinx;
+
+namespace {
+
+class MemoryStream : public DataStream {
+public:
+    MemoryStream() : DataStream("memory"), mBuffer(), mPosition(0) {}
+
+    size_t read(void *buffer, size_t byteSize) override
+    {
+        byteSize = std::min(byteSize, mBuffer.size() - mPosition);
+        std::memcpy(buffer, mBuffer.data() + mPosition, byteSize);
+        mPosition += byteSize;
+        return byteSize;
+    }
+
+    size_t write(const void *buffer, size_t byteSize) override
+    {
+        const auto *bytes = static_cast<const char*>(buffer);
+        mBuffer.insert(mBuffer.end(), bytes, bytes + byteSize);
+        setSize(mBuffer.size());
+        return byteSize;
+    }
+
+    std::string getLine() override { return {}; }
+    bool getLine(std::string&) override { return false; }
+    std::string getAsString() override { return std::string(mBuffer.begin(), mBuffer.end()); }
+    std::vector<char> getAsByteArray() override { return mBuffer; }
+    void skip(uint64_t byteSize) override { mPosition = std::min(mBuffer.size(), mPosition + static_cast<size_t>(byteSize)); }
+    size_t tell() const override { return mPosition; }
+    void seek(size_t pos) override { mPosition = std::min(pos, mBuffer.size()); }
+    bool eof() const override { return mPosition >= mBuffer.size(); }
+    bool isReadable() const override { return true; }
+    bool isWriteable() const override { return true; }
+
+private:
+    std::vector<char> mBuffer;
+    size_t mPosition;
+};
+
+
+uint32_t ReadUInt32BigEndian(const uint8_t *data)
+{
+    return static_cast<uint32_t>(data[0]) << 24 | static_cast<uint32_t>(data[1]) << 16 | static_cast<uint32_t>(data[2]) << 8 | data[3];
+}
+
+
+// straight transcription of the decoder in the QOI specification, kept independent of the writer
+bool DecodeQOI(const std::vector<char>& file, uint32_t& width, uint32_t& height, int& channelCount, std::vector<uint8_t>& pixelList)
+{
+    const auto *data = reinterpret_cast<const uint8_t*>(file.data());
+    if (file.size() < 14 + 8 || std::memcmp(data, "qoif", 4) != 0) {
+        return false;
+    }
+    width = ReadUInt32BigEndian(data + 4);
+    height = ReadUInt32BigEndian(data + 8);
+    channelCount = data[12];
+    if (channelCount != 3 && channelCount != 4) {
+        return false;
+    }
+
+    uint8_t index[64][4] = {};
+    uint8_t pixel[4] = {0, 0, 0, 255};
+    int run = 0;
+    size_t position = 14;
+    const size_t chunkEnd = file.size() - 8;
+    pixelList.clear();
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; ++ i) {
+        if (run > 0) {
+            -- run;
+        } else if (position < chunkEnd) {
+            const uint8_t byte = data[position++];
+            if (byte == 0xfe) {
+                pixel[0] = data[position++];
+                pixel[1] = data[position++];
+                pixel[2] = data[position++];
+            } else if (byte == 0xff) {
+                pixel[0] = data[position++];
+                pixel[1] = data[position++];
+                pixel[2] = data[position++];
+                pixel[3] = data[position++];
+            } else if ((byte & 0xc0) == 0x00) {
+                std::memcpy(pixel, index[byte], 4);
+            } else if ((byte & 0xc0) == 0x40) {
+                pixel[0] += ((byte >> 4) & 0x03) - 2;
+                pixel[1] += ((byte >> 2) & 0x03) - 2;
+                pixel[2] += (byte & 0x03) - 2;
+            } else if ((byte & 0xc0) == 0x80) {
+                const uint8_t second = data[position++];
+                const int greenDelta = (byte & 0x3f) - 32;
+                pixel[0] += greenDelta - 8 + ((second >> 4) & 0x0f);
+                pixel[1] += greenDelta;
+                pixel[2] += greenDelta - 8 + (second & 0x0f);
+            } else {
+                run = byte & 0x3f;
+            }
+            std::memcpy(index[(pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64], pixel, 4);
+        }
+        pixelList.insert(pixelList.end(), pixel, pixel + channelCount);
+    }
+    return std::memcmp(data + chunkEnd, "\0\0\0\0\0\0\0\1", 8) == 0;
+}
+
+
+uint32_t ComputeCRC32(const uint8_t *data, size_t byteSize)
+{
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < byteSize; ++ i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++ bit) {
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+
+uint32_t ComputeAdler32(const uint8_t *data, size_t byteSize)
+{
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < byteSize; ++ i) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return b << 16 | a;
+}
+
+
+// bit-by-bit transcription of the inflate algorithm in RFC 1951, kept independent of the writer
+class Inflater {
+public:
+    Inflater(const uint8_t *data, size_t byteSize) : mData(data), mByteSize(byteSize), mPosition(0), mBitBuffer(0), mBitCount(0), mIsValid(true) {}
+
+    bool inflate(std::vector<uint8_t>& output)
+    {
+        bool isFinal = false;
+        while (!isFinal && mIsValid) {
+            isFinal = readBits(1) == 1;
+            const int type = readBits(2);
+            if (type == 0) {
+                inflateStored(output);
+            } else if (type == 1) {
+                inflateFixed(output);
+            } else if (type == 2) {
+                inflateDynamic(output);
+            } else {
+                mIsValid = false;
+            }
+        }
+        return mIsValid;
+    }
+
+    size_t getPosition() const { return mPosition; }
+
+private:
+    struct Huffman {
+        int countList[16] = {};
+        std::vector<int> symbolList;
+    };
+
+    int readBits(int count)
+    {
+        while (mBitCount < count) {
+            if (mPosition >= mByteSize) {
+                mIsValid = false;
+                return 0;
+            }
+            mBitBuffer |= static_cast<uint32_t>(mData[mPosition++]) << mBitCount;
+            mBitCount += 8;
+        }
+        const int value = static_cast<int>(mBitBuffer & ((1u << count) - 1));
+        mBitBuffer >>= count;
+        mBitCount -= count;
+        return value;
+    }
+
+    static Huffman BuildHuffman(const int *lengthList, int symbolCount)
+    {
+        Huffman huffman;
+        for (int symbol = 0; symbol < symbolCount; ++ symbol) {
+            ++ huffman.countList[lengthList[symbol]];
+        }
+        huffman.countList[0] = 0;
+        for (int length = 1; length < 16; ++ length) {
+            for (int symbol = 0; symbol < symbolCount; ++ symbol) {
+                if (lengthList[symbol] == length) {
+                    huffman.symbolList.push_back(symbol);
+                }
+            }
+        }
+        return huffman;
+    }
+
+    // canonical codes of one length are consecutive, so the code is compared against the first
+    // code of every length in turn
+    int decodeSymbol(const Huffman& huffman)
+    {
+        int code = 0, first = 0, index = 0;
+        for (int length = 1; length < 16 && mIsValid; ++ length) {
+            code |= readBits(1);
+            const int count = huffman.countList[length];
+            if (code - first < count) {
+                return huffman.symbolList[index + code - first];
+            }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        mIsValid = false;
+        return 0;
+    }
+
+    void inflateStored(std::vector<uint8_t>& output)
+    {
+        mBitBuffer = 0;
+        mBitCount = 0;
+        if (mPosition + 4 > mByteSize) {
+            mIsValid = false;
+            return;
+        }
+        const size_t length = mData[mPosition] | mData[mPosition + 1] << 8;
+        const size_t complement = mData[mPosition + 2] | mData[mPosition + 3] << 8;
+        mPosition += 4;
+        if ((length ^ 0xffff) != complement || mPosition + length > mByteSize) {
+            mIsValid = false;
+            return;
+        }
+        output.insert(output.end(), mData + mPosition, mData + mPosition + length);
+        mPosition += length;
+    }
+
+    void inflateFixed(std::vector<uint8_t>& output)
+    {
+        int lengthList[288 + 30];
+        std::fill(lengthList, lengthList + 144, 8);
+        std::fill(lengthList + 144, lengthList + 256, 9);
+        std::fill(lengthList + 256, lengthList + 280, 7);
+        std::fill(lengthList + 280, lengthList + 288, 8);
+        std::fill(lengthList + 288, lengthList + 288 + 30, 5);
+        inflateCodes(BuildHuffman(lengthList, 288), BuildHuffman(lengthList + 288, 30), output);
+    }
+
+    void inflateDynamic(std::vector<uint8_t>& output)
+    {
+        static const int CodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        const int literalCount = readBits(5) + 257;
+        const int distanceCount = readBits(5) + 1;
+        const int codeLengthCount = readBits(4) + 4;
+        int codeLengthList[19] = {};
+        for (int i = 0; i < codeLengthCount; ++ i) {
+            codeLengthList[CodeLengthOrder[i]] = readBits(3);
+        }
+        const Huffman codeLengthHuffman = BuildHuffman(codeLengthList, 19);
+
+        int lengthList[286 + 30] = {};
+        int index = 0;
+        while (index < literalCount + distanceCount && mIsValid) {
+            const int symbol = decodeSymbol(codeLengthHuffman);
+            if (symbol < 16) {
+                lengthList[index++] = symbol;
+                continue;
+            }
+            int repeat = 0, length = 0;
+            if (symbol == 16) {
+                if (index == 0) {
+                    mIsValid = false;
+                    return;
+                }
+                length = lengthList[index - 1];
+                repeat = 3 + readBits(2);
+            } else if (symbol == 17) {
+                repeat = 3 + readBits(3);
+            } else {
+                repeat = 11 + readBits(7);
+            }
+            if (index + repeat > literalCount + distanceCount) {
+                mIsValid = false;
+                return;
+            }
+            std::fill(lengthList + index, lengthList + index + repeat, length);
+            index += repeat;
+        }
+        inflateCodes(BuildHuffman(lengthList, literalCount), BuildHuffman(lengthList + literalCount, distanceCount), output);
+    }
+
+    void inflateCodes(const Huffman& literalHuffman, const Huffman& distanceHuffman, std::vector<uint8_t>& output)
+    {
+        static const int LengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115,
+                                           131, 163, 195, 227, 258};
+        static const int LengthExtraBits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const int DistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025,
+                                             1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static const int DistanceExtraBits[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11,
+                                                  12, 12, 13, 13};
+        while (mIsValid) {
+            const int symbol = decodeSymbol(literalHuffman);
+            if (symbol < 256) {
+                output.push_back(static_cast<uint8_t>(symbol));
+                continue;
+            }
+            if (symbol == 256) {
+                return;
+            }
+            if (symbol > 285) {
+                mIsValid = false;
+                return;
+            }
+            const int length = LengthBase[symbol - 257] + readBits(LengthExtraBits[symbol - 257]);
+            const int distanceSymbol = decodeSymbol(distanceHuffman);
+            if (distanceSymbol > 29) {
+                mIsValid = false;
+                return;
+            }
+            const size_t distance = DistanceBase[distanceSymbol] + readBits(DistanceExtraBits[distanceSymbol]);
+            if (distance > output.size()) {
+                mIsValid = false;
+                return;
+            }
+            for (int i = 0; i < length; ++ i) {
+                output.push_back(output[output.size() - distance]);
+            }
+        }
+    }
+
+private:
+    const uint8_t *mData;
+    size_t mByteSize;
+    size_t mPosition;
+    uint32_t mBitBuffer;
+    int mBitCount;
+    bool mIsValid;
+};
+
+
+uint8_t PaethPredictor(int left, int up, int upLeft)
+{
+    const int estimate = left + up - upLeft;
+    const int leftDistance = std::abs(estimate - left);
+    const int upDistance = std::abs(estimate - up);
+    const int upLeftDistance = std::abs(estimate - upLeft);
+    if (leftDistance <= upDistance && leftDistance <= upLeftDistance) {
+        return static_cast<uint8_t>(left);
+    }
+    return static_cast<uint8_t>(upDistance <= upLeftDistance ? up : upLeft);
+}
+
+
+// checks every chunk CRC and the zlib framing, pixelList receives the rows in file order
+bool DecodePNG(const std::vector<char>& file, uint32_t& width, uint32_t& height, int& channelCount, std::vector<uint8_t>& pixelList)
+{
+    static const uint8_t Signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    const auto *data = reinterpret_cast<const uint8_t*>(file.data());
+    if (file.size() < 8 || std::memcmp(data, Signature, 8) != 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> compressedData;
+    bool hasEnd = false;
+    channelCount = 0;
+    for (size_t position = 8; position < file.size() && !hasEnd;) {
+        if (position + 12 > file.size()) {
+            return false;
+        }
+        const uint32_t length = ReadUInt32BigEndian(data + position);
+        if (position + 12 + length > file.size() || ComputeCRC32(data + position + 4, length + 4) != ReadUInt32BigEndian(data + position + 8 + length)) {
+            return false;
+        }
+        const std::string type(reinterpret_cast<const char*>(data + position + 4), 4);
+        const uint8_t *body = data + position + 8;
+        if (type == "IHDR") {
+            width = ReadUInt32BigEndian(body);
+            height = ReadUInt32BigEndian(body + 4);
+            if (body[8] != 8 || (body[9] != 2 && body[9] != 6) || body[10] != 0 || body[11] != 0 || body[12] != 0) {
+                return false;
+            }
+            channelCount = body[9] == 6 ? 4 : 3;
+        } else if (type == "IDAT") {
+            compressedData.insert(compressedData.end(), body, body + length);
+        } else if (type == "IEND") {
+            hasEnd = true;
+        }
+        position += 12 + length;
+    }
+    if (!hasEnd || channelCount == 0 || compressedData.size() < 6) {
+        return false;
+    }
+    // deflate without a preset dictionary, followed by the Adler-32 of the filtered rows
+    if ((compressedData[0] & 0x0f) != 8 || (compressedData[0] << 8 | compressedData[1]) % 31 != 0 || (compressedData[1] & 0x20) != 0) {
+        return false;
+    }
+    Inflater inflater(compressedData.data() + 2, compressedData.size() - 2);
+    std::vector<uint8_t> filteredData;
+    if (!inflater.inflate(filteredData) || inflater.getPosition() + 2 + 4 != compressedData.size() ||
+        ComputeAdler32(filteredData.data(), filteredData.size()) != ReadUInt32BigEndian(compressedData.data() + compressedData.size() - 4)) {
+        return false;
+    }
+
+    const size_t rowSize = static_cast<size_t>(width) * channelCount;
+    if (filteredData.size() != (rowSize + 1) * height) {
+        return false;
+    }
+    pixelList.assign(rowSize * height, 0);
+    for (size_t row = 0; row < height; ++ row) {
+        const uint8_t filter = filteredData[row * (rowSize + 1)];
+        const uint8_t *filteredRow = filteredData.data() + row * (rowSize + 1) + 1;
+        uint8_t *pixelRow = pixelList.data() + row * rowSize;
+        const uint8_t *previousRow = row > 0 ? pixelRow - rowSize : nullptr;
+        for (size_t i = 0; i < rowSize; ++ i) {
+            const int left = i >= static_cast<size_t>(channelCount) ? pixelRow[i - channelCount] : 0;
+            const int up = previousRow ? previousRow[i] : 0;
+            const int upLeft = previousRow && i >= static_cast<size_t>(channelCount) ? previousRow[i - channelCount] : 0;
+            int predictor = 0;
+            switch (filter) {
+                case 0: predictor = 0; break;
+                case 1: predictor = left; break;
+                case 2: predictor = up; break;
+                case 3: predictor = (left + up) / 2; break;
+                case 4: predictor = PaethPredictor(left, up, upLeft); break;
+                default: return false;
+            }
+            pixelRow[i] = static_cast<uint8_t>(filteredRow[i] + predictor);
+        }
+    }
+    return true;
+}
+
+
+// rows of the image in the order the file stores them from the top of the picture
+template <typename T>
+std::vector<T> GetFileRows(const std::vector<T>& valueList, int height, bool flipVertically)
+{
+    const size_t rowSize = valueList.size() / height;
+    std::vector<T> rowList;
+    for (int row = 0; row < height; ++ row) {
+        const int imageRow = flipVertically ? height - 1 - row : row;
+        rowList.insert(rowList.end(), valueList.begin() + imageRow * rowSize, valueList.begin() + (imageRow + 1) * rowSize);
+    }
+    return rowList;
+}
+
+
+bool TestPNGRoundTrip(ImageFormat format, int width, int height, const std::vector<uint8_t>& pixelList,
+                      const ImageWriteOptions& options, ThreadPool *threadPool)
+{
+    const Image image(format, width, height, pixelList.data());
+    MemoryStream stream;
+    ImageWriter().write(image, stream, options, threadPool);
+
+    uint32_t decodedWidth = 0, decodedHeight = 0;
+    int channelCount = 0;
+    std::vector<uint8_t> decodedPixelList;
+    const bool isValid = DecodePNG(stream.getAsByteArray(), decodedWidth, decodedHeight, channelCount, decodedPixelList);
+    if (!isValid || decodedWidth != static_cast<uint32_t>(width) || decodedHeight != static_cast<uint32_t>(height) ||
+        channelCount != Image::getChannelNumberOfImageFormat(format) ||
+        decodedPixelList != GetFileRows(pixelList, height, options.flipVertically)) {
+        std::printf("PNG round trip failed: %s, level %d, stripe height %u, %s, %s\n", format._to_string(), options.compressionLevel,
+                    options.stripeHeight, options.flipVertically ? "flipped" : "not flipped", threadPool ? "threaded" : "serial");
+        return false;
+    }
+    return true;
+}
+
+
+// stb reads Radiance files, RGBE keeps 8 bits of mantissa relative to the largest component
+bool TestHDRRoundTrip(int width, int height, const std::vector<float>& valueList, const ImageWriteOptions& options, ThreadPool *threadPool)
+{
+    const Image image(ImageFormat::RGBF, width, height, reinterpret_cast<const uint8_t*>(valueList.data()));
+    MemoryStream stream;
+    ImageWriter().write(image, stream, options, threadPool);
+    const std::vector<char> file = stream.getAsByteArray();
+
+    bool isValid = true;
+    try {
+        const Image decodedImage = ImageReader().read(file.data(), file.size(), ImageFormat::RGBF);
+        const std::vector<float> expectedValueList = GetFileRows(valueList, height, options.flipVertically);
+        const auto *decodedValueList = decodedImage.getData<float>();
+        isValid = decodedImage.getWidth() == static_cast<uint32_t>(width) && decodedImage.getHeight() == static_cast<uint32_t>(height);
+        for (size_t pixel = 0; isValid && pixel < expectedValueList.size() / 3; ++ pixel) {
+            const float *expected = expectedValueList.data() + pixel * 3;
+            const float tolerance = std::max({expected[0], expected[1], expected[2]}) / 128;
+            for (int channel = 0; channel < 3; ++ channel) {
+                isValid &= std::fabs(decodedValueList[pixel * 3 + channel] - expected[channel]) <= tolerance;
+            }
+        }
+    } catch (const std::exception& exception) {
+        std::printf("%s\n", exception.what());
+        isValid = false;
+    }
+    if (!isValid) {
+        std::printf("HDR round trip failed: width %d, stripe height %u, %s, %s\n", width, options.stripeHeight,
+                    options.flipVertically ? "flipped" : "not flipped", threadPool ? "threaded" : "serial");
+    }
+    return isValid;
+}
+
+
+// stb has no PFM loader, so the file is parsed here: a text header, then little endian float rows
+// from the bottom of the picture upwards
+bool TestPFMRoundTrip(int width, int height, const std::vector<float>& valueList, const ImageWriteOptions& options, ThreadPool *threadPool)
+{
+    const Image image(ImageFormat::RGBF, width, height, reinterpret_cast<const uint8_t*>(valueList.data()));
+    MemoryStream stream;
+    ImageWriter().write(image, stream, options, threadPool);
+    const std::vector<char> file = stream.getAsByteArray();
+
+    const std::string header = "PF\n" + std::to_string(width) + " " + std::to_string(height) + "\n-1.0\n";
+    const size_t byteSize = valueList.size() * sizeof(float);
+    std::vector<float> decodedValueList(valueList.size());
+    bool isValid = file.size() == header.size() + byteSize && std::equal(header.begin(), header.end(), file.begin());
+    if (isValid) {
+        std::memcpy(decodedValueList.data(), file.data() + header.size(), byteSize);
+        isValid = decodedValueList == GetFileRows(valueList, height, !options.flipVertically);
+    }
+    if (!isValid) {
+        std::printf("PFM round trip failed: stripe height %u, %s, %s\n", options.stripeHeight,
+                    options.flipVertically ? "flipped" : "not flipped", threadPool ? "threaded" : "serial");
+    }
+    return isValid;
+}
+
+
+bool TestQOIRoundTrip(const char *caseName, ImageFormat format, int width, int height, const std::vector<uint8_t>& pixelList)
+{
+    const Image image(format, width, height, pixelList.data());
+    ImageWriteOptions options;
+    options.fileFormat = ImageFileFormat::QOI;
+    options.flipVertically = false;
+    options.stripeHeight = 3;
+    MemoryStream stream;
+    ImageWriter().write(image, stream, options);
+
+    uint32_t decodedWidth = 0, decodedHeight = 0;
+    int channelCount = 0;
+    std::vector<uint8_t> decodedPixelList;
+    const bool isValid = DecodeQOI(stream.getAsByteArray(), decodedWidth, decodedHeight, channelCount, decodedPixelList);
+    if (!isValid || decodedWidth != static_cast<uint32_t>(width) || decodedHeight != static_cast<uint32_t>(height) ||
+        channelCount != Image::getChannelNumberOfImageFormat(format) || decodedPixelList != pixelList) {
+        std::printf("QOI round trip failed: %s\n", caseName);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+
+int main()
+{
+    std::mt19937 random(7);
+    bool isPassed = true;
+    for (ImageFormat format : {ImageFormat::RGB8, ImageFormat::RGBA8}) {
+        const int channelCount = Image::getChannelNumberOfImageFormat(format);
+        const int width = 37, height = 23;
+        std::vector<uint8_t> pixelList(static_cast<size_t>(width) * height * channelCount);
+
+        for (auto& value : pixelList) {
+            value = static_cast<uint8_t>(random());
+        }
+        isPassed &= TestQOIRoundTrip("noise", format, width, height, pixelList);
+
+        // small steps, long runs and a few colors that come back through the index
+        const uint8_t paletteList[4][4] = {{0, 0, 0, 255}, {0, 0, 0, 0}, {200, 10, 90, 255}, {17, 17, 17, 128}};
+        for (size_t i = 0; i < pixelList.size() / channelCount; ++ i) {
+            const bool isPalette = (i / 5) % 3 == 0;
+            const uint8_t *paletteColor = paletteList[(i / 15) % 4];
+            for (int channel = 0; channel < channelCount; ++ channel) {
+                const auto gradient = static_cast<uint8_t>(i / 7 + channel * 40 + (random() % 3));
+                pixelList[i * channelCount + channel] = isPalette ? paletteColor[channel] : gradient;
+            }
+        }
+        isPassed &= TestQOIRoundTrip("palette", format, width, height, pixelList);
+
+        // opaque black right after a different color hits the index slot of the initial pixel
+        std::fill(pixelList.begin(), pixelList.end(), uint8_t(0));
+        for (size_t i = 0; i < pixelList.size() / channelCount; ++ i) {
+            if (i % 2 == 0) {
+                pixelList[i * channelCount] = 120;
+            }
+            if (channelCount == 4) {
+                pixelList[i * channelCount + 3] = 255;
+            }
+        }
+        isPassed &= TestQOIRoundTrip("opaque black", format, width, height, pixelList);
+    }
+
+    // long enough for the deflate window to drop rows of earlier stripes; a repeating motif gives
+    // matches at long distances and noisy blocks keep some literals
+    ThreadPool threadPool(3);
+    const int pngWidth = 211, pngHeight = 97;
+    for (ImageFormat format : {ImageFormat::RGB8, ImageFormat::RGBA8}) {
+        const int channelCount = Image::getChannelNumberOfImageFormat(format);
+        std::vector<uint8_t> pixelList(static_cast<size_t>(pngWidth) * pngHeight * channelCount);
+        for (int y = 0; y < pngHeight; ++ y) {
+            for (int x = 0; x < pngWidth; ++ x) {
+                const bool isNoise = (x / 16 + y / 8) % 3 == 0;
+                for (int channel = 0; channel < channelCount; ++ channel) {
+                    const auto motif = static_cast<uint8_t>((x % 61) * 7 + (y % 13) * 19 + channel * 50);
+                    pixelList[(static_cast<size_t>(y) * pngWidth + x) * channelCount + channel] = isNoise ? static_cast<uint8_t>(random()) : motif;
+                }
+            }
+        }
+        for (int level : {0, 1, 6, 9}) {
+            for (uint32_t stripeHeight : {1u, 7u, 1000u}) {
+                for (bool flipVertically : {false, true}) {
+                    for (ThreadPool *pool : {static_cast<ThreadPool*>(nullptr), &threadPool}) {
+                        ImageWriteOptions options;
+                        options.fileFormat = ImageFileFormat::PNG;
+                        options.compressionLevel = level;
+                        options.stripeHeight = stripeHeight;
+                        options.flipVertically = flipVertically;
+                        isPassed &= TestPNGRoundTrip(format, pngWidth, pngHeight, pixelList, options, pool);
+                    }
+                }
+            }
+        }
+    }
+
+    // run length coded scanlines, and widths below the RLE minimum that are stored flat
+    std::uniform_real_distribution<float> distribution(0.0f, 4.0f);
+    for (int hdrWidth : {53, 5}) {
+        const int hdrHeight = 19;
+        std::vector<float> valueList(static_cast<size_t>(hdrWidth) * hdrHeight * 3);
+        for (size_t i = 0; i < valueList.size(); ++ i) {
+            const size_t pixel = i / 3;
+            valueList[i] = pixel % 11 < 6 ? 1.5f : distribution(random) * (pixel % 7 == 0 ? 1000.0f : 1.0f);
+        }
+        for (uint32_t stripeHeight : {1u, 7u, 1000u}) {
+            for (bool flipVertically : {false, true}) {
+                for (ThreadPool *pool : {static_cast<ThreadPool*>(nullptr), &threadPool}) {
+                    ImageWriteOptions options;
+                    options.stripeHeight = stripeHeight;
+                    options.flipVertically = flipVertically;
+                    options.fileFormat = ImageFileFormat::HDR;
+                    isPassed &= TestHDRRoundTrip(hdrWidth, hdrHeight, valueList, options, pool);
+                    options.fileFormat = ImageFileFormat::PFM;
+                    isPassed &= TestPFMRoundTrip(hdrWidth, hdrHeight, valueList, options, pool);
+                }
+            }
+        }
+    }
+    return isPassed ? 0 : 1;
+}
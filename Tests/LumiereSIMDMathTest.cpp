@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <type_traits>
+#include "Math/LumiereSIMDMath.h"
+
+using namespace Syrinx;
+
+namespace {
+
+constexpr int SampleCount = 1 << 16;
+
+
+// distance to the long double reference in ulps of T, subnormal results count in steps of the
+// smallest subnormal
+template <typename T>
+double GetUlpError(T value, long double reference)
+{
+    if (std::isnan(static_cast<double>(reference))) {
+        return std::isnan(value) ? 0.0 : HUGE_VAL;
+    }
+    if (std::fabs(reference) > static_cast<long double>(std::numeric_limits<T>::max())) {
+        // overflowing results may round down to the largest finite value
+        const bool isOverflow = std::isinf(value) || std::fabs(value) == std::numeric_limits<T>::max();
+        return isOverflow && std::signbit(value) == std::signbit(reference) ? 0.0 : HUGE_VAL;
+    }
+    int exponent = 0;
+    std::frexp(static_cast<double>(reference), &exponent);
+    const long double ulp = std::max(std::ldexp(1.0L, exponent - std::numeric_limits<T>::digits),
+                                     static_cast<long double>(std::numeric_limits<T>::denorm_min()));
+    return static_cast<double>(std::fabs(static_cast<long double>(value) - reference) / ulp);
+}
+
+
+// samples [first, last] uniformly, or uniformly in log(x) when isLogScale is set
+template <typename T, typename Function, typename Reference>
+double SweepError(Function function, Reference reference, double first, double last, bool isLogScale)
+{
+    using Lanes = SIMDFloat<T>;
+    std::mt19937_64 random(17);
+    std::uniform_real_distribution<double> distribution(isLogScale ? std::log(first) : first, isLogScale ? std::log(last) : last);
+    alignas(LUMIERE_SIMD_ALIGNMENT) T argumentList[Lanes::Width];
+    alignas(LUMIERE_SIMD_ALIGNMENT) T resultList[Lanes::Width];
+    double maxError = 0.0;
+    for (int i = 0; i < SampleCount; i += Lanes::Width) {
+        for (int k = 0; k < Lanes::Width; ++ k) {
+            const double sample = distribution(random);
+            argumentList[k] = static_cast<T>(isLogScale ? std::exp(sample) : sample);
+        }
+        function(Lanes::Load(argumentList)).store(resultList);
+        for (int k = 0; k < Lanes::Width; ++ k) {
+            maxError = std::max(maxError, GetUlpError(resultList[k], reference(static_cast<long double>(argumentList[k]))));
+        }
+    }
+    return maxError;
+}
+
+
+bool Check(const char *typeName, const char *caseName, double error, double bound)
+{
+    if (error > bound) {
+        std::printf("%s %s: %.2f ulp exceeds %.2f ulp\n", typeName, caseName, error, bound);
+        return false;
+    }
+    return true;
+}
+
+
+template <typename T>
+bool TestAccuracy(const char *typeName)
+{
+    using Lanes = SIMDFloat<T>;
+    constexpr bool IsFloat = std::is_same_v<T, float>;
+    const double minLog = IsFloat ? -103.0 : -744.0;
+    const double maxLog = IsFloat ? 88.7 : 709.7;
+    bool isPassed = true;
+
+    isPassed &= Check(typeName, "Exp", SweepError<T>([](Lanes x) { return Exp(x); }, [](long double x) { return std::exp(x); },
+                                                     minLog, maxLog, false), 1.3);
+    isPassed &= Check(typeName, "Log", SweepError<T>([](Lanes x) { return Log(x); }, [](long double x) { return std::log(x); },
+                                                     static_cast<double>(std::numeric_limits<T>::denorm_min()),
+                                                     static_cast<double>(std::numeric_limits<T>::max()), true), 3.0);
+    isPassed &= Check(typeName, "Sin", SweepError<T>([](Lanes x) { return Sin(x); }, [](long double x) { return std::sin(x); },
+                                                     -8192.0, 8192.0, false), 2.5);
+    isPassed &= Check(typeName, "Cos", SweepError<T>([](Lanes x) { return Cos(x); }, [](long double x) { return std::cos(x); },
+                                                     -8192.0, 8192.0, false), 2.5);
+
+    // display gammas and exponents large enough to push y * log(x) to the ends of the range
+    for (double exponent : {2.2, 2.4, 1.0 / 2.2, 1.0 / 2.4, -1.7, 8.5, 30.0, -30.0}) {
+        const T y = static_cast<T>(exponent);
+        auto pow = [y](Lanes x) { return Pow(x, Lanes(y)); };
+        auto reference = [y](long double x) { return std::pow(x, static_cast<long double>(y)); };
+        const double unitError = SweepError<T>(pow, reference, static_cast<double>(std::numeric_limits<T>::denorm_min()), 1.0, true);
+        const double largeError = SweepError<T>(pow, reference, 1.0, 1e4, true);
+        isPassed &= Check(typeName, "Pow", std::max(unitError, largeError), 1.5);
+    }
+    // results just below the overflow threshold
+    const double nearOverflowError = SweepError<T>([](Lanes y) { return Pow(Lanes(T(2)), y); },
+                                                   [](long double y) { return std::pow(2.0L, y); },
+                                                   std::numeric_limits<T>::max_exponent - 1.0, std::numeric_limits<T>::max_exponent - 1e-4, false);
+    isPassed &= Check(typeName, "Pow near overflow", nearOverflowError, 1.5);
+    return isPassed;
+}
+
+} // namespace
+
+
+int main()
+{
+    bool isPassed = TestAccuracy<float>("float");
+    isPassed &= TestAccuracy<double>("double");
+    return isPassed ? 0 : 1;
+}